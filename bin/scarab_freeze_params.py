@@ -0,0 +1,214 @@
+#  Copyright 2020 HPS/SAFARI Research Groups
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy of
+#  this software and associated documentation files (the "Software"), to deal in
+#  the Software without restriction, including without limitation the rights to
+#  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+#  of the Software, and to permit persons to whom the Software is furnished to do
+#  so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in all
+#  copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#  SOFTWARE.
+
+"""
+Generates the headers of a "frozen" Scarab build (make opt-frozen PARAMS=<file>).
+
+A subset of the hot parameters is taken from a PARAMS file (or from the default
+in its .param.def file) and compiled into Scarab as constants:
+  frozen.param.h   - #defines that replace the parameter globals in the simulator
+  frozen.param.def - FROZEN_PARAM() list the parameter parser uses to reject runs
+                     that set a frozen parameter to a different value
+"""
+
+from __future__ import print_function
+import argparse
+import os
+import re
+import sys
+
+# Parameters that bound hot loops and array sizes in the pipeline and caches.
+DEFAULT_FROZEN_PARAMS = [
+    "num_cores",
+    "issue_width",
+    "node_table_size",
+    "node_ret_width",
+    "decode_width",
+    "decode_cycles",
+    "map_cycles",
+    "icache_latency",
+    "uop_cache_width",
+    "fe_ftq_block_num",
+    "icache_assoc",
+    "icache_line_size",
+    "dcache_assoc",
+    "dcache_line_size",
+    "dcache_banks",
+    "mlc_assoc",
+    "mlc_line_size",
+    "l1_assoc",
+    "l1_line_size",
+]
+
+INTEGER_TYPES = ["uns", "uns8", "uns16", "uns32", "uns64", "int", "int8", "int16", "int32", "int64", "Flag", "Counter"]
+FLOAT_TYPES = ["float", "double"]
+
+parser = argparse.ArgumentParser(description="Generate the frozen parameter headers for a PARAMS file")
+parser.add_argument('--params', required=True, help="Path to the PARAMS file to freeze.")
+parser.add_argument('--src', required=True, help="Path to the Scarab src directory.")
+parser.add_argument('--out', required=True, help="Directory to write frozen.param.h and frozen.param.def to.")
+parser.add_argument('--frozen', default=",".join(DEFAULT_FROZEN_PARAMS),
+                    help="Comma separated list of parameter (option) names to freeze.")
+
+
+def strip_comments(text):
+  out = []
+  i = 0
+  in_string = False
+  while i < len(text):
+    if in_string:
+      out.append(text[i])
+      if text[i] == '\\':
+        out.append(text[i + 1])
+        i += 1
+      elif text[i] == '"':
+        in_string = False
+    elif text.startswith("/*", i):
+      end = text.find("*/", i + 2)
+      i = len(text) if end < 0 else end + 1
+    elif text.startswith("//", i):
+      end = text.find("\n", i)
+      i = len(text) if end < 0 else end - 1
+    else:
+      out.append(text[i])
+      in_string = text[i] == '"'
+    i += 1
+  return "".join(out)
+
+
+def split_def_param_args(text, start):
+  """Splits the arguments of the DEF_PARAM( starting at text[start] on top-level commas."""
+  args = []
+  depth = 0
+  cur = ""
+  i = start
+  in_string = False
+  while i < len(text):
+    c = text[i]
+    if in_string:
+      in_string = c != '"' or text[i - 1] == '\\'
+    elif c == '"':
+      in_string = True
+    elif c == '(':
+      depth += 1
+    elif c == ')':
+      if depth == 0:
+        args.append(cur.strip())
+        return args
+      depth -= 1
+    elif c == ',' and depth == 0:
+      args.append(cur.strip())
+      cur = ""
+      i += 1
+      continue
+    cur += c
+    i += 1
+  sys.exit("Unterminated DEF_PARAM in parameter definitions")
+
+
+def read_param_defs(src_dir):
+  """Returns {option name: (variable, type, default, param.h path)} for every parameter in param_files.def."""
+  defs = {}
+  param_files = re.findall(r'#include\s+"([^"]+)"', strip_comments(open(os.path.join(src_dir, "param_files.def")).read()))
+  for def_file in param_files:
+    def_file = os.path.normpath(def_file)
+    text = strip_comments(open(os.path.join(src_dir, def_file)).read())
+    header = def_file.replace(".param.def", ".param.h")
+    for match in re.finditer(r'\bDEF_PARAM\s*\(', text):
+      args = split_def_param_args(text, match.end())
+      if len(args) != 6:
+        sys.exit("Could not parse DEF_PARAM({}) in {}".format(", ".join(args), def_file))
+      name, variable, type_name, func, default, const = args
+      defs[name] = (variable, type_name, default, header)
+  return defs
+
+
+def read_params_file(params_file):
+  """Returns {option name: value} for a PARAMS file. Later settings override earlier ones."""
+  values = {}
+  for line in open(params_file):
+    line = line.strip()
+    if not line or line.startswith("#"):
+      continue
+    if not line.startswith("--"):
+      continue
+    fields = line[2:].split(None, 1)
+    if fields[0] == "exe":
+      break
+    values[fields[0]] = fields[1].strip() if len(fields) > 1 else ""
+  return values
+
+
+def c_value(name, type_name, value, from_params_file):
+  """Converts a parameter value to a C constant expression the parser would have produced."""
+  if not from_params_file:
+    return value  # the default from the .param.def file is already a C expression
+  try:
+    if type_name in FLOAT_TYPES:
+      return repr(float(value))
+    number = int(value, 0)
+    if type_name == "Flag":
+      number = 1 if number else 0
+    return str(number)
+  except ValueError:
+    sys.exit("Value '{}' of frozen parameter '{}' is not a number".format(value, name))
+
+
+def main():
+  args = parser.parse_args()
+  defs = read_param_defs(args.src)
+  params = read_params_file(args.params)
+
+  frozen = []
+  for name in [n.strip() for n in args.frozen.split(",") if n.strip()]:
+    if name not in defs:
+      sys.exit("Unknown parameter '{}' cannot be frozen".format(name))
+    variable, type_name, default, header = defs[name]
+    if type_name not in INTEGER_TYPES + FLOAT_TYPES:
+      sys.exit("Parameter '{}' of type {} cannot be frozen, only numeric parameters can".format(name, type_name))
+    from_params_file = name in params
+    value = c_value(name, type_name, params[name] if from_params_file else default, from_params_file)
+    frozen.append((name, variable, type_name, value, header))
+
+  if not os.path.isdir(args.out):
+    os.makedirs(args.out)
+
+  banner = ("/* Generated by bin/scarab_freeze_params.py from {}. Do not edit. */\n\n"
+            .format(os.path.abspath(args.params)))
+
+  with open(os.path.join(args.out, "frozen.param.h"), "w") as f:
+    f.write(banner)
+    f.write("#ifndef __FROZEN_PARAM_H__\n#define __FROZEN_PARAM_H__\n\n")
+    f.write("/* declare the parameter globals before their names are replaced by constants */\n")
+    for header in sorted(set(p[4] for p in frozen)):
+      f.write('#include "{}"\n'.format(header))
+    f.write("\n")
+    for name, variable, type_name, value, header in frozen:
+      f.write("#define {} (({})({}))\n".format(variable, type_name, value))
+    f.write("\n#endif /* #ifndef __FROZEN_PARAM_H__ */\n")
+
+  with open(os.path.join(args.out, "frozen.param.def"), "w") as f:
+    f.write(banner)
+    for name, variable, type_name, value, header in frozen:
+      f.write("FROZEN_PARAM({}, {}, {}, ({}))\n".format(name, variable, type_name, value))
+
+
+if __name__ == "__main__":
+  main()
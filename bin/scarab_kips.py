@@ -0,0 +1,196 @@
+#  Copyright 2020 HPS/SAFARI Research Groups
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy of
+#  this software and associated documentation files (the "Software"), to deal in
+#  the Software without restriction, including without limitation the rights to
+#  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+#  of the Software, and to permit persons to whom the Software is furnished to do
+#  so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in all
+#  copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#  SOFTWARE.
+
+"""
+End-to-end throughput regression harness. Runs Scarab on a fixed set of synthetic traces
+(generated with scarab_synth_trace.py, so no proprietary traces are needed) under each
+shipped configuration and collects for every run:
+  kips        simulated kilo-instructions per second of host time, startup excluded
+  peak_rss_mb peak resident memory of the Scarab process
+  startup_s   host time of a run that simulates a single instruction
+
+The results are compared against a baseline stored by a previous --save_baseline run
+on the same machine; any metric worse than the baseline by more than --tolerance is a
+regression and makes the script exit with status 1.
+
+> python bin/scarab_kips.py --work_dir /tmp/kips --save_baseline kips_baseline.json
+> python bin/scarab_kips.py --work_dir /tmp/kips --baseline kips_baseline.json
+"""
+
+from __future__ import print_function
+import argparse
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import time
+
+scarab_root_path = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.append(scarab_root_path + '/bin')
+from scarab_globals import scarab_paths
+import scarab_synth_trace
+
+CONFIGS = ["golden_cove", "sunny_cove", "kaby_lake", "cortex_a76", "cortex_m55"]
+
+# Synthetic workloads: knobs of scarab_synth_trace.py that differ from its defaults
+WORKLOADS = {
+    "synth_mixed":   {},
+    "synth_branchy": {"branch_mix": "0.2,0.2,0.6", "mem_frac": 0.2},
+    "synth_memory":  {"branch_mix": "0.8,0.2,0.0", "mem_frac": 0.7, "footprint": 64 << 20, "random_frac": 0.5},
+    "synth_ilp":     {"mem_frac": 0.1, "footprint": 32 << 10, "dep_regs": 15},
+}
+
+parser = argparse.ArgumentParser(description="Measure Scarab throughput and compare it against a baseline")
+parser.add_argument('--scarab', default=scarab_paths.scarab_bin, help="Scarab binary to measure.")
+parser.add_argument('--work_dir', required=True, help="Directory for the generated traces and the runs.")
+parser.add_argument('--configs', default=",".join(CONFIGS), help="Comma separated configurations (src/PARAMS.<name>).")
+parser.add_argument('--workloads', default=",".join(sorted(WORKLOADS)), help="Comma separated workloads.")
+parser.add_argument('--insts', type=int, default=2000000, help="Instructions per synthetic trace.")
+parser.add_argument('--repeat', type=int, default=1, help="Runs per measurement; the best run is kept.")
+parser.add_argument('--baseline', help="Baseline JSON to compare against.")
+parser.add_argument('--save_baseline', help="Write the results as a new baseline JSON.")
+parser.add_argument('--tolerance', type=float, default=0.05, help="Allowed relative regression of every metric.")
+parser.add_argument('--startup_slack', type=float, default=0.05,
+                    help="Allowed absolute startup time regression in seconds, on top of --tolerance.")
+parser.add_argument('--scarab_args', default="", help="Additional Scarab arguments for every run.")
+
+
+def generate_traces(args, workloads):
+  """Generates the traces that are missing; the generator is deterministic, so existing ones are reused."""
+  traces = {}
+  trace_dir = os.path.join(args.work_dir, "traces")
+  os.makedirs(trace_dir, exist_ok=True)
+  for name in workloads:
+    knobs = scarab_synth_trace.parser.parse_args(["unused"])
+    knobs.insts = args.insts
+    for knob, value in WORKLOADS[name].items():
+      setattr(knobs, knob, value)
+    path = os.path.join(trace_dir, "{}.{}.trace.bz2".format(name, args.insts))
+    if not os.path.exists(path):
+      print("Generating", path)
+      scarab_synth_trace.generate(path + ".tmp", knobs)
+      os.rename(path + ".tmp", path)
+    traces[name] = path
+  return traces
+
+
+def run_scarab(args, run_dir, config, trace, extra_args):
+  """Runs Scarab once. Returns (wall time in s, peak RSS in MB, instructions simulated)."""
+  if os.path.exists(run_dir):
+    shutil.rmtree(run_dir)
+  os.makedirs(run_dir)
+  shutil.copy(os.path.join(scarab_paths.src_dir, "PARAMS." + config), os.path.join(run_dir, "PARAMS.in"))
+  cmd = [os.path.abspath(args.scarab), "--frontend", "trace", "--cbp_trace_r0", trace, "--fetch_off_path_ops", "0"]
+  cmd += args.scarab_args.split() + extra_args
+
+  with open(os.path.join(run_dir, "scarab.log"), "w") as log:
+    start = time.time()
+    proc = subprocess.Popen(cmd, cwd=run_dir, stdout=log, stderr=subprocess.STDOUT)
+    _, status, rusage = os.wait4(proc.pid, 0)
+    wall = time.time() - start
+  if not os.WIFEXITED(status) or os.WEXITSTATUS(status) != 0:
+    sys.exit("Scarab failed, see {}/scarab.log".format(run_dir))
+
+  insts = 0
+  with open(os.path.join(run_dir, "scarab.log")) as log:
+    for line in log:
+      match = re.search(r"\*\* Core \d+ Finished:\s+insts:(\d+)", line)
+      if match:
+        insts += int(match.group(1))
+  return wall, rusage.ru_maxrss / 1024.0, insts
+
+
+def measure(args, config, workload, trace):
+  run_dir = os.path.join(args.work_dir, "runs", config, workload)
+  startup = min(run_scarab(args, run_dir, config, trace, ["--inst_limit", "1"])[0] for _ in range(args.repeat))
+  best = None
+  for _ in range(args.repeat):
+    wall, rss, insts = run_scarab(args, run_dir, config, trace, [])
+    kips = insts / max(wall - startup, 1e-6) / 1000.0
+    if best is None or kips > best["kips"]:
+      best = {"kips": kips, "peak_rss_mb": rss, "startup_s": startup, "insts": insts}
+  return best
+
+
+def compare(args, results, baseline):
+  """Prints the comparison with the baseline and returns the number of regressions."""
+  regressions = 0
+  print("\n{:<32} {:>22} {:>22} {:>20}".format("run", "KIPS", "peak RSS (MB)", "startup (s)"))
+  for key in sorted(results):
+    cur = results[key]
+    base = baseline.get(key)
+    cells = []
+    for metric, higher_is_better in (("kips", True), ("peak_rss_mb", False), ("startup_s", False)):
+      if base is None or metric not in base:
+        cells.append("{:.2f}".format(cur[metric]))
+        continue
+      if higher_is_better:
+        bad = cur[metric] < base[metric] * (1 - args.tolerance)
+      else:
+        slack = args.startup_slack if metric == "startup_s" else 0
+        bad = cur[metric] > base[metric] * (1 + args.tolerance) + slack
+      regressions += bad
+      change = (cur[metric] - base[metric]) / base[metric] * 100 if base[metric] else 0
+      cells.append("{:.2f} ({:+.1f}%){}".format(cur[metric], change, " !" if bad else ""))
+    print("{:<32} {:>22} {:>22} {:>20}".format(key, *cells))
+  return regressions
+
+
+def main():
+  args = parser.parse_args()
+  configs = [c for c in args.configs.split(",") if c]
+  workloads = [w for w in args.workloads.split(",") if w]
+  for workload in workloads:
+    if workload not in WORKLOADS:
+      sys.exit("Unknown workload '{}'".format(workload))
+  if not os.path.exists(args.scarab):
+    sys.exit("Scarab binary {} not found, build it with make -C src opt".format(args.scarab))
+
+  traces = generate_traces(args, workloads)
+  results = {}
+  for config in configs:
+    for workload in workloads:
+      key = "{}/{}".format(config, workload)
+      print("Running", key)
+      results[key] = measure(args, config, workload, traces[workload])
+
+  baseline = {}
+  if args.baseline:
+    with open(args.baseline) as f:
+      baseline = json.load(f)["results"]
+  regressions = compare(args, results, baseline)
+
+  with open(os.path.join(args.work_dir, "kips_results.json"), "w") as f:
+    json.dump({"scarab": os.path.abspath(args.scarab), "results": results}, f, indent=2, sort_keys=True)
+  if args.save_baseline:
+    with open(args.save_baseline, "w") as f:
+      json.dump({"scarab": os.path.abspath(args.scarab), "insts": args.insts, "results": results}, f, indent=2,
+                sort_keys=True)
+    print("Saved baseline to", args.save_baseline)
+
+  if regressions:
+    print("\n{} metrics regressed by more than {:.0f}%".format(regressions, args.tolerance * 100))
+    sys.exit(1)
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,170 @@
+#  Copyright 2020 HPS/SAFARI Research Groups
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy of
+#  this software and associated documentation files (the "Software"), to deal in
+#  the Software without restriction, including without limitation the rights to
+#  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+#  of the Software, and to permit persons to whom the Software is furnished to do
+#  so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in all
+#  copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#  SOFTWARE.
+
+"""
+Chooses SimPoints from the basic block vectors Scarab writes in trace_bbv mode
+(--mode trace_bbv --trace_bbv_output <file> --segment_instr_count <interval>).
+
+The BBVs are normalized, randomly projected to --dim dimensions and clustered with
+k-means for every k up to --max_k. The smallest k whose Bayesian Information
+Criterion score reaches --bic_threshold of the range of scores is chosen, as in
+SimPoint 3.0. For every cluster the interval closest to its centroid is the simpoint
+and the fraction of intervals in the cluster is its weight. The output files use the
+SimPoint format and are read by the simpoint mode of Scarab:
+
+> python bin/scarab_simpoint.py bbv.txt --out_dir simpoints
+> scarab --mode simpoint --simpoint_file simpoints/simpoints --simpoint_weights_file simpoints/weights \\
+         --segment_instr_count <interval> ...
+"""
+
+from __future__ import print_function
+import argparse
+import math
+import os
+import sys
+
+import numpy as np
+
+parser = argparse.ArgumentParser(description="Cluster basic block vectors into weighted simpoints")
+parser.add_argument('bbv', help="BBV file written by Scarab in trace_bbv mode (one 'T:id:count ...' line per interval).")
+parser.add_argument('--out_dir', default=".", help="Directory to write the simpoints and weights files to.")
+parser.add_argument('--max_k', type=int, default=30, help="Largest number of clusters to try.")
+parser.add_argument('--dim', type=int, default=15, help="Number of dimensions of the random projection.")
+parser.add_argument('--bic_threshold', type=float, default=0.9,
+                    help="Pick the smallest k whose BIC score reaches this fraction of the score range.")
+parser.add_argument('--inits', type=int, default=5, help="Number of k-means initializations per k.")
+parser.add_argument('--iterations', type=int, default=100, help="Maximum number of k-means iterations.")
+parser.add_argument('--seed', type=int, default=493575226, help="Seed of the projection and of the k-means initializations.")
+
+
+def read_bbvs(path):
+  """Returns a list of {basic block id: count} dictionaries, one per interval."""
+  bbvs = []
+  for line in open(path):
+    line = line.strip()
+    if not line.startswith("T"):
+      continue
+    bbv = {}
+    for entry in line[1:].split():
+      _, bb_id, count = entry.split(":")
+      bbv[int(bb_id)] = bbv.get(int(bb_id), 0) + int(count)
+    bbvs.append(bbv)
+  return bbvs
+
+
+def project(bbvs, dim, rng):
+  """Normalizes the BBVs and projects them to dim dimensions with a random matrix in [-1, 1)."""
+  bb_ids = sorted(set(bb_id for bbv in bbvs for bb_id in bbv))
+  column = {bb_id: ii for ii, bb_id in enumerate(bb_ids)}
+  projection = rng.uniform(-1.0, 1.0, size=(len(bb_ids), dim))
+  points = np.zeros((len(bbvs), dim))
+  for ii, bbv in enumerate(bbvs):
+    total = float(sum(bbv.values()))
+    for bb_id, count in bbv.items():
+      points[ii] += (count / total) * projection[column[bb_id]]
+  return points
+
+
+def kmeans(points, k, inits, iterations, rng):
+  """Returns (labels, centroids, distortion) of the best of inits k-means runs (k-means++ seeding)."""
+  best = None
+  for _ in range(inits):
+    centroids = points[[rng.randint(len(points))]]
+    while len(centroids) < k:
+      dist = ((points[:, None, :] - centroids[None, :, :]) ** 2).sum(axis=2).min(axis=1)
+      if dist.sum() == 0:
+        break
+      centroids = np.vstack([centroids, points[rng.choice(len(points), p=dist / dist.sum())]])
+    labels = None
+    for _ in range(iterations):
+      dist = ((points[:, None, :] - centroids[None, :, :]) ** 2).sum(axis=2)
+      new_labels = dist.argmin(axis=1)
+      if labels is not None and (new_labels == labels).all():
+        break
+      labels = new_labels
+      centroids = np.array([points[labels == c].mean(axis=0) if (labels == c).any() else centroids[c]
+                            for c in range(len(centroids))])
+    distortion = ((points - centroids[labels]) ** 2).sum()
+    if best is None or distortion < best[2]:
+      best = (labels, centroids, distortion)
+  return best
+
+
+def bic(points, labels, centroids, distortion):
+  """Bayesian Information Criterion of a clustering (Pelleg and Moore, as used by SimPoint)."""
+  num_points, dim = points.shape
+  k = len(centroids)
+  if num_points <= k:
+    return float("-inf")
+  variance = max(distortion / (num_points - k), 1e-300)
+  likelihood = 0.0
+  for c in range(k):
+    size = int((labels == c).sum())
+    if size == 0:
+      continue
+    likelihood += (-size / 2.0 * math.log(2 * math.pi) - size * dim / 2.0 * math.log(variance) - (size - k) / 2.0 +
+                   size * math.log(size) - size * math.log(num_points))
+  num_params = (k - 1) + dim * k + 1
+  return likelihood - num_params / 2.0 * math.log(num_points)
+
+
+def main():
+  args = parser.parse_args()
+  bbvs = read_bbvs(args.bbv)
+  if not bbvs:
+    sys.exit("No basic block vectors in '{}'".format(args.bbv))
+  rng = np.random.RandomState(args.seed)
+  points = project(bbvs, args.dim, rng)
+
+  clusterings = []
+  for k in range(1, min(args.max_k, len(points)) + 1):
+    labels, centroids, distortion = kmeans(points, k, args.inits, args.iterations, rng)
+    clusterings.append((k, labels, centroids, bic(points, labels, centroids, distortion)))
+  scores = [c[3] for c in clusterings]
+  finite = [s for s in scores if s != float("-inf")]
+  low, high = (min(finite), max(finite)) if finite else (0.0, 0.0)
+  k, labels, centroids, score = next(c for c in clusterings if c[3] >= low + args.bic_threshold * (high - low))
+
+  # the representative of a cluster is the interval closest to its centroid
+  simpoints = []
+  for c in range(k):
+    members = np.flatnonzero(labels == c)
+    if len(members) == 0:
+      continue
+    dist = ((points[members] - centroids[c]) ** 2).sum(axis=1)
+    simpoints.append((int(members[dist.argmin()]), len(members) / float(len(points))))
+  simpoints.sort()
+
+  if not os.path.isdir(args.out_dir):
+    os.makedirs(args.out_dir)
+  with open(os.path.join(args.out_dir, "simpoints"), "w") as f:
+    for cluster, (interval, _) in enumerate(simpoints):
+      f.write("{} {}\n".format(interval, cluster))
+  with open(os.path.join(args.out_dir, "weights"), "w") as f:
+    for cluster, (_, weight) in enumerate(simpoints):
+      f.write("{:.6f} {}\n".format(weight, cluster))
+
+  print("{} intervals, {} simpoints (k={}, BIC {:.1f})".format(len(points), len(simpoints), k, score))
+  for cluster, (interval, weight) in enumerate(simpoints):
+    print("  interval {:>8}  weight {:.4f}".format(interval, weight))
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,317 @@
+#  Copyright 2020 HPS/SAFARI Research Groups
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy of
+#  this software and associated documentation files (the "Software"), to deal in
+#  the Software without restriction, including without limitation the rights to
+#  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+#  of the Software, and to permit persons to whom the Software is furnished to do
+#  so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in all
+#  copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#  SOFTWARE.
+
+
+"""
+Reads the binary stat stream written by periodic dumps with --periodic_dump_binary 1
+(see src/stat_bin.h for the layout).
+
+  scarab_stat_bin.py info stats.bin
+      prints the stream header and the rows it contains
+  scarab_stat_bin.py to-text stats.bin --out <dir> [--file-tag <tag>] [--period <N>]
+      writes the <file>.stat.<core>.out/.csv.period.<N> files a text periodic
+      dump would have written
+"""
+
+from __future__ import print_function
+import argparse
+import math
+import mmap
+import os
+import struct
+import sys
+
+STAT_BIN_MAGIC = b"SCRBSTAT"
+STAT_BIN_VERSION = 1
+STAT_BIN_STAT_COMPILED_OUT = 0x1
+
+HEADER = struct.Struct("<8sIIIIQ32x")
+STAT_DESC = struct.Struct("<IIIIII")
+ROW_HEADER = struct.Struct("<QII6Q")
+
+# Stat_Type in src/statistics.h
+(COUNT, FLOAT, DIST, PER_INST, PER_1000_INST, PER_1000_PRET_INST, PER_CYCLE, RATIO, PERCENT, LINE) = range(10)
+STATISTICS_CSV_NO_GROUP = 0
+
+parser = argparse.ArgumentParser(description="Inspect or convert a Scarab binary stat stream")
+subparsers = parser.add_subparsers(dest="command")
+info_parser = subparsers.add_parser("info", help="Print the header and the rows of the stream.")
+info_parser.add_argument("stat_bin", help="Path to the binary stat stream.")
+text_parser = subparsers.add_parser("to-text", help="Write the .out/.csv files of the periodic dumps.")
+text_parser.add_argument("stat_bin", help="Path to the binary stat stream.")
+text_parser.add_argument("--out", default=".", help="Directory to write the stat files to.")
+text_parser.add_argument("--file-tag", default="", help="file_tag of the run, prepended to the file names.")
+text_parser.add_argument("--period", type=int, default=None, help="Only convert this period.")
+
+
+class Stat(object):
+  def __init__(self, name, file_name, type, ratio_stat, flags):
+    self.name = name
+    self.file_name = file_name
+    self.type = type
+    self.ratio_stat = ratio_stat
+    self.compiled_out = bool(flags & STAT_BIN_STAT_COMPILED_OUT)
+
+
+class Row(object):
+  FIELDS = ["period_id", "proc_id", "reserved", "cycle_count", "inst_count", "pret_inst_count",
+            "pret_inst_count_0", "period_cycles", "period_insts"]
+
+  def __init__(self, stream, offset):
+    for field, value in zip(Row.FIELDS, ROW_HEADER.unpack_from(stream.data, offset)):
+      setattr(self, field, value)
+    num_stats = len(stream.stats)
+    counters = offset + ROW_HEADER.size
+    self.cur_count = struct.unpack_from("<%dQ" % num_stats, stream.data, counters)
+    self.tot_count = struct.unpack_from("<%dQ" % num_stats, stream.data, counters + 8 * num_stats)
+    self.cur_value = struct.unpack_from("<%dd" % num_stats, stream.data, counters)
+    self.tot_value = struct.unpack_from("<%dd" % num_stats, stream.data, counters + 8 * num_stats)
+
+
+class StatBin(object):
+  def __init__(self, path):
+    self.file = open(path, "rb")
+    self.data = mmap.mmap(self.file.fileno(), 0, access=mmap.ACCESS_READ)
+    magic, version, num_stats, self.num_cores, self.row_size, self.header_size = HEADER.unpack_from(self.data, 0)
+    if magic != STAT_BIN_MAGIC:
+      sys.exit("{} is not a binary stat stream".format(path))
+    if version != STAT_BIN_VERSION:
+      sys.exit("{} has version {}, expected {}".format(path, version, STAT_BIN_VERSION))
+    strings = HEADER.size + num_stats * STAT_DESC.size
+    self.stats = []
+    for ii in range(num_stats):
+      type, ratio_stat, flags, name_offset, file_name_offset, _ = STAT_DESC.unpack_from(
+          self.data, HEADER.size + ii * STAT_DESC.size)
+      self.stats.append(Stat(self.string(strings + name_offset), self.string(strings + file_name_offset), type,
+                             ratio_stat, flags))
+    self.num_rows = (len(self.data) - self.header_size) // self.row_size
+
+  def string(self, offset):
+    return self.data[offset:self.data.find(b"\0", offset)].decode()
+
+  def row(self, index):
+    return Row(self, self.header_size + index * self.row_size)
+
+
+def c_float(spec, value):
+  """Formats a double like printf, which prints NaNs from 0.0 / 0.0 as -nan."""
+  if math.isnan(value):
+    return ("%" + spec.split(".")[0].lstrip("%") + "s") % "-nan"
+  return spec % value
+
+
+def div(a, b):
+  """C division of doubles."""
+  a = float(a)
+  b = float(b)
+  if b == 0.0:
+    if a == 0.0 or math.isnan(a):
+      return float("nan")
+    return math.copysign(float("inf"), a)
+  return a / b
+
+
+def line():
+  return "#" * 50 + "#" * 50 + "\n"
+
+
+def write_file_header(out, csv, row):
+  out.write("/* -*- Mode: c -*- */\n")
+  out.write(line())
+  out.write("Core %u\n" % row.proc_id)
+  out.write(line())
+  out.write("Cumulative:        Cycles: %-20d  Instructions: %-20d  IPC: %s\n" %
+            (row.cycle_count, row.inst_count, c_float("%.5f", div(row.inst_count, row.cycle_count))))
+  out.write("\n")
+  out.write("Periodic:          Cycles: %-20d  Instructions: %-20d  IPC: %s\n" %
+            (row.period_cycles, row.period_insts, c_float("%.5f", div(row.period_insts, row.period_cycles))))
+  out.write("\n")
+
+  csv.write("Core, %d, %u\n" % (STATISTICS_CSV_NO_GROUP, row.proc_id))
+  csv.write("Cumulative_Cycles, %d, %-20d\nCumulative_Instructions, %d, %-20d\n" %
+            (STATISTICS_CSV_NO_GROUP, row.cycle_count, STATISTICS_CSV_NO_GROUP, row.inst_count))
+  csv.write("Periodic_Cycles, %d, %-20d\nPeriodic_Instructions, %d, %-20d\n" %
+            (STATISTICS_CSV_NO_GROUP, row.period_cycles, STATISTICS_CSV_NO_GROUP, row.period_insts))
+
+
+def write_ratio_stat(out, csv, s, cur, tot, cur_den, tot_den, scale, pct):
+  """PER_*, RATIO and PERCENT stats: count and count * scale / denominator."""
+  cur_ratio = div(float(cur) * scale, cur_den)
+  tot_ratio = div(float(tot) * scale, tot_den)
+  if pct:
+    out.write("%13d %s%%    %13d %s%%\n" % (cur, c_float("%12.3f", cur_ratio), tot, c_float("%12.3f", tot_ratio)))
+  else:
+    out.write("%13d %s    %13d %s\n" % (cur, c_float("%13.4f", cur_ratio), tot, c_float("%13.4f", tot_ratio)))
+  csv.write("%s_count, %d, %13d\n" % (s.name, STATISTICS_CSV_NO_GROUP, cur))
+  csv.write("%s_pct, %d, %s\n" % (s.name, STATISTICS_CSV_NO_GROUP, c_float("%12.3f", cur_ratio)))
+  csv.write("%s_total_count, %d, %13d\n" % (s.name, STATISTICS_CSV_NO_GROUP, tot))
+  csv.write("%s_total_pct, %d, %s\n" % (s.name, STATISTICS_CSV_NO_GROUP, c_float("%12.3f", tot_ratio)))
+
+
+def write_row(stream, row, out_dir, file_tag):
+  """Mirrors the text output of dump_stats() in src/statistics.c."""
+  stats = stream.stats
+  cur = row.cur_count
+  tot = row.tot_count
+  in_dist = False
+  dist_sum = total_dist_sum = dist_vtotal = total_dist_vtotal = 0
+  dist_variance = total_dist_variance = 0.0
+  stat_groupname = 0
+  last_file_name = None
+  out = csv = None
+
+  for ii, s in enumerate(stats):
+    if s.compiled_out:
+      continue
+
+    if s.file_name != last_file_name:
+      if last_file_name:
+        out.write("\n\n")
+        out.close()
+        csv.write("\n\n")
+        csv.close()
+      last_file_name = s.file_name
+      base = os.path.join(out_dir, "{}{}{}".format(file_tag, s.file_name[:-3], row.proc_id))
+      out = open("{}.out.period.{}".format(base, row.period_id), "w")
+      csv = open("{}.csv.period.{}".format(base, row.period_id), "w")
+      write_file_header(out, csv, row)
+
+    if s.type == LINE:
+      out.write("\n/*******************************************")
+      out.write("*******************************************/\n")
+
+    out.write("%-40s " % s.name)
+
+    if s.type == COUNT:
+      if not in_dist:
+        out.write("%13d %13s    %13d %13s\n" % (cur[ii], "", tot[ii], ""))
+        csv.write("%s_count, %d, %13d\n" % (s.name, STATISTICS_CSV_NO_GROUP, cur[ii]))
+        csv.write("%s_total_count, %d, %13d\n" % (s.name, STATISTICS_CSV_NO_GROUP, tot[ii]))
+      else:
+        out.write("%13d %s%%    %13d %s%%" % (cur[ii], c_float("%12.3f", div(cur[ii], dist_sum) * 100), tot[ii],
+                                               c_float("%12.3f", div(tot[ii], total_dist_sum) * 100)))
+        csv.write("%s_count, %d, %13d\n" % (s.name, stat_groupname, cur[ii]))
+        csv.write("%s_total_count, %d, %13d\n" % (s.name, stat_groupname, tot[ii]))
+
+    elif s.type == FLOAT:
+      out.write("%13f %13s    %13f %13s\n" % (row.cur_value[ii], "", row.tot_value[ii], ""))
+      csv.write("%s_value, %d, %13f\n" % (s.name, STATISTICS_CSV_NO_GROUP, row.cur_value[ii]))
+      csv.write("%s_total_value, %d, %13f\n" % (s.name, STATISTICS_CSV_NO_GROUP, row.tot_value[ii]))
+
+    elif s.type == DIST:
+      if not in_dist:
+        stat_groupname += 1
+        in_dist = True
+        dist_sum = cur[ii]
+        total_dist_sum = tot[ii]
+        dist_vtotal = 0
+        total_dist_vtotal = 0
+        jj = ii + 1
+        while True:
+          dist_sum += cur[jj]
+          total_dist_sum += tot[jj]
+          dist_vtotal += (jj - ii) * cur[jj]
+          total_dist_vtotal += (jj - ii) * tot[jj]
+          if stats[jj].type == DIST:
+            break
+          jj += 1
+        last = jj
+        dist_mean = div(dist_vtotal, dist_sum)
+        total_dist_mean = div(total_dist_vtotal, total_dist_sum)
+        dist_variance = math.pow(0.0 - dist_mean, 2) * cur[last]
+        total_dist_variance = math.pow(0.0 - total_dist_mean, 2) * tot[last]
+        for jj in range(ii + 1, last + 1):
+          dist_variance += math.pow(jj - ii - dist_mean, 2) * cur[jj]
+          total_dist_variance += math.pow(jj - ii - total_dist_mean, 2) * tot[jj]
+        # dist_sum is an uns64, dist_sum - 1 wraps around for empty distributions
+        dist_variance = div(dist_variance, (dist_sum - 1) % (1 << 64))
+        total_dist_variance = div(total_dist_variance, (total_dist_sum - 1) % (1 << 64))
+
+        out.write("%13d %s%%    %13d %s%%" % (cur[ii], c_float("%12.3f", div(cur[ii], dist_sum) * 100), tot[ii],
+                                               c_float("%12.3f", div(tot[ii], total_dist_sum) * 100)))
+        csv.write("%s_count, %d, %13d\n" % (s.name, stat_groupname, cur[ii]))
+        csv.write("%s_total_count, %d, %13d\n" % (s.name, stat_groupname, tot[ii]))
+      else:
+        in_dist = False
+        out.write("%13d %s%%    %13d %s%%\n" % (cur[ii], c_float("%12.3f", div(cur[ii], dist_sum) * 100), tot[ii],
+                                                 c_float("%12.3f", div(tot[ii], total_dist_sum) * 100)))
+        csv.write("%s_count, %d, %13d\n" % (s.name, stat_groupname, cur[ii]))
+        csv.write("%s_total_count, %d, %13d\n" % (s.name, stat_groupname, tot[ii]))
+        out.write("%-40s %13d %s%%    %13d %s%%\n" %
+                  ("", dist_sum, c_float("%12.3f", div(dist_sum, dist_sum) * 100), total_dist_sum,
+                   c_float("%12.3f", div(total_dist_sum, total_dist_sum) * 100)))
+        out.write("%-40s  %s %s      %s %s\n" %
+                  ("", c_float("%12.2f", div(dist_vtotal, dist_sum)), c_float("%12.2f", math.sqrt(dist_variance)),
+                   c_float("%12.2f", div(total_dist_vtotal, total_dist_sum)),
+                   c_float("%12.2f", math.sqrt(total_dist_variance))))
+
+    elif s.type == PER_INST:
+      write_ratio_stat(out, csv, s, cur[ii], tot[ii], row.inst_count, row.inst_count, 1.0, False)
+    elif s.type == PER_1000_INST:
+      write_ratio_stat(out, csv, s, cur[ii], tot[ii], row.inst_count, row.inst_count, 1000.0, False)
+    elif s.type == PER_1000_PRET_INST:
+      write_ratio_stat(out, csv, s, cur[ii], tot[ii], row.pret_inst_count, row.pret_inst_count_0, 1000.0, False)
+    elif s.type == PER_CYCLE:
+      write_ratio_stat(out, csv, s, cur[ii], tot[ii], row.cycle_count, row.cycle_count, 1.0, False)
+    elif s.type == RATIO:
+      write_ratio_stat(out, csv, s, cur[ii], tot[ii], cur[s.ratio_stat], tot[s.ratio_stat], 1.0, False)
+    elif s.type == PERCENT:
+      write_ratio_stat(out, csv, s, cur[ii], tot[ii], cur[s.ratio_stat], tot[s.ratio_stat], 100.0, True)
+    elif s.type == LINE:
+      out.write("\n/*******************************************")
+      out.write("*******************************************/\n")
+    else:
+      sys.exit("Invalid statistic type {} for {}".format(s.type, s.name))
+
+    out.write("\n")
+    csv.write("\n")
+
+  if last_file_name:
+    out.write("\n\n")
+    out.close()
+    csv.write("\n\n")
+    csv.close()
+
+
+def main():
+  args = parser.parse_args()
+  if not args.command:
+    parser.error("missing command")
+  stream = StatBin(args.stat_bin)
+
+  if args.command == "info":
+    print("stats: {}  cores: {}  row size: {}  rows: {}".format(len(stream.stats), stream.num_cores,
+                                                               stream.row_size, stream.num_rows))
+    for index in range(stream.num_rows):
+      row = stream.row(index)
+      print("period {:<8} core {:<3} cycles {:<16} insts {:<16}".format(row.period_id, row.proc_id,
+                                                                         row.cycle_count, row.inst_count))
+    return
+
+  if not os.path.isdir(args.out):
+    os.makedirs(args.out)
+  for index in range(stream.num_rows):
+    row = stream.row(index)
+    if args.period is None or row.period_id == args.period:
+      write_row(stream, row, args.out, args.file_tag)
+
+
+if __name__ == "__main__":
+  main()
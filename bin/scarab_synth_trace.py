@@ -0,0 +1,229 @@
+#  Copyright 2020 HPS/SAFARI Research Groups
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy of
+#  this software and associated documentation files (the "Software"), to deal in
+#  the Software without restriction, including without limitation the rights to
+#  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+#  of the Software, and to permit persons to whom the Software is furnished to do
+#  so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in all
+#  copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#  SOFTWARE.
+
+"""
+Generates synthetic Scarab traces (the ctype_pin_inst records read by --frontend trace)
+with controllable branch and memory behavior, so that throughput and regression runs do
+not depend on proprietary traces.
+
+The trace is a loop over a static program of basic blocks. Every block has a few ALU,
+load and store instructions and ends with a conditional branch, taken to a fixed target
+block or falling through to the next block:
+  --branch_mix  fraction of the branches that are biased, loop or random branches
+  --mem_frac    fraction of the non-branch instructions that access memory
+  --footprint   bytes touched by the loads and stores, --random_frac of which access it
+                at random and the rest with a stride of --stride bytes
+
+> python bin/scarab_synth_trace.py --insts 1000000 --branch_mix 0.2,0.2,0.6 synth.trace.bz2
+> scarab --frontend trace --cbp_trace_r0 synth.trace.bz2 --fetch_off_path_ops 0
+"""
+
+from __future__ import print_function
+import argparse
+import bz2
+import random
+import struct
+
+# Layout of the packed ctype_pin_inst struct in src/ctype_pin_inst.h. Keep in sync.
+CTYPE_PIN_INST_FORMAT = "<QQBQQBBBHBBBBB8s8s2s2s2sBBBBB8Q8QBBQHiQ16sB"
+CTYPE_PIN_INST_SIZE = 239
+MAX_LD_NUM = 8
+
+# Values of the enums and registers of src/table_info.h and src/isa/x86_regs.def
+OP_CF, OP_MOV, OP_IADD, OP_IMUL, OP_ICMP = 2, 3, 8, 9, 11
+CF_BR, CF_CBR = 1, 2
+REG_RAX, REG_RSP, REG_ZPS = 1, 8, 24
+GP_REGS = [r for r in range(REG_RAX, REG_RAX + 16) if r != REG_RSP]
+
+# Flag bits of the 16 single-bit fields after branch_target
+FLAG_ACTUALLY_TAKEN = 1 << 0
+FLAG_IS_MOVE = 1 << 3
+
+INST_SIZE = 4
+CODE_BASE = 0x400000
+DATA_BASE = 0x10000000
+
+parser = argparse.ArgumentParser(description="Generate a synthetic Scarab trace")
+parser.add_argument('output', help="Path of the bzip2 compressed trace to write.")
+parser.add_argument('--insts', type=int, default=1000000, help="Number of dynamic instructions.")
+parser.add_argument('--blocks', type=int, default=256, help="Number of static basic blocks.")
+parser.add_argument('--block_size', type=int, default=8, help="Instructions per block, including the branch.")
+parser.add_argument('--branch_mix', default="0.6,0.3,0.1",
+                    help="Fractions of biased, loop and random conditional branches.")
+parser.add_argument('--bias', type=float, default=0.9, help="Taken probability of the biased branches.")
+parser.add_argument('--mem_frac', type=float, default=0.4,
+                    help="Fraction of the non-branch instructions that are loads or stores.")
+parser.add_argument('--store_frac', type=float, default=0.3, help="Fraction of the memory instructions that store.")
+parser.add_argument('--footprint', type=int, default=1 << 20, help="Bytes of data touched by the trace.")
+parser.add_argument('--stride', type=int, default=64, help="Stride in bytes of the strided memory instructions.")
+parser.add_argument('--random_frac', type=float, default=0.2,
+                    help="Fraction of the memory instructions with random addresses.")
+parser.add_argument('--dep_regs', type=int, default=8,
+                    help="Number of registers the ALU instructions use (fewer means longer dependence chains).")
+parser.add_argument('--seed', type=int, default=1, help="Random seed; the same knobs and seed give the same trace.")
+
+
+class StaticInst(object):
+  def __init__(self, addr, kind):
+    self.addr = addr
+    self.kind = kind  # "alu", "ld", "st", "cbr" or "jmp"
+    self.srcs = []
+    self.dsts = []
+    self.op_type = OP_IADD
+    self.iclass = "ADD"
+    self.taken_target = 0
+    self.branch_kind = None
+    self.loop_period = 0
+    self.count = 0
+    self.mem_random = False
+    self.mem_offset = 0
+
+
+def build_program(args, rng):
+  """Returns the static blocks of the program, a list of lists of StaticInst."""
+  mix = [float(x) for x in args.branch_mix.split(",")]
+  if len(mix) != 3 or abs(sum(mix) - 1.0) > 1e-6:
+    parser.error("--branch_mix must be three fractions that add up to 1")
+  regs = GP_REGS[:max(1, min(args.dep_regs, len(GP_REGS)))]
+  block_bytes = args.block_size * INST_SIZE
+
+  blocks = []
+  for b in range(args.blocks):
+    block = []
+    for i in range(args.block_size - 1):
+      inst = StaticInst(CODE_BASE + b * block_bytes + i * INST_SIZE, "alu")
+      if rng.random() < args.mem_frac:
+        inst.kind = "st" if rng.random() < args.store_frac else "ld"
+        inst.op_type = OP_MOV
+        inst.iclass = "MOV"
+        inst.srcs = [rng.choice(regs)]  # address register
+        inst.dsts = [rng.choice(regs)] if inst.kind == "ld" else []
+        inst.mem_random = rng.random() < args.random_frac
+        inst.mem_offset = rng.randrange(0, args.footprint, 8)
+      else:
+        inst.op_type = OP_IMUL if rng.random() < 0.1 else OP_IADD
+        inst.iclass = "IMUL" if inst.op_type == OP_IMUL else "ADD"
+        inst.srcs = [rng.choice(regs), rng.choice(regs)]
+        inst.dsts = [rng.choice(regs), REG_ZPS]
+      block.append(inst)
+
+    branch = StaticInst(CODE_BASE + b * block_bytes + (args.block_size - 1) * INST_SIZE, "cbr")
+    branch.op_type = OP_CF
+    if b == args.blocks - 1:
+      # the last block closes the loop over the program
+      branch.kind = "jmp"
+      branch.iclass = "JMP"
+      branch.taken_target = 0
+    else:
+      branch.iclass = "JNZ"
+      branch.srcs = [REG_ZPS]
+      branch.taken_target = rng.randrange(args.blocks)
+      kind = rng.random()
+      branch.branch_kind = "biased" if kind < mix[0] else "loop" if kind < mix[0] + mix[1] else "random"
+      branch.loop_period = rng.randrange(2, 32)
+    block.append(branch)
+    blocks.append(block)
+  return blocks
+
+
+def pack_inst(inst, uid, next_addr, taken, target_addr, vaddr):
+  srcs = bytes(inst.srcs)
+  dsts = bytes(inst.dsts)
+  is_ld = inst.kind == "ld"
+  is_st = inst.kind == "st"
+  ld_vaddr = [vaddr if is_ld else 0] + [0] * (MAX_LD_NUM - 1)
+  st_vaddr = [vaddr if is_st else 0] + [0] * (MAX_LD_NUM - 1)
+  cf_type = CF_CBR if inst.kind == "cbr" else CF_BR if inst.kind == "jmp" else 0
+  flags = (FLAG_ACTUALLY_TAKEN if taken else 0) | (FLAG_IS_MOVE if is_ld or is_st else 0)
+  mem_addr_regs = bytes(inst.srcs[:1]) if is_ld or is_st else b""
+  return struct.pack(
+      CTYPE_PIN_INST_FORMAT,
+      uid, inst.addr, INST_SIZE, 0, inst.addr,           # inst_uid, addr, size, binary msb/lsb
+      inst.op_type, cf_type, 0, 0,                       # op_type, cf_type, is_fp, true_op_type
+      0 if (is_ld or is_st) else len(srcs), len(dsts),   # num_src_regs, num_dst_regs
+      len(mem_addr_regs) if is_ld else 0, 0,             # num_ld1_addr_regs, num_ld2_addr_regs
+      len(mem_addr_regs) if is_st else 0,                # num_st_addr_regs
+      b"" if (is_ld or is_st) else srcs, dsts,           # src_regs, dst_regs
+      mem_addr_regs if is_ld else b"", b"", mem_addr_regs if is_st else b"",
+      1, 8,                                              # num_simd_lanes, lane_width_bytes
+      1 if is_ld else 0, 1 if is_st else 0, 0,           # num_ld, num_st, has_immediate
+      *(ld_vaddr + st_vaddr),
+      8 if is_ld else 0, 8 if is_st else 0,              # ld_size, st_size
+      target_addr, flags, 0, next_addr,                  # branch_target, flags, fake_inst_reason, next addr
+      inst.iclass.encode(), 0)
+
+
+def generate(output, args):
+  rng = random.Random(args.seed)
+  blocks = build_program(args, rng)
+  block_bytes = args.block_size * INST_SIZE
+  strided_addr = {}
+
+  with bz2.BZ2File(output, "wb") as out:
+    b = 0
+    uid = 0
+    while uid < args.insts:
+      block = blocks[b]
+      for inst in block:
+        if uid == args.insts:
+          break
+        taken = False
+        target = 0
+        vaddr = 0
+        next_b = b
+        if inst.kind in ("ld", "st"):
+          if inst.mem_random:
+            vaddr = DATA_BASE + rng.randrange(0, args.footprint, 8)
+          else:
+            offset = strided_addr.get(inst.addr, inst.mem_offset)
+            strided_addr[inst.addr] = (offset + args.stride) % args.footprint
+            vaddr = DATA_BASE + offset
+        elif inst.kind == "jmp":
+          taken = True
+          next_b = inst.taken_target
+        elif inst.kind == "cbr":
+          inst.count += 1
+          if inst.branch_kind == "biased":
+            taken = rng.random() < args.bias
+          elif inst.branch_kind == "loop":
+            taken = inst.count % inst.loop_period != 0
+          else:
+            taken = rng.random() < 0.5
+          next_b = inst.taken_target if taken else b + 1
+        if inst.kind in ("cbr", "jmp"):
+          target = CODE_BASE + inst.taken_target * block_bytes
+          next_addr = CODE_BASE + next_b * block_bytes
+          b = next_b
+        else:
+          next_addr = inst.addr + INST_SIZE
+        out.write(pack_inst(inst, uid, next_addr, taken, target, vaddr))
+        uid += 1
+
+
+def main():
+  args = parser.parse_args()
+  assert struct.calcsize(CTYPE_PIN_INST_FORMAT) == CTYPE_PIN_INST_SIZE
+  if args.block_size < 2 or args.blocks < 2:
+    parser.error("--blocks and --block_size must be at least 2")
+  generate(args.output, args)
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,136 @@
+#  Copyright 2020 HPS/SAFARI Research Groups
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy of
+#  this software and associated documentation files (the "Software"), to deal in
+#  the Software without restriction, including without limitation the rights to
+#  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+#  of the Software, and to permit persons to whom the Software is furnished to do
+#  so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in all
+#  copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#  SOFTWARE.
+
+"""
+Reader for the live telemetry of a running Scarab simulation (--telemetry 1). Scarab
+publishes a snapshot of per-core progress every --telemetry_period cycles in a
+memory-mapped file (<output_dir>/<file_tag>telemetry.shm by default); this script polls
+that file without interrupting the simulation and prints the snapshots as a table or as
+JSON lines.
+
+> python bin/scarab_telemetry.py sim_dir/telemetry.shm
+> python bin/scarab_telemetry.py sim_dir/telemetry.shm --json --interval 10
+
+The layout must match Telemetry_Header and Telemetry_Core in src/telemetry.h.
+"""
+
+from __future__ import print_function
+import argparse
+import json
+import mmap
+import os
+import struct
+import sys
+import time
+
+TELEMETRY_MAGIC = 0x4d54424152414353
+TELEMETRY_VERSION = 1
+
+HEADER = struct.Struct("<QIIIIQQQQQII")
+HEADER_FIELDS = ["magic", "version", "num_cores", "header_size", "core_size", "seq", "pid", "period",
+                 "cycle_count", "host_ns", "num_snapshots", "done"]
+CORE = struct.Struct("<6Q6d4I")
+CORE_FIELDS = ["inst_count", "uop_count", "bp_mispredicts", "icache_misses", "dcache_misses", "l1_misses",
+               "ipc", "kips", "bp_mpki", "icache_mpki", "dcache_mpki", "l1_mpki",
+               "rob_occupancy", "rs_occupancy", "mem_req_buffers", "sim_done"]
+SEQ_OFFSET = 24
+
+parser = argparse.ArgumentParser(description="Poll the live telemetry of a running Scarab simulation")
+parser.add_argument('file', help="Telemetry file written by Scarab (telemetry_file in the output directory).")
+parser.add_argument('--interval', type=float, default=5.0, help="Seconds between polls.")
+parser.add_argument('--once', action='store_true', help="Print the current snapshot and exit.")
+parser.add_argument('--json', action='store_true', help="Print one JSON object per snapshot instead of a table.")
+
+
+def open_segment(path, timeout):
+  """Maps the telemetry file, waiting up to timeout seconds for Scarab to create it."""
+  deadline = time.time() + timeout
+  while True:
+    try:
+      fd = os.open(path, os.O_RDONLY)
+      size = os.fstat(fd).st_size
+      if size >= HEADER.size:
+        segment = mmap.mmap(fd, size, prot=mmap.PROT_READ)
+        os.close(fd)
+        return segment
+      os.close(fd)
+    except OSError:
+      pass
+    if time.time() > deadline:
+      sys.exit("Telemetry file '{}' did not appear".format(path))
+    time.sleep(0.1)
+
+
+def read_snapshot(segment):
+  """Returns a consistent snapshot, retrying while Scarab is writing one (sequence lock)."""
+  while True:
+    seq = struct.unpack_from("<Q", segment, SEQ_OFFSET)[0]
+    if seq % 2:
+      time.sleep(0.001)
+      continue
+    data = segment[:]
+    if struct.unpack_from("<Q", segment, SEQ_OFFSET)[0] != seq:
+      continue
+    header = dict(zip(HEADER_FIELDS, HEADER.unpack_from(data, 0)))
+    if header["magic"] != TELEMETRY_MAGIC:
+      return None  # Scarab has not initialized the file yet
+    if header["version"] != TELEMETRY_VERSION or header["core_size"] != CORE.size:
+      sys.exit("Telemetry version {} is not supported by this script".format(header["version"]))
+    header["cores"] = [dict(zip(CORE_FIELDS, CORE.unpack_from(data, header["header_size"] + ii * CORE.size)))
+                       for ii in range(header["num_cores"])]
+    return header
+
+
+def print_table(snapshot):
+  print("cycle {} | host {:.1f} s | snapshot {}{}".format(snapshot["cycle_count"], snapshot["host_ns"] / 1e9,
+                                                          snapshot["num_snapshots"],
+                                                          " | done" if snapshot["done"] else ""))
+  print("{:>4} {:>14} {:>7} {:>9} {:>8} {:>8} {:>8} {:>8} {:>5} {:>5} {:>5}".format(
+      "core", "insts", "ipc", "kips", "bp_mpki", "ic_mpki", "dc_mpki", "l1_mpki", "rob", "rs", "mem"))
+  for ii, core in enumerate(snapshot["cores"]):
+    print("{:>4} {:>14} {:>7.3f} {:>9.1f} {:>8.2f} {:>8.2f} {:>8.2f} {:>8.2f} {:>5} {:>5} {:>5}{}".format(
+        ii, core["inst_count"], core["ipc"], core["kips"], core["bp_mpki"], core["icache_mpki"],
+        core["dcache_mpki"], core["l1_mpki"], core["rob_occupancy"], core["rs_occupancy"],
+        core["mem_req_buffers"], " done" if core["sim_done"] else ""))
+  sys.stdout.flush()
+
+
+def main():
+  args = parser.parse_args()
+  segment = open_segment(args.file, max(args.interval, 10.0))
+  last_seq = None
+  while True:
+    snapshot = read_snapshot(segment)
+    if snapshot is not None and snapshot["seq"] != last_seq and snapshot["num_snapshots"]:
+      last_seq = snapshot["seq"]
+      if args.json:
+        print(json.dumps(snapshot))
+        sys.stdout.flush()
+      else:
+        print_table(snapshot)
+      if snapshot["done"]:
+        break
+    if args.once:
+      break
+    time.sleep(args.interval)
+
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,100 @@
+#  Copyright 2020 HPS/SAFARI Research Groups
+#
+#  Permission is hereby granted, free of charge, to any person obtaining a copy of
+#  this software and associated documentation files (the "Software"), to deal in
+#  the Software without restriction, including without limitation the rights to
+#  use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+#  of the Software, and to permit persons to whom the Software is furnished to do
+#  so, subject to the following conditions:
+#
+#  The above copyright notice and this permission notice shall be included in all
+#  copies or substantial portions of the Software.
+#
+#  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+#  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+#  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+#  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+#  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+#  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+#  SOFTWARE.
+
+"""
+Sanity check of --sweep_file. Runs Scarab on a small synthetic trace (generated with
+scarab_synth_trace.py) with pipeview on and a sweep of two configurations, then checks
+that every configuration wrote its own stdout and pipeview trace to its sweep<N>
+directory and that nothing was written to the shared output directory.
+
+> python bin/scarab_test_sweep.py --work_dir /tmp/sweep_test
+"""
+
+from __future__ import print_function
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+
+scarab_root_path = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+sys.path.append(scarab_root_path + '/bin')
+from scarab_globals import scarab_paths
+import scarab_synth_trace
+
+# One configuration per line, see "Sweeping parameters after a shared warmup" in docs/running-scarab.md
+SWEEP_CONFIGS = ["--l1_cycle_time 500000", "--l1_cycle_time 1000000"]
+
+parser = argparse.ArgumentParser(description="Check that sweep configurations keep their outputs apart")
+parser.add_argument('--scarab', default=scarab_paths.scarab_bin, help="Scarab binary to test.")
+parser.add_argument('--work_dir', required=True, help="Directory for the generated trace and the run.")
+parser.add_argument('--config', default="golden_cove", help="Configuration to run (src/PARAMS.<name>).")
+parser.add_argument('--insts', type=int, default=20000, help="Instructions of the synthetic trace.")
+
+
+def check(cond, message):
+  if not cond:
+    sys.exit("FAILED: " + message)
+
+
+def main():
+  args = parser.parse_args()
+  if not os.path.exists(args.scarab):
+    sys.exit("Scarab binary {} not found, build it with make -C src opt".format(args.scarab))
+
+  run_dir = os.path.join(args.work_dir, "run")
+  if os.path.exists(run_dir):
+    shutil.rmtree(run_dir)
+  os.makedirs(run_dir)
+
+  trace = os.path.join(args.work_dir, "sweep_test.trace.bz2")
+  knobs = scarab_synth_trace.parser.parse_args(["unused", "--insts", str(args.insts)])
+  scarab_synth_trace.generate(trace, knobs)
+
+  shutil.copy(os.path.join(scarab_paths.src_dir, "PARAMS." + args.config), os.path.join(run_dir, "PARAMS.in"))
+  with open(os.path.join(run_dir, "sweep.configs"), "w") as f:
+    f.write("\n".join(SWEEP_CONFIGS) + "\n")
+
+  cmd = [os.path.abspath(args.scarab), "--frontend", "trace", "--cbp_trace_r0", trace, "--fetch_off_path_ops", "0",
+         "--pipeview", "1", "--sweep_file", "sweep.configs"]
+  print("Scarab cmd:", " ".join(cmd))
+  with open(os.path.join(run_dir, "scarab.log"), "w") as log:
+    status = subprocess.call(cmd, cwd=run_dir, stdout=log, stderr=subprocess.STDOUT)
+  check(status == 0, "Scarab exited with status {}, see {}/scarab.log".format(status, run_dir))
+
+  check(not os.path.exists(os.path.join(run_dir, "pipeview.0.trace")),
+        "a pipeview trace was written outside the sweep directories")
+  traces = []
+  for config in range(len(SWEEP_CONFIGS)):
+    sweep_dir = os.path.join(run_dir, "sweep{}".format(config))
+    with open(os.path.join(sweep_dir, "sweep.out")) as f:
+      check("** Sweep configuration {}: {}".format(config, SWEEP_CONFIGS[config]) in f.read(),
+            "{}/sweep.out is not the output of configuration {}".format(sweep_dir, config))
+    trace_file = os.path.join(sweep_dir, "pipeview.0.trace")
+    check(os.path.exists(trace_file), "configuration {} wrote no pipeview trace".format(config))
+    with open(trace_file) as f:
+      traces.append(f.read())
+    check(traces[-1], "the pipeview trace of configuration {} is empty".format(config))
+  check(traces[0] != traces[1], "the configurations wrote the same pipeview trace")
+  print("PASSED")
+
+
+if __name__ == "__main__":
+  main()
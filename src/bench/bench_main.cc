@@ -0,0 +1,209 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : bench/bench_main.cc
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Driver of the simulator-throughput microbenchmarks (make bench).
+ *                Arguments that Google Benchmark does not recognize are Scarab
+ *                parameters, so "scarab_bench --benchmark_filter=BM_Cache --dcache_size 65536"
+ *                works like a normal Scarab command line. The simulator is initialized
+ *                once, the same way full_sim() does it, before any benchmark runs.
+ ***************************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "isa/isa.h"
+
+#include "cmp_model_support.h"
+#include "ctype_pin_inst.h"
+#include "model.h"
+#include "op_pool.h"
+#include "param_parser.h"
+#include "sim.h"
+#include "table_info.h"
+#include "version.h"
+
+#include "general.param.h"
+}
+
+extern char** environ;
+
+/**************************************************************************************/
+/* Defines */
+
+#define BENCH_TRACE_INSTS 200000
+#define BENCH_TRACE_BLOCKS 64
+#define BENCH_TRACE_BLOCK_SIZE 8  // instructions per block, including the branch
+#define BENCH_TRACE_INST_SIZE 4
+#define BENCH_TRACE_CODE_BASE 0x400000ULL
+#define BENCH_TRACE_DATA_BASE 0x10000000ULL
+#define BENCH_TRACE_FOOTPRINT (1 << 20)
+
+/**************************************************************************************/
+/* Default parameters: the trace written by write_bench_trace, so that every benchmark
+   runs without a PARAMS.in */
+
+static const char* default_params[] = {
+    "--frontend", "trace", "--cbp_trace_r0", SCARAB_BENCH_TRACE, "--fetch_off_path_ops", "0",
+};
+
+/**************************************************************************************/
+/* block_addr: */
+
+static uint64_t block_addr(uns block) {
+  return BENCH_TRACE_CODE_BASE + block * BENCH_TRACE_BLOCK_SIZE * BENCH_TRACE_INST_SIZE;
+}
+
+/**************************************************************************************/
+/* write_bench_trace: writes the trace the trace benchmarks read, a loop over blocks of
+   adds, strided loads and stores ending in a branch that loops back 3 times out of 4.
+   It is filled in with the ctype_pin_inst struct itself, so it always has the layout
+   the frontend reads. */
+
+static void write_bench_trace(const char* path) {
+  std::string cmdline = std::string("bzip2 -c > ") + path;
+  FILE* pipe = popen(cmdline.c_str(), "w");
+  if (!pipe) {
+    fprintf(stderr, "Could not write the benchmark trace %s\n", path);
+    exit(1);
+  }
+
+  uns block = 0;
+  uns iterations[BENCH_TRACE_BLOCKS] = {0};
+  uint64_t data_offset = 0;
+  for (uint64_t uid = 0; uid < BENCH_TRACE_INSTS;) {
+    uns cur_block = block;
+    for (uns ii = 0; ii < BENCH_TRACE_BLOCK_SIZE && uid < BENCH_TRACE_INSTS; ii++, uid++) {
+      ctype_pin_inst pi;
+      memset(&pi, 0, sizeof(pi));
+      pi.inst_uid = uid;
+      pi.instruction_addr = block_addr(cur_block) + ii * BENCH_TRACE_INST_SIZE;
+      pi.instruction_next_addr = pi.instruction_addr + BENCH_TRACE_INST_SIZE;
+      pi.inst_binary_lsb = pi.instruction_addr;
+      pi.size = BENCH_TRACE_INST_SIZE;
+      pi.num_simd_lanes = 1;
+      pi.lane_width_bytes = 8;
+      compressed_reg_t reg = REG_RAX + uid % 4;
+
+      if (ii == BENCH_TRACE_BLOCK_SIZE - 1) {
+        Flag last = cur_block == BENCH_TRACE_BLOCKS - 1;  // closes the loop over the program
+        Flag taken = last || ++iterations[cur_block] % 4 != 0;
+        block = last ? 0 : taken ? cur_block : cur_block + 1;
+        pi.op_type = OP_CF;
+        pi.cf_type = last ? CF_BR : CF_CBR;
+        if (!last) {
+          pi.num_src_regs = 1;
+          pi.src_regs[0] = REG_ZPS;
+        }
+        pi.branch_target = block_addr(last ? 0 : cur_block);
+        pi.actually_taken = taken;
+        pi.instruction_next_addr = block_addr(block);
+        strcpy(pi.pin_iclass, last ? "JMP" : "JNZ");
+      } else if (ii % 3 == 1) {
+        pi.op_type = OP_MOV;
+        pi.is_move = 1;
+        strcpy(pi.pin_iclass, "MOV");
+        uint64_t vaddr = BENCH_TRACE_DATA_BASE + data_offset;
+        data_offset = (data_offset + 64) % BENCH_TRACE_FOOTPRINT;
+        if (ii == 4) {
+          pi.num_st = 1;
+          pi.st_size = 8;
+          pi.st_vaddr[0] = vaddr;
+          pi.num_st_addr_regs = 1;
+          pi.st_addr_regs[0] = REG_RDI;
+        } else {
+          pi.num_ld = 1;
+          pi.ld_size = 8;
+          pi.ld_vaddr[0] = vaddr;
+          pi.num_ld1_addr_regs = 1;
+          pi.ld1_addr_regs[0] = REG_RSI;
+          pi.num_dst_regs = 1;
+          pi.dst_regs[0] = reg;
+        }
+      } else {
+        pi.op_type = OP_IADD;
+        strcpy(pi.pin_iclass, "ADD");
+        pi.num_src_regs = 2;
+        pi.src_regs[0] = reg;
+        pi.src_regs[1] = REG_RBX;
+        pi.num_dst_regs = 2;
+        pi.dst_regs[0] = reg;
+        pi.dst_regs[1] = REG_ZPS;
+      }
+      fwrite(&pi, sizeof(pi), 1, pipe);
+    }
+  }
+
+  if (pclose(pipe)) {
+    fprintf(stderr, "Could not write the benchmark trace %s\n", path);
+    exit(1);
+  }
+}
+
+/**************************************************************************************/
+/* main */
+
+int main(int argc, char* argv[]) {
+  benchmark::Initialize(&argc, argv);
+  write_bench_trace(SCARAB_BENCH_TRACE);
+
+  mystdout = stdout;
+  mystderr = stderr;
+  mystatus = NULL;
+
+  /* later arguments override earlier ones, so the command line wins over the defaults */
+  std::vector<char*> params;
+  params.push_back(argv[0]);
+  for (const char* param : default_params)
+    params.push_back(const_cast<char*>(param));
+  for (int ii = 1; ii < argc; ii++)
+    params.push_back(argv[ii]);
+  params.push_back(NULL);
+
+  char** simulated_argv = get_params(params.size() - 1, params.data());
+  init_global(simulated_argv, environ);
+
+  model = &model_table[SIM_MODEL];
+  model->init_func(WARMUP_MODE);
+  operating_mode = SIMULATION_MODE;
+  model->init_func(SIMULATION_MODE);
+  init_op_pool();
+  cmp_set_all_stages(0);
+
+  benchmark::AddCustomContext("scarab_gitrev", version());
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
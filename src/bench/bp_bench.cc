@@ -0,0 +1,183 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : bench/bp_bench.cc
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Microbenchmarks of bp_predict_op on a synthetic conditional branch
+ *                stream (biased, loop and random branches) for gshare, tagescl and mtage.
+ ***************************************************************************************/
+
+#include <cstring>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/utils.h"
+
+#include "bp/bp.h"
+#include "cmp_model.h"
+#include "op.h"
+
+#include "bp/bp.param.h"
+}
+
+/**************************************************************************************/
+/* Defines */
+
+#define BP_BENCH_SITES 256
+#define BP_BENCH_STREAM_LENGTH (1 << 16)
+#define BP_BENCH_BATCH 64 /* branches in flight between prediction and resolution */
+#define BP_BENCH_BASE_ADDR 0x400000
+#define BP_BENCH_INST_SIZE 2
+
+/**************************************************************************************/
+/* Branch stream: a third of the sites are biased, a third are loops and a third are
+   random, so every predictor sees a realistic mix of easy and hard branches */
+
+typedef struct Bp_Bench_Branch_struct {
+  uns site;
+  Flag dir;
+} Bp_Bench_Branch;
+
+static Table_Info bp_bench_table_info;
+static Inst_Info bp_bench_inst_info[BP_BENCH_SITES];
+
+static std::vector<Bp_Bench_Branch> make_branch_stream(void) {
+  std::vector<Bp_Bench_Branch> stream(BP_BENCH_STREAM_LENGTH);
+  uns loop_count[BP_BENCH_SITES] = {0};
+  uns64 state = 0x2545f4914f6cdd1dULL;
+
+  for (Bp_Bench_Branch& br : stream) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    br.site = state % BP_BENCH_SITES;
+    switch (br.site % 3) {
+      case 0:
+        br.dir = (state >> 32) % 10 != 0;
+        break;
+      case 1:
+        br.dir = ++loop_count[br.site] % (4 + br.site % 13) != 0;
+        break;
+      default:
+        br.dir = (state >> 40) & 1;
+        break;
+    }
+  }
+
+  bp_bench_table_info.op_type = OP_CF;
+  bp_bench_table_info.cf_type = CF_CBR;
+  for (uns ii = 0; ii < BP_BENCH_SITES; ii++) {
+    bp_bench_inst_info[ii].addr = convert_to_cmp_addr(0, BP_BENCH_BASE_ADDR + ii * 16);
+    bp_bench_inst_info[ii].trace_info.inst_size = BP_BENCH_INST_SIZE;
+    bp_bench_inst_info[ii].table_info = &bp_bench_table_info;
+  }
+  return stream;
+}
+
+/**************************************************************************************/
+/* setup_branch_op: the fields bp_predict_op and the predictors read from a branch */
+
+static void setup_branch_op(Op* op, const Bp_Bench_Branch& br, Counter op_num) {
+  Inst_Info* inst_info = &bp_bench_inst_info[br.site];
+  Addr fallthrough = ADDR_PLUS_OFFSET(inst_info->addr, BP_BENCH_INST_SIZE);
+
+  memset(op, 0, sizeof(Op));
+  op->proc_id = 0;
+  op->op_num = op_num;
+  op->unique_num = op_num;
+  op->table_info = &bp_bench_table_info;
+  op->inst_info = inst_info;
+  op->oracle_info.dir = br.dir;
+  op->oracle_info.target = inst_info->addr - 64 * (1 + br.site % 4);
+  op->oracle_info.npc = br.dir ? op->oracle_info.target : fallthrough;
+}
+
+/**************************************************************************************/
+/* get_bench_bp_data: a private Bp_Data per predictor; the predictor state itself is
+   global per core and shared with core 0 of the model */
+
+static Bp_Data* get_bench_bp_data(Bp_Id mech) {
+  static Bp_Data bp_data[NUM_BP];
+  static Flag initialized[NUM_BP];
+  uns saved_bp_mech = BP_MECH;
+
+  if (!initialized[mech]) {
+    BP_MECH = mech;
+    init_bp_data(0, &bp_data[mech]);
+    BP_MECH = saved_bp_mech;
+    initialized[mech] = TRUE;
+  }
+  return &bp_data[mech];
+}
+
+/**************************************************************************************/
+/* BM_BpPredict: times bp_predict_op for a batch of in-flight branches. Resolution,
+   recovery and retirement happen untimed, in order, like the pipeline does them. */
+
+static void BM_BpPredict(benchmark::State& state) {
+  static const std::vector<Bp_Bench_Branch> stream = make_branch_stream();
+  static Op ops[BP_BENCH_BATCH];
+  Bp_Data* bp_data = get_bench_bp_data((Bp_Id)state.range(0));
+  Counter op_num = 1;
+  Counter mispreds = 0;
+  uns pos = 0;
+
+  state.SetLabel(bp_data->bp->name);
+  set_bp_data(bp_data);
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (uns ii = 0; ii < BP_BENCH_BATCH; ii++)
+      setup_branch_op(&ops[ii], stream[pos++ % BP_BENCH_STREAM_LENGTH], op_num++);
+    state.ResumeTiming();
+
+    for (uns ii = 0; ii < BP_BENCH_BATCH; ii++)
+      benchmark::DoNotOptimize(bp_predict_op(bp_data, &ops[ii], 0, ops[ii].inst_info->addr));
+
+    state.PauseTiming();
+    for (uns ii = 0; ii < BP_BENCH_BATCH; ii++) {
+      Op* op = &ops[ii];
+      bp_target_known_op(bp_data, op);
+      bp_resolve_op(bp_data, op);
+      if (op->oracle_info.mispred || op->oracle_info.misfetch) {
+        /* the younger branches of the batch are flushed */
+        bp_recover_op(bp_data, CF_CBR, &op->recovery_info);
+        bp_retire_op(bp_data, op);
+        mispreds++;
+        break;
+      }
+      bp_retire_op(bp_data, op);
+    }
+    state.ResumeTiming();
+  }
+  set_bp_data(&cmp_model.bp_data[0]);
+  state.counters["mispred_batches"] = benchmark::Counter(mispreds, benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations() * BP_BENCH_BATCH);
+}
+
+/**************************************************************************************/
+
+BENCHMARK(BM_BpPredict)->Arg(GSHARE_BP)->Arg(TAGESCL_BP)->Arg(MTAGE_BP);
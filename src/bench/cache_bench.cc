@@ -0,0 +1,126 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : bench/cache_bench.cc
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Microbenchmarks of cache_access and cache_insert across
+ *                associativities and replacement policies.
+ ***************************************************************************************/
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+
+#include "libs/cache_lib.h"
+}
+
+/**************************************************************************************/
+/* Defines */
+
+#define CACHE_BENCH_SIZE (32 * 1024)
+#define CACHE_BENCH_LINE_SIZE 64
+#define CACHE_BENCH_STREAM_LENGTH (1 << 16)
+
+/**************************************************************************************/
+/* make_addr_stream: random line addresses over a working set twice the cache size, so
+   that roughly half of the accesses miss */
+
+static std::vector<Addr> make_addr_stream(void) {
+  std::vector<Addr> stream(CACHE_BENCH_STREAM_LENGTH);
+  uns64 state = 0x9e3779b97f4a7c15ULL;
+  for (Addr& addr : stream) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    addr = (state % (2 * CACHE_BENCH_SIZE / CACHE_BENCH_LINE_SIZE)) * CACHE_BENCH_LINE_SIZE;
+  }
+  return stream;
+}
+
+/* init_bench_cache: the cache library has no destructor, so every run leaks its (small) cache */
+
+static void init_bench_cache(Cache* cache, benchmark::State& state) {
+  Repl_Policy repl = (Repl_Policy)state.range(1);
+  init_cache(cache, "BENCH_CACHE", CACHE_BENCH_SIZE, state.range(0), CACHE_BENCH_LINE_SIZE, sizeof(uns64), repl);
+  state.SetLabel(repl == REPL_TRUE_LRU ? "true_lru" :
+                 repl == REPL_NOT_MRU  ? "not_mru" :
+                 repl == REPL_RANDOM   ? "random" :
+                 repl == REPL_SRRIP    ? "srrip" :
+                                         "other");
+}
+
+/**************************************************************************************/
+/* BM_CacheAccess: lookups that update the replacement state; misses are filled so the
+   hit rate stays steady */
+
+static void BM_CacheAccess(benchmark::State& state) {
+  static Cache cache;
+  static const std::vector<Addr> stream = make_addr_stream();
+  Addr line_addr, repl_line_addr;
+  uns ii = 0;
+
+  init_bench_cache(&cache, state);
+  for (auto _ : state) {
+    Addr addr = stream[ii++ % CACHE_BENCH_STREAM_LENGTH];
+    void* data = cache_access(&cache, addr, &line_addr, TRUE);
+    if (!data) {
+      state.PauseTiming();
+      cache_insert(&cache, 0, addr, &line_addr, &repl_line_addr);
+      state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(data);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**************************************************************************************/
+/* BM_CacheInsert: victim selection and fill */
+
+static void BM_CacheInsert(benchmark::State& state) {
+  static Cache cache;
+  static const std::vector<Addr> stream = make_addr_stream();
+  Addr line_addr, repl_line_addr;
+  uns ii = 0;
+
+  init_bench_cache(&cache, state);
+  for (auto _ : state) {
+    void* data = cache_insert(&cache, 0, stream[ii++ % CACHE_BENCH_STREAM_LENGTH], &line_addr, &repl_line_addr);
+    benchmark::DoNotOptimize(data);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**************************************************************************************/
+
+static void cache_bench_args(benchmark::internal::Benchmark* bench) {
+  for (Repl_Policy repl : {REPL_TRUE_LRU, REPL_NOT_MRU, REPL_RANDOM, REPL_SRRIP})
+    for (int assoc : {1, 4, 8, 16})
+      bench->Args({assoc, repl});
+}
+
+BENCHMARK(BM_CacheAccess)->Apply(cache_bench_args);
+BENCHMARK(BM_CacheInsert)->Apply(cache_bench_args);
@@ -0,0 +1,125 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : bench/frontend_bench.cc
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Microbenchmarks of the trace frontend: reading (decompressing) the
+ *                trace and decoding its instructions into uops.
+ ***************************************************************************************/
+
+#include <cstring>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+
+#include "ctype_pin_inst.h"
+#include "frontend/pin_trace_read.h"
+#include "op.h"
+#include "pin/pin_lib/uop_generator.h"
+
+#include "core.param.h"
+}
+
+/**************************************************************************************/
+/* Defines */
+
+#define FRONTEND_BENCH_MAX_INSTS (1 << 16)
+
+/**************************************************************************************/
+/* reopen_trace: restarts the trace of core 0 (CBP_TRACE_R0, the trace written by
+   bench_main unless --cbp_trace_r0 is given) */
+
+static void reopen_trace(void) {
+  pin_trace_close(0);
+  pin_trace_open(0, CBP_TRACE_R0);
+}
+
+/**************************************************************************************/
+/* read_trace_insts: the first FRONTEND_BENCH_MAX_INSTS instructions of the trace, so
+   that decoding is timed without the decompression */
+
+static std::vector<ctype_pin_inst> read_trace_insts(void) {
+  std::vector<ctype_pin_inst> insts;
+  ctype_pin_inst pi;
+
+  reopen_trace();
+  while (insts.size() < FRONTEND_BENCH_MAX_INSTS && pin_trace_read(0, &pi))
+    insts.push_back(pi);
+  reopen_trace();
+  return insts;
+}
+
+/**************************************************************************************/
+/* BM_TraceRead: one instruction read from the bzip2 pipe */
+
+static void BM_TraceRead(benchmark::State& state) {
+  ctype_pin_inst pi;
+
+  reopen_trace();
+  for (auto _ : state) {
+    if (!pin_trace_read(0, &pi)) {
+      state.PauseTiming();
+      reopen_trace();
+      state.ResumeTiming();
+    }
+    benchmark::DoNotOptimize(pi);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * sizeof(ctype_pin_inst));
+}
+
+/**************************************************************************************/
+/* BM_UopGeneratorGetUop: one instruction decoded into all of its uops */
+
+static void BM_UopGeneratorGetUop(benchmark::State& state) {
+  static std::vector<ctype_pin_inst> insts = read_trace_insts();
+  Op op;
+  uns ii = 0;
+  uns64 uops = 0;
+
+  if (insts.empty()) {
+    state.SkipWithError("the trace has no instructions");
+    return;
+  }
+  memset(&op, 0, sizeof(op));
+  for (auto _ : state) {
+    uop_generator_get_uop(0, &op, &insts[ii++ % insts.size()]);
+    uops++;
+    while (!uop_generator_get_eom(0)) {
+      uop_generator_get_uop(0, &op, NULL);
+      uops++;
+    }
+    benchmark::DoNotOptimize(op);
+  }
+  state.counters["uops_per_inst"] = benchmark::Counter(uops, benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**************************************************************************************/
+
+BENCHMARK(BM_TraceRead);
+BENCHMARK(BM_UopGeneratorGetUop);
@@ -0,0 +1,102 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : bench/memory_bench.cc
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Microbenchmarks of new_mem_req against busy request queues.
+ ***************************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "memory/memory.h"
+
+#include "memory/memory.param.h"
+}
+
+/**************************************************************************************/
+/* Defines */
+
+#define MEM_BENCH_BASE_ADDR 0x10000000
+
+/**************************************************************************************/
+/* fill_req_buffer: fills the request buffer of core 0 with demand misses to distinct
+   lines. No cycles are simulated, so the requests stay in flight for the rest of the run.
+   Returns the number of requests in flight. */
+
+static uns fill_req_buffer(void) {
+  static uns num_reqs = 0;
+  static Flag filled = FALSE;
+
+  if (!filled) {
+    while (new_mem_req(MRT_DFETCH, 0, convert_to_cmp_addr(0, MEM_BENCH_BASE_ADDR + num_reqs * DCACHE_LINE_SIZE),
+                       DCACHE_LINE_SIZE, 1, NULL, NULL, unique_count++, NULL))
+      num_reqs++;
+    filled = TRUE;
+  }
+  return num_reqs;
+}
+
+/**************************************************************************************/
+/* BM_NewMemReqMatch: a demand miss that merges with a request already in flight, which
+   is the common case of new_mem_req (a search of the busy queues) */
+
+static void BM_NewMemReqMatch(benchmark::State& state) {
+  uns num_reqs = fill_req_buffer();
+  uns ii = 0;
+
+  for (auto _ : state) {
+    Addr addr = convert_to_cmp_addr(0, MEM_BENCH_BASE_ADDR + (ii++ % num_reqs) * DCACHE_LINE_SIZE);
+    Flag accepted = new_mem_req(MRT_DFETCH, 0, addr, DCACHE_LINE_SIZE, 1, NULL, NULL, unique_count, NULL);
+    benchmark::DoNotOptimize(accepted);
+  }
+  state.counters["reqs_in_flight"] = num_reqs;
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**************************************************************************************/
+/* BM_NewMemReqFull: a demand miss to a new line that is rejected because the request
+   buffer is full */
+
+static void BM_NewMemReqFull(benchmark::State& state) {
+  uns num_reqs = fill_req_buffer();
+  uns ii = 0;
+
+  for (auto _ : state) {
+    Addr addr = convert_to_cmp_addr(0, MEM_BENCH_BASE_ADDR + (num_reqs + (ii++ & 0xffff)) * DCACHE_LINE_SIZE);
+    Flag accepted = new_mem_req(MRT_DFETCH, 0, addr, DCACHE_LINE_SIZE, 1, NULL, NULL, unique_count, NULL);
+    benchmark::DoNotOptimize(accepted);
+  }
+  state.counters["reqs_in_flight"] = num_reqs;
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**************************************************************************************/
+
+BENCHMARK(BM_NewMemReqMatch);
+BENCHMARK(BM_NewMemReqFull);
@@ -0,0 +1,136 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : bench/node_bench.cc
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Microbenchmarks of the out-of-order window: wake_up_ops broadcasting
+ *                to dependents and node_sched_ops selecting from a full ready list.
+ ***************************************************************************************/
+
+#include <cstring>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+
+#include "map.h"
+#include "node_stage.h"
+#include "op.h"
+
+#include "core.param.h"
+}
+
+/**************************************************************************************/
+/* Defines */
+
+#define NODE_BENCH_MAX_DEPS 64
+
+/**************************************************************************************/
+/* make_op: an op that looks like it is in the window of core 0 */
+
+static const Op_Type node_bench_op_types[] = {OP_IADD, OP_IMUL, OP_FADD, OP_MOV};
+static Table_Info node_bench_table_info[sizeof(node_bench_op_types) / sizeof(Op_Type)];
+
+static void make_op(Op* op, Counter op_num) {
+  uns type = op_num % (sizeof(node_bench_op_types) / sizeof(Op_Type));
+
+  node_bench_table_info[type].op_type = node_bench_op_types[type];
+  memset(op, 0, sizeof(Op));
+  op->proc_id = 0;
+  op->op_num = op_num;
+  op->unique_num = op_num;
+  op->op_pool_valid = TRUE;
+  op->table_info = &node_bench_table_info[type];
+}
+
+/**************************************************************************************/
+/* BM_WakeUpOps: a producer waking up state.range(0) dependents */
+
+static void BM_WakeUpOps(benchmark::State& state) {
+  static Op producer;
+  static Op deps[NODE_BENCH_MAX_DEPS];
+  static Wake_Up_Entry wake[NODE_BENCH_MAX_DEPS];
+  uns num_deps = state.range(0);
+
+  make_op(&producer, 1);
+  producer.wake_cycle = cycle_count + 1;
+  for (uns ii = 0; ii < num_deps; ii++) {
+    make_op(&deps[ii], 2 + ii);
+    wake[ii].op = &deps[ii];
+    wake[ii].unique_num = deps[ii].unique_num;
+    wake[ii].dep_type = REG_DATA_DEP;
+    wake[ii].rdy_bit = ii % MAX_SRCS;
+    wake[ii].next = ii + 1 < num_deps ? &wake[ii + 1] : NULL;
+  }
+  producer.wake_up_head = &wake[0];
+  producer.wake_up_tail = &wake[num_deps - 1];
+  producer.wake_up_count = num_deps;
+
+  for (auto _ : state) {
+    for (uns ii = 0; ii < num_deps; ii++)
+      set_not_rdy_bit(&deps[ii], wake[ii].rdy_bit);
+    producer.wake_up_signaled[REG_DATA_DEP] = FALSE;
+    wake_up_ops(&producer, REG_DATA_DEP, simple_wake);
+  }
+  state.SetItemsProcessed(state.iterations() * num_deps);
+}
+
+/**************************************************************************************/
+/* BM_NodeSchedOps: one scheduling pass over a ready list of state.range(0) ops */
+
+static void BM_NodeSchedOps(benchmark::State& state) {
+  std::vector<Op> ops(state.range(0));
+  Op* saved_rdy_head = node->rdy_head;
+
+  ASSERT(0, node->sd.op_count == 0);
+  for (uns ii = 0; ii < ops.size(); ii++) {
+    Op* op = &ops[ii];
+    make_op(op, 1 + ii);
+    op->in_rdy_list = TRUE;
+    op->state = OS_READY;
+    op->rdy_cycle = cycle_count + 1;
+    op->rs_id = ii % NUM_RS;
+    op->next_rdy = ii + 1 < ops.size() ? &ops[ii + 1] : NULL;
+  }
+  node->rdy_head = &ops[0];
+
+  for (auto _ : state) {
+    node_sched_ops();
+    benchmark::DoNotOptimize(node->sd.op_count);
+    /* the next stage would consume the scheduled ops */
+    memset(node->sd.ops, 0, sizeof(Op*) * node->sd.max_op_count);
+    node->sd.op_count = 0;
+  }
+  node->rdy_head = saved_rdy_head;
+  state.SetItemsProcessed(state.iterations() * ops.size());
+}
+
+/**************************************************************************************/
+
+BENCHMARK(BM_WakeUpOps)->Arg(1)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK(BM_NodeSchedOps)->Arg(32)->Arg(128)->Arg(512);
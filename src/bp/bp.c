@@ -94,6 +94,8 @@ Hash_Table per_branch_stat;
 /******************************************************************************/
 // Local prototypes
 
+static int bstat_compare(const void*, const void*);
+
 /******************************************************************************/
 /* set_bp_data set the global bp_data pointer (so I don't have to pass it around
  * everywhere */
@@ -121,9 +123,6 @@ void init_bp_recovery_info(uns8 proc_id, Bp_Recovery_Info* new_bp_recovery_info)
   new_bp_recovery_info->redirect_cycle = MAX_CTR;
 
   bp_recovery_info = new_bp_recovery_info;
-
-  init_hash_table(&per_branch_stat, "Per Branch Hit/Miss and Recovery/Redirect Stall cycles", 15000000,
-                  sizeof(Per_Branch_Stat));
 }
 
 /******************************************************************************/
@@ -181,7 +180,18 @@ void bp_sched_recovery(Bp_Recovery_Info* bp_recovery_info, Op* op, Counter cycle
   }
 }
 
+/******************************************************************************/
+/* inc_bstat_fetched: record a fetched branch in the per-branch stat table. The
+   table is shared by all cores and allocated at the first branch, small, growing
+   with the number of static branches. */
+
 void inc_bstat_fetched(Op* op) {
+  if (!PER_BRANCH_STAT)
+    return;
+  if (!per_branch_stat.entries)
+    init_hash_table(&per_branch_stat, "Per Branch Hit/Miss and Recovery/Redirect Stall cycles", 1024,
+                    sizeof(Per_Branch_Stat));
+
   Flag new_entry;
   int64 key = convert_to_cmp_addr(op->table_info->cf_type, op->inst_info->addr);
   Per_Branch_Stat* bstat = (Per_Branch_Stat*)hash_table_access_create(&per_branch_stat, key, &new_entry);
@@ -191,15 +201,22 @@ void inc_bstat_fetched(Op* op) {
     bstat->cf_type = op->table_info->cf_type;
   }
 
+  if (!op->off_path)
+    bstat->fetched++;
+
   // target if taken
   if (op->oracle_info.pred == TAKEN && !(op->oracle_info.recover_at_exec || op->oracle_info.recover_at_decode))
     bstat->target = op->oracle_info.npc;
 }
 
 void inc_bstat_miss(Op* op) {
-  int64 key = convert_to_cmp_addr(op->table_info->cf_type, op->inst_info->addr);
-  Per_Branch_Stat* bstat = (Per_Branch_Stat*)hash_table_access(&per_branch_stat, key);
-  ASSERT(bp_recovery_info->proc_id, bstat);
+  Per_Branch_Stat* bstat = NULL;
+  if (PER_BRANCH_STAT) {
+    int64 key = convert_to_cmp_addr(op->table_info->cf_type, op->inst_info->addr);
+    ASSERT(bp_recovery_info->proc_id, per_branch_stat.entries);
+    bstat = (Per_Branch_Stat*)hash_table_access(&per_branch_stat, key);
+    ASSERT(bp_recovery_info->proc_id, bstat);
+  }
 
   const uns8 mispred = (op->table_info->cf_type == CF_CBR) && !op->oracle_info.btb_miss;
   const uns8 misfetch = op->oracle_info.misfetch;
@@ -216,10 +233,53 @@ void inc_bstat_miss(Op* op) {
     return;
   }
 
+  if (bstat) {
+    bstat->mispred += mispred;
+    bstat->misfetch += misfetch;
+    bstat->btb_miss += btb_miss;
+  }
+
   if (op->fetched_from_uop_cache && op->oracle_info.recover_at_decode)
     STAT_EVENT(bp_recovery_info->proc_id, RECOVER_AT_DECODE_BR_FROM_UOC);
 }
 
+/******************************************************************************/
+/* bp_done: write the per-branch stat table, the branches that recover most
+   first */
+
+void bp_done(void) {
+  if (!PER_BRANCH_STAT || !per_branch_stat.count)
+    return;
+
+  FILE* file = file_tag_fopen(OUTPUT_DIR, "per_branch_stat", "w");
+  ASSERTM(0, file, "Could not open the per-branch stat file\n");
+  Per_Branch_Stat** bstats = (Per_Branch_Stat**)hash_table_flatten(&per_branch_stat, NULL);
+  qsort(bstats, per_branch_stat.count, sizeof(Per_Branch_Stat*), bstat_compare);
+
+  fprintf(file, "%-18s %-8s %-18s %12s %10s %10s %10s\n", "addr", "type", "target", "fetched", "mispred",
+          "misfetch", "btb_miss");
+  for (int ii = 0; ii < per_branch_stat.count; ii++) {
+    Per_Branch_Stat* bstat = bstats[ii];
+    fprintf(file, "0x%-16s %-8s 0x%-16s %12s %10s %10s %10s\n", hexstr64s(bstat->addr),
+            cf_type_names[bstat->cf_type], hexstr64s(bstat->target), unsstr64(bstat->fetched),
+            unsstr64(bstat->mispred), unsstr64(bstat->misfetch), unsstr64(bstat->btb_miss));
+  }
+  free(bstats);
+  fclose(file);
+}
+
+static int bstat_compare(const void* a, const void* b) {
+  const Per_Branch_Stat* x = *(Per_Branch_Stat* const*)a;
+  const Per_Branch_Stat* y = *(Per_Branch_Stat* const*)b;
+  Counter x_misses = x->mispred + x->misfetch + x->btb_miss;
+  Counter y_misses = y->mispred + y->misfetch + y->btb_miss;
+  if (x_misses != y_misses)
+    return x_misses > y_misses ? -1 : 1;
+  if (x->fetched != y->fetched)
+    return x->fetched > y->fetched ? -1 : 1;
+  return x->addr < y->addr ? -1 : x->addr > y->addr;
+}
+
 /******************************************************************************/
 /* bp_sched_redirect: called on an op that caused the fetch stage to suspend
    (eg. a btb miss).  The pred_npc is what is used for the new pc. */
@@ -122,6 +122,7 @@ struct Bp_struct;
 struct Bp_Btb_struct;
 struct Bp_Ibtb_struct;  // added _struct, compiler randomly started complaining
 struct Br_Conf_struct;
+struct Warm_State_struct;
 
 typedef struct Perceptron_struct {
   int32* weights;
@@ -212,6 +213,8 @@ typedef struct Bp_struct {
                                          * updated after retirement*/
   void (*recover_func)(Recovery_Info*); /* called to recover the bp when a misprediction is realized */
   uns8 (*full_func)(uns);
+  void (*checkpoint_func)(uns, struct Warm_State_struct*); /* called to save or restore the tables of a core in a
+                                                            * warm-state checkpoint (NULL if not supported) */
 } Bp;
 
 typedef struct Bp_Btb_struct {
@@ -275,6 +278,7 @@ void bp_recover_op(Bp_Data*, Cf_Type, Recovery_Info*);
 
 void inc_bstat_fetched(Op* op);
 void inc_bstat_miss(Op* op);
+void bp_done(void);
 
 /**************************************************************************************/
 
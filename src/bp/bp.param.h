@@ -40,6 +40,11 @@
 
 extern Flag USE_LATE_BP;
 
+/* In a frozen build (make opt-frozen) hot parameters are compile-time constants */
+#if defined(SCARAB_FROZEN_PARAMS) && !defined(SCARAB_PARAM_DEFINITIONS)
+#include "frozen.param.h"
+#endif
+
 /**************************************************************************************/
 
 #endif /* #ifndef __BP.PARAM_H__ */
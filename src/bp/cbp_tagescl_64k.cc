@@ -931,12 +931,12 @@ void TAGE64K::GlobalStateUpdate(UINT64 PC, UINT64 br_target, int brtype, bool pr
     Sstate.ptghist--;  // pointer of global history
     Sstate.ghist[Sstate.ptghist & (HISTBUFFERLENGTH - 1)] = DIR;
     Sstate.phist = (Sstate.phist << 1) ^ PATHBIT;
-
-    for (int i = 1; i <= NHIST; i++) {
-      Sstate.ch_i[i].update(Sstate.ghist, Sstate.ptghist);
-      Sstate.ch_t[0][i].update(Sstate.ghist, Sstate.ptghist);
-      Sstate.ch_t[1][i].update(Sstate.ghist, Sstate.ptghist);
-    }
+  }
+  // fold all the bits of the branch in at once
+  for (int i = 1; i <= NHIST; i++) {
+    Sstate.ch_i[i].update(Sstate.ghist, Sstate.ptghist, maxt);
+    Sstate.ch_t[0][i].update(Sstate.ghist, Sstate.ptghist, maxt);
+    Sstate.ch_t[1][i].update(Sstate.ghist, Sstate.ptghist, maxt);
   }
   Sstate.phist = (Sstate.phist & ((1 << PHISTWIDTH) - 1));  // path history
 }
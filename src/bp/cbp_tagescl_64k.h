@@ -60,11 +60,22 @@ class cbp64_folded_history {
     OUTPOINT = OLENGTH % CLENGTH;
   }
 
-  void update(uint8_t* h, int PT) {
-    comp = (comp << 1) ^ h[PT & (HISTBUFFERLENGTH - 1)];
-    comp ^= h[(PT + OLENGTH) & (HISTBUFFERLENGTH - 1)] << OUTPOINT;
-    comp ^= (comp >> CLENGTH);
-    comp = (comp) & ((1 << CLENGTH) - 1);
+  // Folds in the num_bits most recent bits of h (newest at PT) at once. Folding
+  // in one bit rotates comp left by one and xors in the new bit and the bit
+  // leaving the original history (at OUTPOINT), so num_bits of them rotate comp
+  // by num_bits and xor in both groups of bits as words.
+  void update(uint8_t* h, int PT, int num_bits) {
+    unsigned in = 0;
+    unsigned out = 0;
+    for (int i = num_bits - 1; i >= 0; i--) {
+      in = (in << 1) | h[(PT + i) & (HISTBUFFERLENGTH - 1)];
+      out = (out << 1) | h[(PT + OLENGTH + i) & (HISTBUFFERLENGTH - 1)];
+    }
+    comp = rotate_left(comp, num_bits) ^ in ^ rotate_left(out, OUTPOINT);
+  }
+
+  unsigned rotate_left(unsigned x, int m) const {
+    return ((x << m) | (x >> (CLENGTH - m))) & ((1 << CLENGTH) - 1);
   }
 
   bool operator==(const cbp64_folded_history& other) const {
@@ -30,6 +30,7 @@ extern "C" {
 #include "core.param.h"
 
 #include "statistics.h"
+#include "warm_state.h"
 }
 
 #define PHT_INIT_VALUE (0x1 << (PHT_CTR_BITS - 1)) /* weakly taken */
@@ -117,3 +118,9 @@ void bp_gshare_update(Op* op) {
   DEBUG(proc_id, "Updating addr:%s  pht:%u  ent:%u  dir:%d\n", hexstr64s(addr), pht_index, gshare_state.pht[pht_index],
         op->oracle_info.dir);
 }
+
+void bp_gshare_checkpoint(uns proc_id, Warm_State* ws) {
+  auto& gshare_state = gshare_state_all_cores.at(proc_id);
+  warm_state_shape(ws, "the gshare pht size", gshare_state.pht.size());
+  warm_state_bytes(ws, gshare_state.pht.data(), gshare_state.pht.size() * sizeof(uns8));
+}
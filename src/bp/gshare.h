@@ -37,6 +37,7 @@ void bp_gshare_update(Op*);
 void bp_gshare_retire(Op*);
 void bp_gshare_recover(Recovery_Info*);
 uns8 bp_gshare_full(uns);
+void bp_gshare_checkpoint(uns proc_id, struct Warm_State_struct* ws);
 
 #ifdef __cplusplus
 }
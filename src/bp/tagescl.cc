@@ -31,6 +31,7 @@ extern "C" {
 #include "core.param.h"
 
 #include "table_info.h"
+#include "warm_state.h"
 }
 
 #include "bp/template_lib/tagescl.h"
@@ -68,6 +69,19 @@ Branch_Type get_branch_type(uns proc_id, Cf_Type cf_type) {
   }
   return br_type;
 }
+
+// Transfers the predictor tables to or from a warm-state checkpoint.
+class Warm_State_Archive : public State_Archive {
+ public:
+  explicit Warm_State_Archive(Warm_State* ws) : ws_(ws) {}
+
+  void transfer_bytes(void* data, size_t size) override {
+    warm_state_bytes(ws_, data, size);
+  }
+
+ private:
+  Warm_State* ws_;
+};
 }  // end of anonymous namespace
 
 void bp_tagescl_init() {
@@ -124,3 +138,10 @@ void bp_tagescl_recover(Recovery_Info* recovery_info) {
 uns8 bp_tagescl_full(uns proc_id) {
   return tagescl_predictors.at(proc_id)->is_full();
 }
+
+void bp_tagescl_checkpoint(uns proc_id, Warm_State* ws) {
+  // The history buffers are sized for the in-flight branches
+  warm_state_shape(ws, "node_table_size", NODE_TABLE_SIZE);
+  Warm_State_Archive archive(ws);
+  tagescl_predictors.at(proc_id)->serialize(archive);
+}
@@ -37,6 +37,7 @@ void bp_tagescl_update(Op* op);
 void bp_tagescl_retire(Op* op);
 void bp_tagescl_recover(Recovery_Info*);
 uns8 bp_tagescl_full(uns proc_id);
+void bp_tagescl_checkpoint(uns proc_id, struct Warm_State_struct* ws);
 
 #ifdef __cplusplus
 }
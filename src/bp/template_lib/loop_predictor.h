@@ -198,6 +198,10 @@ class Loop_Predictor {
     prediction_info->hit_bank = -1;
   }
 
+  void serialize(State_Archive& archive) {
+    archive.transfer_bytes(table_.data(), table_.size() * sizeof(LoopPredictorEntry));
+  }
+
  private:
   struct LoopPredictorEntry {
     int16_t total_iterations = 0;                                                              // 10 bits
@@ -183,6 +183,38 @@ class Statistical_Corrector {
     }
   }
 
+  void serialize(State_Archive& archive) {
+    archive.transfer(global_history_);
+    archive.transfer(path_);
+    archive.transfer(first_local_history_table_);
+    archive.transfer(second_local_history_table_);
+    archive.transfer(third_local_history_table_);
+    archive.transfer(imli_counter_);
+    archive.transfer(imli_table_);
+    archive.transfer(first_high_confidence_ctr_);
+    archive.transfer(second_high_confidence_ctr_);
+    archive.transfer(update_threshold_);
+    archive.transfer(p_update_thresholds_);
+    archive.transfer(global_history_gehl_);
+    archive.transfer(path_gehl_);
+    archive.transfer(first_local_gehl_);
+    archive.transfer(second_local_gehl_);
+    archive.transfer(third_local_gehl_);
+    archive.transfer(first_imli_gehl_);
+    archive.transfer(second_imli_gehl_);
+    archive.transfer(global_history_threshold_table_);
+    archive.transfer(path_threshold_table_);
+    archive.transfer(first_local_threshold_table_);
+    archive.transfer(second_local_threshold_table_);
+    archive.transfer(third_local_threshold_table_);
+    archive.transfer(first_imli_threshold_table_);
+    archive.transfer(second_imli_threshold_table_);
+    archive.transfer(bias_threshold_table_);
+    archive.transfer_bytes(bias_table_.data(), bias_table_.size() * sizeof(Counter_Type));
+    archive.transfer_bytes(bias_sk_table_.data(), bias_sk_table_.size() * sizeof(Counter_Type));
+    archive.transfer_bytes(bias_bank_table_.data(), bias_bank_table_.size() * sizeof(Counter_Type));
+  }
+
  private:
   using Counter_Type = Saturating_Counter<CONFIG::SC::PRECISION, true>;
   using Per_PC_Threshold_Table_Type =
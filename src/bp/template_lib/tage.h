@@ -28,7 +28,8 @@
 #include "utils.h"
 
 /* The main history register suitable for very large history. The history is
- * implemented as a circular buffer for efficiency. The API only allows
+ * implemented as a circular buffer of bits packed into 64-bit words for
+ * efficiency. The API only allows
  * insertions of bits into the most recent position of the history and provides
  * an accessor for random access of individual bits. It also provides an API for
  * rewinding the history to support recovery from mispeculation */
@@ -37,12 +38,12 @@ class Long_History_Register {
  public:
   // Buffer_size needs to be a power of 2. (buffer_size - history_size) should
   // be large enough to cover speculative branches that are not yet retired.
-  Long_History_Register(int max_in_flight_branches) : history_bits_() {
+  Long_History_Register(int max_in_flight_branches) : history_words_() {
     int log_buffer_size = get_min_num_bits_to_represent(history_size + max_in_flight_branches);
     buffer_size_ = 1 << log_buffer_size;
     buffer_access_mask_ = (1 << log_buffer_size) - 1;
     max_num_speculative_bits_ = buffer_size_ - history_size;
-    history_bits_.resize(buffer_size_);
+    history_words_.resize((buffer_size_ + 63) / 64);
   }
 
   // Pushes one bit into the history at the head. Increments
@@ -52,7 +53,9 @@ class Long_History_Register {
     // TODO: it will be cleaner to mask head_ with (size_ - 1) now. But I
     // want to keep it compatible with Seznec.
     head_ -= 1;
-    history_bits_[head_ & buffer_access_mask_] = bit;
+    int64_t idx = head_ & buffer_access_mask_;
+    uint64_t& word = history_words_[idx >> 6];
+    word = (word & ~(uint64_t{1} << (idx & 63))) | (uint64_t{bit} << (idx & 63));
 
     num_speculative_bits_ += 1;
     assert(num_speculative_bits_ <= max_num_speculative_bits_);
@@ -73,18 +76,47 @@ class Long_History_Register {
 
   // Random access interface, i=0 is the most recent branch (head).
   bool operator[](size_t i) const {
-    return history_bits_[(head_ + i) & buffer_access_mask_];
+    int64_t idx = (head_ + i) & buffer_access_mask_;
+    return (history_words_[idx >> 6] >> (idx & 63)) & 1;
+  }
+
+  // Returns num_bits consecutive history bits starting at i, where bit p of
+  // the result is (*this)[i + p]. num_bits must not exceed 63.
+  uint64_t get_bits(size_t i, int num_bits) const {
+    int64_t idx = (head_ + i) & buffer_access_mask_;
+    uint64_t bits;
+    if (buffer_size_ < 64) {
+      bits = 0;
+      for (int p = num_bits - 1; p >= 0; --p) {
+        bits = (bits << 1) | (*this)[i + p];
+      }
+      return bits;
+    }
+    int64_t word_idx = idx >> 6;
+    int offset = idx & 63;
+    bits = history_words_[word_idx] >> offset;
+    if (offset + num_bits > 64) {
+      // the words wrap around like the bits, since buffer_size_ is a multiple of 64
+      bits |= history_words_[(word_idx + 1) & (history_words_.size() - 1)] << (64 - offset);
+    }
+    return bits & ((uint64_t{1} << num_bits) - 1);
   }
 
   int64_t head_idx() const {
     return head_;
   }
 
+  void serialize(State_Archive& archive) {
+    archive.transfer_bytes(history_words_.data(), history_words_.size() * sizeof(uint64_t));
+    archive.transfer(head_);
+    archive.transfer(num_speculative_bits_);
+  }
+
  private:
   int num_speculative_bits_ = 0;  // keeps track of how many bits can be
                                   // discarded during a rewind without losing
                                   // bits in the most significant position.
-  std::vector<bool> history_bits_;
+  std::vector<uint64_t> history_words_;
   int64_t head_ = 0;
   int64_t buffer_size_;
   int64_t buffer_access_mask_;
@@ -106,35 +138,36 @@ class Folded_History {
     return current_value_;
   }
 
-  void update(const Long_History_Register<history_size>& history_register) {
-    // Shift in the most recent GHR bit.
-    current_value_ = (current_value_ << 1) ^ history_register[0];
-
-    // Shift out the least recent GHR bit.
-    current_value_ ^= history_register[original_length_] << outpoint_;
-
-    // Fold shifted-out bit in.
-    current_value_ ^= current_value_ >> compressed_length_;
-
-    // Mask out the unused bits.
-    current_value_ &= (1 << compressed_length_) - 1;
+  // Restores a value saved with get_value() (e.g., when recovering from
+  // mispeculation).
+  void set_value(int64_t value) {
+    current_value_ = value;
   }
 
-  void update_reverse(const Long_History_Register<history_size>& history_register) {
-    // Fold out the most recent GHR bit.
-    current_value_ ^= history_register[0];
-
-    // Fold out the least recent GHR bit.
-    current_value_ ^= history_register[original_length_] << outpoint_;
-
-    // Rotate the low bit around to high bit.
-    current_value_ = ((current_value_ & 1) << (compressed_length_ - 1)) | (current_value_ >> 1);
+  void serialize(State_Archive& archive) {
+    archive.transfer(current_value_);
+  }
 
-    // Mask out the unused bits.
-    current_value_ &= (1 << compressed_length_) - 1;
+  // Folds in the num_bits most recent bits pushed into history_register at
+  // once. Folding in one bit rotates the folded value left by one and xors in
+  // the pushed bit and the bit shifted out of the original history (at
+  // outpoint_). So num_bits of them rotate it by num_bits and xor in both
+  // groups of bits as words.
+  void update(const Long_History_Register<history_size>& history_register, int num_bits) {
+    assert(num_bits <= compressed_length_);
+    int64_t pushed_bits = history_register.get_bits(0, num_bits);
+    int64_t shifted_out_bits = history_register.get_bits(original_length_, num_bits);
+    current_value_ = rotate_left(current_value_, num_bits) ^ pushed_bits ^ rotate_left(shifted_out_bits, outpoint_);
   }
 
  private:
+  // Rotates a compressed_length_-bit value left by num_bits (at most
+  // compressed_length_).
+  int64_t rotate_left(int64_t value, int num_bits) const {
+    int64_t mask = (int64_t{1} << compressed_length_) - 1;
+    return ((value << num_bits) | (value >> (compressed_length_ - num_bits))) & mask;
+  }
+
   int64_t current_value_;
   int original_length_;
   int compressed_length_;
@@ -227,10 +260,20 @@ struct Tage_Prediction_Info {
   int num_global_history_bits;
   int64_t global_history_head_checkpoint_;
   int64_t path_history_checkpoint;
+
+  // Folded histories before the branch was pushed into the history, so that
+  // recovery does not have to fold the flushed bits back out one by one.
+  uint16_t folded_history_for_indices_checkpoint[TAGE_CONFIG::NUM_HISTORIES];
+  uint16_t folded_history_for_tags_0_checkpoint[TAGE_CONFIG::NUM_HISTORIES];
+  uint16_t folded_history_for_tags_1_checkpoint[TAGE_CONFIG::NUM_HISTORIES];
 };
 
 template <class TAGE_CONFIG>
 class Tage_Histories {
+  static_assert(TAGE_CONFIG::LOG_ENTRIES_PER_BANK <= 16 && TAGE_CONFIG::SHORT_HISTORY_TAG_BITS <= 16 &&
+                    TAGE_CONFIG::LONG_HISTORY_TAG_BITS <= 16,
+                "Folded histories must fit their 16-bit checkpoints in Tage_Prediction_Info");
+
  public:
   Tage_Histories(int max_in_flight_branches) : history_register_(max_in_flight_branches) {
     path_history_ = 0;
@@ -255,6 +298,11 @@ class Tage_Histories {
     prediction_info->num_global_history_bits = num_bit_inserts;
     prediction_info->path_history_checkpoint = path_history_;
     prediction_info->global_history_head_checkpoint_ = history_register_.head_idx();
+    for (int j = 0; j < TAGE_CONFIG::NUM_HISTORIES; ++j) {
+      prediction_info->folded_history_for_indices_checkpoint[j] = folded_histories_for_indices_[j].get_value();
+      prediction_info->folded_history_for_tags_0_checkpoint[j] = folded_histories_for_tags_0_[j].get_value();
+      prediction_info->folded_history_for_tags_1_checkpoint[j] = folded_histories_for_tags_1_[j].get_value();
+    }
 
     for (int i = 0; i < num_bit_inserts; ++i) {
       history_register_.push_bit(pc_dir_hash & 1);
@@ -262,12 +310,13 @@ class Tage_Histories {
 
       path_history_ = (path_history_ << 1) ^ (path_hash & 127);
       path_hash >>= 1;
+    }
 
-      for (int j = 0; j < TAGE_CONFIG::NUM_HISTORIES; ++j) {
-        folded_histories_for_indices_[j].update(history_register_);
-        folded_histories_for_tags_0_[j].update(history_register_);
-        folded_histories_for_tags_1_[j].update(history_register_);
-      }
+    // All the bits of the branch are folded in at once.
+    for (int j = 0; j < TAGE_CONFIG::NUM_HISTORIES; ++j) {
+      folded_histories_for_indices_[j].update(history_register_, num_bit_inserts);
+      folded_histories_for_tags_0_[j].update(history_register_, num_bit_inserts);
+      folded_histories_for_tags_1_[j].update(history_register_, num_bit_inserts);
     }
 
     path_history_ = path_history_ & ((1 << TAGE_CONFIG::PATH_HISTORY_WIDTH) - 1);
@@ -275,6 +324,18 @@ class Tage_Histories {
 
   void intialize_folded_history(void);
 
+  void serialize(State_Archive& archive) {
+    history_register_.serialize(archive);
+    for (int j = 0; j < TAGE_CONFIG::NUM_HISTORIES; ++j) {
+      folded_histories_for_indices_[j].serialize(archive);
+      folded_histories_for_tags_0_[j].serialize(archive);
+      folded_histories_for_tags_1_[j].serialize(archive);
+    }
+    archive.transfer(path_history_);
+    archive.transfer(head_old_);
+    archive.transfer(path_history_old_);
+  }
+
   // Hash function for the path history used in creating table indices.
   int64_t compute_path_hash(int64_t path_history, int max_width, int bank, int index_size) const;
 
@@ -536,13 +597,14 @@ class Tage {
   void global_recover_speculative_state(const Tage_Prediction_Info<TAGE_CONFIG>& prediction_info) {
     int64_t num_flushed_bits =
         (prediction_info.global_history_head_checkpoint_ - tage_histories_.history_register_.head_idx());
-    for (int i = 0; i < num_flushed_bits; ++i) {
-      for (int j = 0; j < TAGE_CONFIG::NUM_HISTORIES; ++j) {
-        tage_histories_.folded_histories_for_indices_[j].update_reverse(tage_histories_.history_register_);
-        tage_histories_.folded_histories_for_tags_0_[j].update_reverse(tage_histories_.history_register_);
-        tage_histories_.folded_histories_for_tags_1_[j].update_reverse(tage_histories_.history_register_);
-      }
-      tage_histories_.history_register_.rewind(1);
+    if (num_flushed_bits > 0) {
+      tage_histories_.history_register_.rewind(num_flushed_bits);
+    }
+    for (int j = 0; j < TAGE_CONFIG::NUM_HISTORIES; ++j) {
+      tage_histories_.folded_histories_for_indices_[j].set_value(
+          prediction_info.folded_history_for_indices_checkpoint[j]);
+      tage_histories_.folded_histories_for_tags_0_[j].set_value(prediction_info.folded_history_for_tags_0_checkpoint[j]);
+      tage_histories_.folded_histories_for_tags_1_[j].set_value(prediction_info.folded_history_for_tags_1_checkpoint[j]);
     }
     tage_histories_.path_history_ = prediction_info.path_history_checkpoint;
   }
@@ -553,6 +615,15 @@ class Tage {
     *prediction_info = {};
   }
 
+  void serialize(State_Archive& archive) {
+    tage_histories_.serialize(archive);
+    archive.transfer(bimodal_table_);
+    archive.transfer(low_history_tagged_table_);
+    archive.transfer(high_history_tagged_table_);
+    archive.transfer(alt_selector_table_);
+    archive.transfer(tick_);
+  }
+
  private:
   struct Bimodal_Entry {
     int8_t hysteresis = 1;
@@ -46,6 +46,7 @@ class Tage_SC_L_Base {
   virtual void flush_branch_and_repair_state(int64_t branch_id, uint64_t br_pc, Branch_Type br_type, bool resolve_dir,
                                              uint64_t br_target) = 0;
   virtual bool is_full() = 0;
+  virtual void serialize(State_Archive& archive) = 0;
 };
 
 /* Interface functions:
@@ -117,6 +118,16 @@ class Tage_SC_L : public Tage_SC_L_Base {
   void flush_branch_and_repair_state(int64_t branch_id, uint64_t br_pc, Branch_Type br_type, bool resolve_dir,
                                      uint64_t br_target) override;
 
+  // Saves or restores the predictor tables and histories. There must be no
+  // in-flight branches.
+  void serialize(State_Archive& archive) override {
+    archive.transfer(random_number_gen_.seed_);
+    tage_.serialize(archive);
+    statistical_corrector_.serialize(archive);
+    loop_predictor_.serialize(archive);
+    archive.transfer(loop_predictor_beneficial_);
+  }
+
  private:
   Random_Number_Generator random_number_gen_;
   Tage<typename CONFIG::TAGE> tage_;
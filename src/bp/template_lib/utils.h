@@ -23,6 +23,7 @@
 #define __TAGE_SC_L_LIB_H_
 
 #include <cassert>
+#include <cstddef>
 
 inline int get_min_num_bits_to_represent(int x) {
   assert(x > 0);
@@ -146,6 +147,24 @@ struct Branch_Type {
   bool is_indirect;
 };
 
+/* Saves or restores the tables of a predictor (e.g. for warm-state
+ * checkpoints). transfer_bytes() either copies the bytes out of data or
+ * overwrites them, so a single serialize() function handles both directions.
+ * Only the state that survives retirement is transferred: there must be no
+ * in-flight branches. */
+class State_Archive {
+ public:
+  virtual ~State_Archive() {}
+
+  virtual void transfer_bytes(void* data, size_t size) = 0;
+
+  // T must be trivially copyable.
+  template <typename T>
+  void transfer(T& value) {
+    transfer_bytes(&value, sizeof(T));
+  }
+};
+
 template <typename T>
 class Circular_Buffer {
  public:
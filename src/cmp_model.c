@@ -54,6 +54,7 @@
 
 #include "decoupled_frontend.h"
 #include "freq.h"
+#include "host_profile.h"
 #include "idq_stage.h"
 #include "map_rename.h"
 #include "op_pool.h"
@@ -175,7 +176,7 @@ void cmp_cycle() {
 
   /* Frequency domain checking is inside this function, since it
    * handles both shared cache and memory */
-  update_memory();
+  HOST_PROFILE(MEMORY, update_memory());
 
   cmp_cores();
 
@@ -221,26 +222,26 @@ void cmp_cores(void) {
       cmp_set_all_stages(proc_id);
 
       /* Back-end pipeline */
-      update_dcache_stage(&exec->sd);
-      update_exec_stage(&node->sd);
-      update_node_stage(map->last_sd);
-      update_map_stage(idq_stage_get_stage_data());
+      HOST_PROFILE(DCACHE_STAGE, update_dcache_stage(&exec->sd));
+      HOST_PROFILE(EXEC_STAGE, update_exec_stage(&node->sd));
+      HOST_PROFILE(NODE_STAGE, update_node_stage(map->last_sd));
+      HOST_PROFILE(MAP_STAGE, update_map_stage(idq_stage_get_stage_data()));
 
       /* IDQ stage that bridges the front-end and back-end */
       /* This stage can get uops from the uc->sd, cache queue, or decoder. */
-      update_idq_stage(dec->last_sd, &uc->sd, uop_queue_stage_get_latest_sd());
+      HOST_PROFILE(IDQ_STAGE, update_idq_stage(dec->last_sd, &uc->sd, uop_queue_stage_get_latest_sd()));
 
       /* Front-end pipiline */
-      update_uop_queue_stage(&uc->sd);
-      update_decode_stage(&ic->sd);
-      update_icache_stage();
+      HOST_PROFILE(UOP_QUEUE_STAGE, update_uop_queue_stage(&uc->sd));
+      HOST_PROFILE(DECODE_STAGE, update_decode_stage(&ic->sd));
+      HOST_PROFILE(ICACHE_STAGE, update_icache_stage());
 
       /* Decoupled branch prediction and prefetching */
-      update_decoupled_fe();
-      update_fdip();
-      update_eip();
+      HOST_PROFILE(DECOUPLED_FE, update_decoupled_fe());
+      HOST_PROFILE(FDIP, update_fdip());
+      HOST_PROFILE(EIP, update_eip());
 
-      node_sched_ops();
+      HOST_PROFILE(NODE_SCHED, node_sched_ops());
 
       cmp_measure_chip_util();
     }
@@ -282,6 +283,8 @@ void cmp_done() {
     pref_done();
   if (DVFS_ON)
     dvfs_done();
+  if (PER_BRANCH_STAT)
+    bp_done();
 
   finalize_memory();
   for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
@@ -48,6 +48,11 @@ extern uns POWER_NUM_ALUS;
 extern uns POWER_NUM_MULS_AND_DIVS;
 extern uns POWER_NUM_FPUS;
 
+/* In a frozen build (make opt-frozen) hot parameters are compile-time constants */
+#if defined(SCARAB_FROZEN_PARAMS) && !defined(SCARAB_PARAM_DEFINITIONS)
+#include "frozen.param.h"
+#endif
+
 /**************************************************************************************/
 
 #endif /* #ifndef __CORE_PARAM_H__ */
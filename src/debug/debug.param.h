@@ -38,6 +38,11 @@
 #include "debug/debug.param.def"
 #undef DEF_PARAM
 
+/* In a frozen build (make opt-frozen) hot parameters are compile-time constants */
+#if defined(SCARAB_FROZEN_PARAMS) && !defined(SCARAB_PARAM_DEFINITIONS)
+#include "frozen.param.h"
+#endif
+
 /**************************************************************************************/
 
 #endif /* #ifndef __DEBUG_PARAM_H__ */
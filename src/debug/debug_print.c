@@ -63,6 +63,7 @@
 
 static int compare_reg_ids(const void* p1, const void* p2);
 static int print_reg_array(char* buf, Reg_Info* regs, uns num);
+static int print_reg_ids(char* buf, const uns16* ids, uns num);
 
 /**************************************************************************************/
 /* External Variables */
@@ -380,14 +381,21 @@ static int compare_reg_ids(const void* p1, const void* p2) {
 }
 
 static int print_reg_array(char* buf, Reg_Info* regs, uns num) {
+  uns16 ids[MAX2(MAX_SRCS, MAX_DESTS)];
+  ASSERT(0, num <= MAX2(MAX_SRCS, MAX_DESTS));
+  for (uns i = 0; i < num; ++i)
+    ids[i] = regs[i].id;
+  return print_reg_ids(buf, ids, num);
+}
+
+static int print_reg_ids(char* buf, const uns16* ids, uns num) {
   uns i;
   char* orig_buf = buf;
   buf[0] = '\0';  // empty string in case there are zero regs
   // printing sorted array for easy comparison between frontends
   uns16 reg_buf[MAX2(MAX_SRCS, MAX_DESTS)];
   ASSERT(0, num <= MAX2(MAX_SRCS, MAX_DESTS));
-  for (i = 0; i < num; ++i)
-    reg_buf[i] = regs[i].id;
+  memcpy(reg_buf, ids, num * sizeof(uns16));
   qsort(reg_buf, num, sizeof(uns16), compare_reg_ids);
   for (i = 0; i < num; ++i)
     buf += sprintf(buf, " %s", disasm_reg(reg_buf[i]));
@@ -417,15 +425,43 @@ void print_short_op_array(FILE* stream, Op* ops[], uns array_length) {
 
 char* disasm_op(Op* op, Flag wide) {
   static char buf[MAX_STR_LENGTH + 1];
+  Disasm_Info info;
+
+  get_disasm_info(&info, op);
+  print_disasm_info(buf, &info, wide);
+  return buf;
+}
+
+/**************************************************************************************/
+/* get_disasm_info: */
+
+void get_disasm_info(Disasm_Info* info, Op* op) {
+  info->op_type = op->table_info->op_type;
+  info->cf_type = op->table_info->cf_type;
+  info->mem_type = op->table_info->mem_type;
+  info->num_src_regs = op->table_info->num_src_regs;
+  info->num_dest_regs = op->table_info->num_dest_regs;
+  info->mem_size = op->oracle_info.mem_size;
+  info->va = op->oracle_info.va;
+  ASSERT(op->proc_id, info->num_src_regs <= MAX_SRCS && info->num_dest_regs <= MAX_DESTS);
+  for (uns i = 0; i < info->num_src_regs; ++i)
+    info->src_ids[i] = op->inst_info->srcs[i].id;
+  for (uns i = 0; i < info->num_dest_regs; ++i)
+    info->dest_ids[i] = op->inst_info->dests[i].id;
+}
+
+/**************************************************************************************/
+/* print_disasm_info: prints the disassembly to buf, returns its length */
 
+int print_disasm_info(char* buf, const Disasm_Info* info, Flag wide) {
   const char* opcode;
-  if (op->table_info->op_type == OP_CF) {
-    opcode = cf_type_names[op->table_info->cf_type];
-  } else if (op->table_info->op_type == OP_ILD || op->table_info->op_type == OP_IST ||
-             op->table_info->op_type == OP_FLD || op->table_info->op_type == OP_FST) {
-    opcode = mem_type_names[op->table_info->mem_type];
+  if (info->op_type == OP_CF) {
+    opcode = cf_type_names[info->cf_type];
+  } else if (info->op_type == OP_ILD || info->op_type == OP_IST || info->op_type == OP_FLD ||
+             info->op_type == OP_FST) {
+    opcode = mem_type_names[info->mem_type];
   } else {
-    opcode = Op_Type_str(op->table_info->op_type);
+    opcode = Op_Type_str(info->op_type);
   }
 
   uns i = 0;
@@ -433,18 +469,18 @@ char* disasm_op(Op* op, Flag wide) {
 
   if (wide) {
     i += sprintf(&buf[i], "(");
-    i += print_reg_array(&buf[i], op->inst_info->srcs, op->table_info->num_src_regs);
-    if (op->table_info->mem_type == MEM_LD && op->oracle_info.mem_size > 0) {
-      i += sprintf(&buf[i], " %d@%08x", op->oracle_info.mem_size, (int)op->oracle_info.va);
+    i += print_reg_ids(&buf[i], info->src_ids, info->num_src_regs);
+    if (info->mem_type == MEM_LD && info->mem_size > 0) {
+      i += sprintf(&buf[i], " %d@%08x", info->mem_size, (int)info->va);
     }
-    if (op->table_info->num_src_regs + op->table_info->num_dest_regs > 0)
+    if (info->num_src_regs + info->num_dest_regs > 0)
       i += sprintf(&buf[i], " ->");
-    i += print_reg_array(&buf[i], op->inst_info->dests, op->table_info->num_dest_regs);
-    if (op->table_info->mem_type == MEM_ST && op->oracle_info.mem_size > 0) {
-      i += sprintf(&buf[i], " %d@%08x", op->oracle_info.mem_size, (int)op->oracle_info.va);
+    i += print_reg_ids(&buf[i], info->dest_ids, info->num_dest_regs);
+    if (info->mem_type == MEM_ST && info->mem_size > 0) {
+      i += sprintf(&buf[i], " %d@%08x", info->mem_size, (int)info->va);
     }
     i += sprintf(&buf[i], " )");
   }
 
-  return buf;
+  return i;
 }
@@ -33,6 +33,8 @@
 
 #include "globals/global_types.h"
 
+#include "inst_info.h"
+
 /**************************************************************************************/
 /* External Variables */
 
@@ -41,6 +43,22 @@ extern const char* const tcache_state_names[];
 extern const char* const cf_type_names[];
 extern const char* const sm_state_names[];
 
+/**************************************************************************************/
+/* Types */
+
+/* Everything disasm_op prints, so that an op can be disassembled after it is freed */
+typedef struct Disasm_Info_struct {
+  Op_Type op_type;
+  Cf_Type cf_type;
+  Mem_Type mem_type;
+  uns8 num_src_regs;
+  uns8 num_dest_regs;
+  uns mem_size;
+  Addr va;
+  uns16 src_ids[MAX_SRCS];
+  uns16 dest_ids[MAX_DESTS];
+} Disasm_Info;
+
 /**************************************************************************************/
 /* Prototypes */
 
@@ -54,6 +72,8 @@ void print_op_field(FILE*, Op*, uns);
 void print_field_tail(FILE*, uns);
 void print_field_head(FILE*, uns);
 char* disasm_op(Op*, Flag wide);
+void get_disasm_info(Disasm_Info*, Op*);
+int print_disasm_info(char* buf, const Disasm_Info*, Flag wide);
 char* disasm_reg(uns);
 
 /**************************************************************************************/
@@ -28,6 +28,9 @@
 
 #include "debug/memview.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "globals/assert.h"
 #include "globals/global_types.h"
 
@@ -38,6 +41,8 @@
 
 #include "memory/memory.h"
 
+#include "debug/trace_writer.h"
+
 #include "exec_ports.h"
 #include "freq.h"
 #include "trigger.h"
@@ -52,6 +57,47 @@ DEFINE_ENUM(Memview_Note_Type, MEMVIEW_NOTE_TYPE_LIST);
 /**************************************************************************************/
 /* Types */
 
+typedef enum Memview_Record_Kind_enum {
+  MEMVIEW_RECORD_DRAM,
+  MEMVIEW_RECORD_CRIT_PATH,
+  MEMVIEW_RECORD_MEMQUEUE,
+  MEMVIEW_RECORD_LLC,
+  MEMVIEW_RECORD_CORE,
+  MEMVIEW_RECORD_FUS_BUSY,
+  MEMVIEW_RECORD_NOTE,
+} Memview_Record_Kind;
+
+/* One trace line, rendered by the trace writer thread. Strings that are not literals
+   are copied at full length and freed once rendered. */
+typedef struct Memview_Record_struct {
+  Memview_Record_Kind kind;
+  Counter begin;
+  Counter end;
+  int proc_id;
+  union {
+    struct {
+      Memview_Dram_Event event;
+      Counter unique_num;
+      int id;
+      uns flat_bank_id;
+      uns pos;
+    } dram;
+    struct {
+      char* from_type_str;
+      char* to_type_str;
+      uns from_index;
+      uns to_index;
+    } crit_path;
+    uns num_reqs_by_type[MRT_NUM_ELEMS];
+    const char* state;  // string literal
+    uns fus_busy;
+    struct {
+      Memview_Note_Type type;
+      char* str;
+    } note;
+  };
+} Memview_Record;
+
 typedef struct Bank_Info_struct {
   uns pos;
 } Bank_Info;
@@ -70,7 +116,7 @@ typedef struct Proc_Info_struct {
 /**************************************************************************************/
 /* Global Variables */
 
-FILE* trace;
+static Trace_Writer* trace;
 Bank_Info* bank_infos;
 static Proc_Info* proc_infos;
 Trigger* start_trigger;
@@ -82,6 +128,8 @@ Mem_Req_Type* req_types;
 static void trace_memqueue_state(uns proc_id, Counter begin, Counter end, uns* num_reqs_by_type);
 static void trace_core_state(uns proc_id, Counter begin, Counter end, const char* state);
 static void trace_fus_busy(uns proc_id, Counter begin, Counter end, uns fus_busy);
+static Memview_Record* trace_record(Memview_Record_Kind kind, Counter begin, Counter end, int proc_id);
+static void render_record(FILE* file, const void* data);
 
 /**************************************************************************************/
 /* memview_init */
@@ -92,9 +140,10 @@ void memview_init(void) {
     return;
   }
 
-  const char* memview_filename = MEMVIEW_FILE;
-  trace = fopen(memview_filename, "w");
-  ASSERTM(0, trace, "Could not open %s\n", memview_filename);
+  char memview_filename[MAX_STR_LENGTH + 1];
+  snprintf(memview_filename, MAX_STR_LENGTH + 1, "%s/%s%s", OUTPUT_DIR, FILE_TAG, MEMVIEW_FILE);
+  FILE* file = fopen(memview_filename, "w");
+  ASSERTM(0, file, "Could not open %s\n", memview_filename);
 
   bank_infos = calloc(RAMULATOR_CHANNELS * RAMULATOR_BANKS, sizeof(Bank_Info));
   proc_infos = calloc(NUM_CORES, sizeof(Proc_Info));
@@ -112,7 +161,7 @@ void memview_init(void) {
 
   start_trigger = trigger_create("MEMVIEW START TRIGGER", MEMVIEW_START, TRIGGER_ONCE);
 
-#define MEMVIEW_PARAM_PRINT(param) fprintf(trace, "%-20s %3d\n", #param, param)
+#define MEMVIEW_PARAM_PRINT(param) fprintf(file, "%-20s %3d\n", #param, param)
   MEMVIEW_PARAM_PRINT(NUM_CORES);
   MEMVIEW_PARAM_PRINT(NUM_FUS);
   // MEMVIEW_PARAM_PRINT(MEMORY_CYCLE_TIME);
@@ -123,7 +172,9 @@ void memview_init(void) {
   MEMVIEW_PARAM_PRINT(MEMVIEW_NOTE_NUM_ELEMS);
 #undef MEMVIEW_PARAM_PRINT
 
-  fprintf(trace, "\n");  // empty line indicates end of param section
+  fprintf(file, "\n");  // empty line indicates end of param section
+
+  trace = trace_writer_create(file, sizeof(Memview_Record), render_record);
 }
 
 /**************************************************************************************/
@@ -136,8 +187,13 @@ void memview_dram(Memview_Dram_Event event, Mem_Req* req, uns flat_bank_id, Coun
     return;
 
   Bank_Info* bank_info = &bank_infos[flat_bank_id];
-  fprintf(trace, "%8s %10s %20lld %20lld %2d %10lld %3d %2d %2d\n", "DRAM", Memview_Dram_Event_str(event), start, end,
-          req ? req->proc_id : -1, req ? req->unique_num : -1, req ? req->id : -1, flat_bank_id, bank_info->pos);
+  Memview_Record* record = trace_record(MEMVIEW_RECORD_DRAM, start, end, req ? req->proc_id : -1);
+  record->dram.event = event;
+  record->dram.unique_num = req ? req->unique_num : -1;
+  record->dram.id = req ? req->id : -1;
+  record->dram.flat_bank_id = flat_bank_id;
+  record->dram.pos = bank_info->pos;
+  trace_writer_commit(trace);
   if (event == MEMVIEW_DRAM_COLUMN) {
     bank_info->pos = (bank_info->pos + 1) % 3;
   }
@@ -150,16 +206,18 @@ void memview_dram_crit_path(const char* from_type_str, uns from_index, const cha
   if (!trigger_on(start_trigger))
     return;
 
-  fprintf(trace, "%8s %10s %20lld %20lld  %s[%d]->%s[%d]\n", "DRAM", "CRIT_PATH", start, end, from_type_str, from_index,
-          to_type_str, to_index);
+  Memview_Record* record = trace_record(MEMVIEW_RECORD_CRIT_PATH, start, end, 0);
+  record->crit_path.from_type_str = strdup(from_type_str);
+  record->crit_path.to_type_str = strdup(to_type_str);
+  record->crit_path.from_index = from_index;
+  record->crit_path.to_index = to_index;
+  trace_writer_commit(trace);
 }
 
 void trace_memqueue_state(uns proc_id, Counter begin, Counter end, uns* num_reqs_by_type) {
-  fprintf(trace, "%8s %10s %20lld %20lld %2d", "MEMQUEUE", "DURATION", begin, end, proc_id);
-  for (Mem_Req_Type type = 0; type < MRT_NUM_ELEMS; type++) {
-    fprintf(trace, " %2d", num_reqs_by_type[type]);
-  }
-  fprintf(trace, "\n");
+  Memview_Record* record = trace_record(MEMVIEW_RECORD_MEMQUEUE, begin, end, proc_id);
+  memcpy(record->num_reqs_by_type, num_reqs_by_type, sizeof(record->num_reqs_by_type));
+  trace_writer_commit(trace);
 }
 
 /**************************************************************************************/
@@ -221,8 +279,9 @@ void memview_l1(Mem_Req* req) {
     return;
 
   ASSERT(0, req);
-  fprintf(trace, "%8s %10s %20lld %20lld %2d\n", "LLC", "ACCESS", freq_time(),
-          (freq_time() + freq_get_cycle_time(FREQ_DOMAIN_L1) * L1_CYCLES), req->proc_id);
+  trace_record(MEMVIEW_RECORD_LLC, freq_time(), (freq_time() + freq_get_cycle_time(FREQ_DOMAIN_L1) * L1_CYCLES),
+               req->proc_id);
+  trace_writer_commit(trace);
 }
 
 /**************************************************************************************/
@@ -256,7 +315,9 @@ void memview_core_stall(uns proc_id, Flag stalled, Flag mem_blocked) {
 /* trace_core_state */
 
 void trace_core_state(uns proc_id, Counter begin, Counter end, const char* state) {
-  fprintf(trace, "%8s %10s %20lld %20lld %2d\n", "CORE", state, begin, end, proc_id);
+  Memview_Record* record = trace_record(MEMVIEW_RECORD_CORE, begin, end, proc_id);
+  record->state = state;
+  trace_writer_commit(trace);
 }
 
 /**************************************************************************************/
@@ -281,7 +342,9 @@ void memview_fus_busy(uns proc_id, uns fus_busy) {
 /* trace_fus_busy */
 
 void trace_fus_busy(uns proc_id, Counter begin, Counter end, uns fus_busy) {
-  fprintf(trace, "%8s %10s %20lld %20lld %2d %2d\n", "CORE", "FUS_BUSY", begin, end, proc_id, fus_busy);
+  Memview_Record* record = trace_record(MEMVIEW_RECORD_FUS_BUSY, begin, end, proc_id);
+  record->fus_busy = fus_busy;
+  trace_writer_commit(trace);
 }
 
 /**************************************************************************************/
@@ -301,7 +364,7 @@ void memview_done(void) {
       trace_memqueue_state(proc_id, proc_info->last_memqueue_change_time, freq_time(), proc_info->num_reqs_by_type);
     }
   }
-  fclose(trace);
+  trace_writer_close(trace);
 }
 
 /**************************************************************************************/
@@ -311,7 +374,65 @@ void memview_note(Memview_Note_Type type, const char* str) {
   if (!MEMVIEW)
     return;
   if (trigger_on(start_trigger)) {
-    fprintf(trace, "%8s %10d %20lld %20lld %2d %s\n", "NOTE", type, freq_time(), 0ULL, 0, str);
+    Memview_Record* record = trace_record(MEMVIEW_RECORD_NOTE, freq_time(), 0ULL, 0);
+    record->note.type = type;
+    record->note.str = strdup(str);
+    trace_writer_commit(trace);
+  }
+}
+
+/**************************************************************************************/
+/* trace_record: fills in the common fields of the next record */
+
+static Memview_Record* trace_record(Memview_Record_Kind kind, Counter begin, Counter end, int proc_id) {
+  Memview_Record* record = trace_writer_alloc(trace);
+  record->kind = kind;
+  record->begin = begin;
+  record->end = end;
+  record->proc_id = proc_id;
+  return record;
+}
+
+/**************************************************************************************/
+/* render_record: runs on the trace writer thread */
+
+static void render_record(FILE* file, const void* data) {
+  const Memview_Record* record = data;
+  switch (record->kind) {
+    case MEMVIEW_RECORD_DRAM:
+      fprintf(file, "%8s %10s %20lld %20lld %2d %10lld %3d %2d %2d\n", "DRAM", Memview_Dram_Event_str(record->dram.event),
+              record->begin, record->end, record->proc_id, record->dram.unique_num, record->dram.id,
+              record->dram.flat_bank_id, record->dram.pos);
+      break;
+    case MEMVIEW_RECORD_CRIT_PATH:
+      fprintf(file, "%8s %10s %20lld %20lld  %s[%d]->%s[%d]\n", "DRAM", "CRIT_PATH", record->begin, record->end,
+              record->crit_path.from_type_str, record->crit_path.from_index, record->crit_path.to_type_str,
+              record->crit_path.to_index);
+      free(record->crit_path.from_type_str);
+      free(record->crit_path.to_type_str);
+      break;
+    case MEMVIEW_RECORD_MEMQUEUE:
+      fprintf(file, "%8s %10s %20lld %20lld %2d", "MEMQUEUE", "DURATION", record->begin, record->end, record->proc_id);
+      for (Mem_Req_Type type = 0; type < MRT_NUM_ELEMS; type++) {
+        fprintf(file, " %2d", record->num_reqs_by_type[type]);
+      }
+      fprintf(file, "\n");
+      break;
+    case MEMVIEW_RECORD_LLC:
+      fprintf(file, "%8s %10s %20lld %20lld %2d\n", "LLC", "ACCESS", record->begin, record->end, record->proc_id);
+      break;
+    case MEMVIEW_RECORD_CORE:
+      fprintf(file, "%8s %10s %20lld %20lld %2d\n", "CORE", record->state, record->begin, record->end, record->proc_id);
+      break;
+    case MEMVIEW_RECORD_FUS_BUSY:
+      fprintf(file, "%8s %10s %20lld %20lld %2d %2d\n", "CORE", "FUS_BUSY", record->begin, record->end,
+              record->proc_id, record->fus_busy);
+      break;
+    case MEMVIEW_RECORD_NOTE:
+      fprintf(file, "%8s %10d %20lld %20lld %2d %s\n", "NOTE", record->note.type, record->begin, record->end,
+              record->proc_id, record->note.str);
+      free(record->note.str);
+      break;
   }
 }
 
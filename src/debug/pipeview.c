@@ -32,6 +32,7 @@
 #include "globals/global_defs.h"
 
 #include "debug/debug_print.h"
+#include "debug/trace_writer.h"
 
 #include "core.param.h"
 #include "general.param.h"
@@ -48,10 +49,32 @@ All events for a uop must be on consecutive lines
 
 ***************************************************************************************/
 
+/**************************************************************************************/
+/* Types: */
+
+/* Everything printed for an op, captured when it is freed */
+typedef struct Pipeview_Record_struct {
+  Counter cycle_count;  // cycle the op was freed
+  Counter fetch_cycle;
+  Counter map_cycle;
+  Counter issue_cycle;
+  Counter rdy_cycle;
+  Counter sched_cycle;
+  Counter exec_cycle;
+  Counter dcache_cycle;
+  Counter done_cycle;
+  Counter retire_cycle;
+  Counter unique_num_per_proc;
+  Addr addr;
+  Flag off_path;
+  Flag srcs_rdy;  // all sources were ready at rdy_cycle
+  Disasm_Info disasm;
+} Pipeview_Record;
+
 /**************************************************************************************/
 /* Global variables: */
 
-static FILE** files = NULL;
+static Trace_Writer** writers = NULL;
 
 /**************************************************************************************/
 /* Constants: */
@@ -61,20 +84,23 @@ static const char* PREFIX = "O3PipeView";
 /**************************************************************************************/
 /* Local prototypes: */
 
-void print_header(FILE*, Op*);
-void print_event(FILE*, Op*, const char*, Counter);
+static void render_op(FILE*, const void*);
+static void print_header(FILE*, const Pipeview_Record*);
+static void print_event(FILE*, const Pipeview_Record*, const char*, Counter);
 
 /**************************************************************************************/
-/* pipeview_init: */
+/* pipeview_init: the traces go to OUTPUT_DIR, which differs between sweep
+   configurations */
 
 void pipeview_init(void) {
-  files = malloc(sizeof(FILE*) * NUM_CORES);
+  writers = malloc(sizeof(Trace_Writer*) * NUM_CORES);
   if (PIPEVIEW) {
     for (uns proc_id = 0; proc_id < NUM_CORES; ++proc_id) {
       char filename[MAX_STR_LENGTH + 1];
-      sprintf(filename, "%s.%d.trace", PIPEVIEW_FILE, proc_id);
-      files[proc_id] = fopen(filename, "w");
-      ASSERT(proc_id, files[proc_id]);
+      snprintf(filename, MAX_STR_LENGTH + 1, "%s/%s%s.%d.trace", OUTPUT_DIR, FILE_TAG, PIPEVIEW_FILE, proc_id);
+      FILE* file = fopen(filename, "w");
+      ASSERT(proc_id, file);
+      writers[proc_id] = trace_writer_create(file, sizeof(Pipeview_Record), render_op);
     }
   }
 }
@@ -86,7 +112,45 @@ void pipeview_print_op(struct Op_struct* op) {
   if (!DEBUG_RANGE_COND(op->proc_id))
     return;
 
-  FILE* file = files[op->proc_id];
+  Trace_Writer* writer = writers[op->proc_id];
+  Pipeview_Record* record = trace_writer_alloc(writer);
+  record->cycle_count = cycle_count;
+  record->fetch_cycle = op->fetch_cycle;
+  record->map_cycle = op->map_cycle;
+  record->issue_cycle = op->issue_cycle;
+  record->rdy_cycle = op->rdy_cycle;
+  record->sched_cycle = op->sched_cycle;
+  record->exec_cycle = op->exec_cycle;
+  record->dcache_cycle = op->dcache_cycle;
+  record->done_cycle = op->done_cycle;
+  record->retire_cycle = op->retire_cycle;
+  record->unique_num_per_proc = op->unique_num_per_proc;
+  record->addr = op->inst_info->addr;
+  record->off_path = op->off_path;
+  // op was ready at rdy_cycle only if all sources are ready
+  record->srcs_rdy = op->srcs_not_rdy_vector == 0;
+  ASSERT(op->proc_id, record->srcs_rdy || op->off_path);
+  ASSERT(op->proc_id, op->off_path || op->retire_cycle <= cycle_count);
+  get_disasm_info(&record->disasm, op);
+  trace_writer_commit(writer);
+}
+
+/**************************************************************************************/
+/* pipeview_done: */
+
+void pipeview_done(void) {
+  if (PIPEVIEW) {
+    for (uns proc_id = 0; proc_id < NUM_CORES; ++proc_id) {
+      trace_writer_close(writers[proc_id]);
+    }
+  }
+}
+
+/**************************************************************************************/
+/* render_op: runs on the trace writer thread */
+
+static void render_op(FILE* file, const void* data) {
+  const Pipeview_Record* op = data;
   print_header(file, op);
   if (op->off_path) {
     print_event(file, op, "fetch_offpath", op->fetch_cycle);
@@ -99,45 +163,30 @@ void pipeview_print_op(struct Op_struct* op) {
   print_event(file, op, "map_done", op->map_cycle + MAP_CYCLES);
   print_event(file, op, "issue", op->issue_cycle);
   print_event(file, op, "issue_done", op->issue_cycle + 1);
-  if (op->srcs_not_rdy_vector == 0) {
-    // op was ready at rdy_cycle only if all sources are ready
+  if (op->srcs_rdy) {
     print_event(file, op, "ready", MAX2(op->rdy_cycle, op->issue_cycle + 1));
-  } else {
-    ASSERT(op->proc_id, op->off_path);
   }
   print_event(file, op, "sched", op->sched_cycle);
   print_event(file, op, "exec", op->exec_cycle);
   print_event(file, op, "dcache", op->dcache_cycle);
   print_event(file, op, "done", op->done_cycle);
   if (op->off_path) {
-    print_event(file, op, "flush", cycle_count);
-    print_event(file, op, "end", cycle_count);
+    print_event(file, op, "flush", op->cycle_count);
+    print_event(file, op, "end", op->cycle_count);
   } else {
-    ASSERT(op->proc_id, op->retire_cycle <= cycle_count);
     print_event(file, op, "retire", op->retire_cycle);
     print_event(file, op, "end", op->retire_cycle);
   }
 }
 
-/**************************************************************************************/
-/* pipeview_done: */
-
-void pipeview_done(void) {
-  if (PIPEVIEW) {
-    for (uns proc_id = 0; proc_id < NUM_CORES; ++proc_id) {
-      fclose(files[proc_id]);
-    }
-  }
-}
-
 /**************************************************************************************/
 /* print_event: */
 
-void print_event(FILE* file, Op* op, const char* name, Counter cycle) {
+static void print_event(FILE* file, const Pipeview_Record* op, const char* name, Counter cycle) {
   /* print only events that make sense because flushed ops may not
      have all *_cycle fields set and non mem ops will not have
      dcache_cycle set  */
-  if (cycle >= op->fetch_cycle && cycle <= cycle_count) {
+  if (cycle >= op->fetch_cycle && cycle <= op->cycle_count) {
     fprintf(file, "%s:%s:%lld\n", PREFIX, name, cycle);
   }
 }
@@ -145,7 +194,9 @@ void print_event(FILE* file, Op* op, const char* name, Counter cycle) {
 /**************************************************************************************/
 /* print_header: */
 
-void print_header(FILE* file, Op* op) {
-  fprintf(file, "%s:new:%lld:%llx:%d:%lld:%s\n", PREFIX, op->fetch_cycle, op->inst_info->addr, 0,
-          op->unique_num_per_proc, disasm_op(op, TRUE));
+static void print_header(FILE* file, const Pipeview_Record* op) {
+  char disasm[MAX_STR_LENGTH + 1];
+  print_disasm_info(disasm, &op->disasm, TRUE);
+  fprintf(file, "%s:new:%lld:%llx:%d:%lld:%s\n", PREFIX, op->fetch_cycle, op->addr, 0, op->unique_num_per_proc,
+          disasm);
 }
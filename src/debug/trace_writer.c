@@ -0,0 +1,302 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : debug/trace_writer.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Asynchronous trace writer. Each writer owns a single-producer
+ *single-consumer ring of fixed-size records: the simulation thread only
+ *advances the tail, the writer thread only advances the head. One writer
+ *thread serves all the writers.
+ ***************************************************************************************/
+
+#include "debug/trace_writer.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/utils.h"
+
+#include "general.param.h"
+
+/**************************************************************************************/
+/* Types */
+
+struct Trace_Writer_struct {
+  FILE* file;
+  Trace_Render_Func render;
+  uns record_size;
+  uns64 num_records;  // ring capacity, a power of two
+  char* records;
+  uns64 head;  // next record to render, written by the writer thread
+  uns64 tail;  // next record to fill, written by the simulation thread
+  Trace_Writer* next;
+};
+
+/**************************************************************************************/
+/* Global Variables */
+
+#define TRACE_WRITER_FILE_BUFFER_SIZE (1 << 20)
+#define TRACE_WRITER_IDLE_NS 100000
+
+static pthread_mutex_t writers_lock = PTHREAD_MUTEX_INITIALIZER;
+static Trace_Writer* writers = NULL;  // writers served by the writer thread
+static pthread_t writer_thread;
+static Flag writer_thread_stop = FALSE;
+static Flag writer_thread_running = FALSE;  // only changed by the simulation thread
+static Flag handlers_registered = FALSE;
+static const int crash_signals[] = {SIGABRT, SIGSEGV, SIGBUS, SIGFPE, SIGILL};
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static void* writer_thread_main(void* arg);
+static void start_writer_thread(void);
+static void fork_prepare(void);
+static void fork_parent(void);
+static void fork_child(void);
+static void register_handlers(void);
+static void flush_at_exit(void);
+static void flush_on_signal(int sig);
+static void flush_all(Flag wait_for_lock);
+static Flag drain_writer(Trace_Writer* writer);
+static void idle_wait(void);
+
+/**************************************************************************************/
+/* trace_writer_create: */
+
+Trace_Writer* trace_writer_create(FILE* file, uns record_size, Trace_Render_Func render) {
+  ASSERT(0, file && render && record_size > 0);
+  Trace_Writer* writer = calloc(1, sizeof(Trace_Writer));
+  writer->file = file;
+  writer->render = render;
+  writer->record_size = ROUND_UP(record_size, sizeof(uns64));
+  writer->num_records = 1;
+  while (writer->num_records * 2 * writer->record_size <= TRACE_BUFFER_SIZE)
+    writer->num_records *= 2;
+  writer->records = malloc(writer->num_records * writer->record_size);
+  ASSERTM(0, writer->records, "Could not allocate the trace buffer\n");
+  setvbuf(file, NULL, _IOFBF, TRACE_WRITER_FILE_BUFFER_SIZE);
+
+  if (!handlers_registered)
+    register_handlers();
+
+  pthread_mutex_lock(&writers_lock);
+  writer->next = writers;
+  writers = writer;
+  pthread_mutex_unlock(&writers_lock);
+
+  if (!writer_thread_running)
+    start_writer_thread();
+  return writer;
+}
+
+/**************************************************************************************/
+/* start_writer_thread: */
+
+static void start_writer_thread(void) {
+  __atomic_store_n(&writer_thread_stop, FALSE, __ATOMIC_RELAXED);
+  int error = pthread_create(&writer_thread, NULL, writer_thread_main, NULL);
+  ASSERTM(0, !error, "Could not start the trace writer thread\n");
+  writer_thread_running = TRUE;
+}
+
+/**************************************************************************************/
+/* trace_writer_alloc: */
+
+void* trace_writer_alloc(Trace_Writer* writer) {
+  while (writer->tail - __atomic_load_n(&writer->head, __ATOMIC_ACQUIRE) == writer->num_records) {
+    if (!writer_thread_running)
+      start_writer_thread();  // a forked process does not inherit the writer thread
+    idle_wait();              // the ring is full, let the writer thread catch up
+  }
+  return writer->records + (writer->tail & (writer->num_records - 1)) * writer->record_size;
+}
+
+/**************************************************************************************/
+/* trace_writer_commit: */
+
+void trace_writer_commit(Trace_Writer* writer) {
+  __atomic_store_n(&writer->tail, writer->tail + 1, __ATOMIC_RELEASE);
+}
+
+/**************************************************************************************/
+/* trace_writer_close: */
+
+void trace_writer_close(Trace_Writer* writer) {
+  if (!writer_thread_running) {
+    pthread_mutex_lock(&writers_lock);
+    drain_writer(writer);
+    pthread_mutex_unlock(&writers_lock);
+  }
+  while (__atomic_load_n(&writer->head, __ATOMIC_ACQUIRE) != writer->tail)
+    idle_wait();
+
+  pthread_mutex_lock(&writers_lock);
+  Trace_Writer** prev = &writers;
+  while (*prev != writer)
+    prev = &(*prev)->next;
+  *prev = writer->next;
+  Flag stop_thread = writers == NULL && writer_thread_running;
+  pthread_mutex_unlock(&writers_lock);
+
+  if (stop_thread) {
+    writer_thread_running = FALSE;
+    __atomic_store_n(&writer_thread_stop, TRUE, __ATOMIC_RELAXED);
+    pthread_join(writer_thread, NULL);
+  }
+
+  fclose(writer->file);
+  free(writer->records);
+  free(writer);
+}
+
+/**************************************************************************************/
+/* register_handlers: the queued records are written out before a fork, on exit
+   (including the exit of ASSERT and FATAL_ERROR) and on a crash, so that the trace
+   leading up to a failure is not lost. Crash handlers are only installed for
+   signals nobody else handles. */
+
+static void register_handlers(void) {
+  int error = pthread_atfork(fork_prepare, fork_parent, fork_child);
+  ASSERTM(0, !error, "Could not register the trace writer fork handlers\n");
+  error = atexit(flush_at_exit);
+  ASSERTM(0, !error, "Could not register the trace writer exit handler\n");
+  for (uns ii = 0; ii < sizeof(crash_signals) / sizeof(crash_signals[0]); ii++) {
+    struct sigaction old_action;
+    sigaction(crash_signals[ii], NULL, &old_action);
+    if (old_action.sa_handler != SIG_DFL || (old_action.sa_flags & SA_SIGINFO))
+      continue;
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = flush_on_signal;
+    action.sa_flags = SA_RESETHAND;
+    sigemptyset(&action.sa_mask);
+    sigaction(crash_signals[ii], &action, NULL);
+  }
+  handlers_registered = TRUE;
+}
+
+/**************************************************************************************/
+/* flush_at_exit: an exit from a render function on the writer thread holds the lock */
+
+static void flush_at_exit(void) {
+  if (writer_thread_running && pthread_equal(pthread_self(), writer_thread))
+    return;
+  flush_all(TRUE);
+}
+
+/**************************************************************************************/
+/* flush_on_signal: the interrupted thread may hold the lock, so it is only tried.
+   SA_RESETHAND restored the default action, which the signal is raised again for. */
+
+static void flush_on_signal(int sig) {
+  flush_all(FALSE);
+  raise(sig);
+}
+
+/**************************************************************************************/
+/* flush_all: write out the queued records of every writer on the calling thread */
+
+static void flush_all(Flag wait_for_lock) {
+  if (wait_for_lock)
+    pthread_mutex_lock(&writers_lock);
+  else if (pthread_mutex_trylock(&writers_lock))
+    return;
+  for (Trace_Writer* writer = writers; writer; writer = writer->next) {
+    drain_writer(writer);
+    fflush(writer->file);
+  }
+  pthread_mutex_unlock(&writers_lock);
+}
+
+/**************************************************************************************/
+/* fork_prepare: a forked process gets neither the writer thread nor the queued
+   records, so they are written out before the fork. Holding the lock across the
+   fork keeps the writer thread from being inside it in the child. */
+
+static void fork_prepare(void) {
+  pthread_mutex_lock(&writers_lock);
+  for (Trace_Writer* writer = writers; writer; writer = writer->next) {
+    drain_writer(writer);
+    fflush(writer->file);
+  }
+}
+
+/**************************************************************************************/
+/* fork_parent: */
+
+static void fork_parent(void) {
+  pthread_mutex_unlock(&writers_lock);
+}
+
+/**************************************************************************************/
+/* fork_child: the writer thread is restarted by the next writer that needs it */
+
+static void fork_child(void) {
+  pthread_mutex_unlock(&writers_lock);
+  writer_thread_running = FALSE;
+}
+
+/**************************************************************************************/
+/* writer_thread_main: */
+
+static void* writer_thread_main(void* arg) {
+  while (!__atomic_load_n(&writer_thread_stop, __ATOMIC_RELAXED)) {
+    Flag busy = FALSE;
+    pthread_mutex_lock(&writers_lock);
+    for (Trace_Writer* writer = writers; writer; writer = writer->next)
+      busy |= drain_writer(writer);
+    pthread_mutex_unlock(&writers_lock);
+    if (!busy)
+      idle_wait();
+  }
+  return NULL;
+}
+
+/**************************************************************************************/
+/* drain_writer: renders the queued records, returns TRUE if there were any */
+
+static Flag drain_writer(Trace_Writer* writer) {
+  uns64 head = writer->head;
+  uns64 tail = __atomic_load_n(&writer->tail, __ATOMIC_ACQUIRE);
+  if (head == tail)
+    return FALSE;
+  for (; head != tail; head++) {
+    writer->render(writer->file, writer->records + (head & (writer->num_records - 1)) * writer->record_size);
+    __atomic_store_n(&writer->head, head + 1, __ATOMIC_RELEASE);
+  }
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* idle_wait: */
+
+static void idle_wait(void) {
+  struct timespec ts = {0, TRACE_WRITER_IDLE_NS};
+  nanosleep(&ts, NULL);
+}
@@ -0,0 +1,64 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : debug/trace_writer.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Asynchronous writer shared by the tracing facilities (pipeview,
+ *memview, stat_trace). The simulation thread copies fixed-size records into a
+ *lock-free ring per trace file; a background thread renders them to text and
+ *writes them out.
+ ***************************************************************************************/
+
+#ifndef __TRACE_WRITER_H__
+#define __TRACE_WRITER_H__
+
+#include <stdio.h>
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Types */
+
+struct Trace_Writer_struct;
+typedef struct Trace_Writer_struct Trace_Writer;
+
+/* Renders a record to the trace file. Called on the writer thread, so it
+   may only read the record and state that does not change after init. */
+typedef void (*Trace_Render_Func)(FILE* file, const void* record);
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Hand an open file over to a new writer. Anything already written to the
+   file (e.g. a header) comes before the records. */
+Trace_Writer* trace_writer_create(FILE* file, uns record_size, Trace_Render_Func render);
+
+/* Get the next record to fill in (waits for the writer thread if the ring
+   is full). The record is queued by trace_writer_commit. */
+void* trace_writer_alloc(Trace_Writer* writer);
+void trace_writer_commit(Trace_Writer* writer);
+
+/* Write out all queued records, then close the file and free the writer */
+void trace_writer_close(Trace_Writer* writer);
+
+#endif /* #ifndef __TRACE_WRITER_H__ */
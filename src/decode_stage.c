@@ -83,7 +83,6 @@ void set_decode_stage(Decode_Stage* new_dec) {
 /* init_decode_stage: */
 
 void init_decode_stage(uns8 proc_id, const char* name) {
-  char tmp_name[MAX_STR_LENGTH + 1];
   uns ii;
   ASSERT(0, dec);
   ASSERT(0, STAGE_MAX_DEPTH > 0);
@@ -92,15 +91,14 @@ void init_decode_stage(uns8 proc_id, const char* name) {
   memset(dec, 0, sizeof(Decode_Stage));
   dec->proc_id = proc_id;
 
-  dec->sds = (Stage_Data*)malloc(sizeof(Stage_Data) * STAGE_MAX_DEPTH);
+  dec->latches.sds = (Stage_Data*)malloc(sizeof(Stage_Data) * STAGE_MAX_DEPTH);
+  dec->latches.depth = STAGE_MAX_DEPTH;
   for (ii = 0; ii < STAGE_MAX_DEPTH; ii++) {
-    Stage_Data* cur = &dec->sds[ii];
-    snprintf(tmp_name, MAX_STR_LENGTH, "%s %d", name, STAGE_MAX_DEPTH - ii - 1);
-    cur->name = (char*)strdup(tmp_name);
+    Stage_Data* cur = &dec->latches.sds[ii];
+    cur->name = (char*)strdup(name);
     cur->max_op_count = STAGE_MAX_OP_COUNT;
     cur->ops = (Op**)calloc(STAGE_MAX_OP_COUNT, sizeof(Op*));
   }
-  dec->last_sd = &dec->sds[0];
   reset_decode_stage();
 }
 
@@ -111,11 +109,13 @@ void reset_decode_stage() {
   uns ii, jj;
   ASSERT(0, dec);
   for (ii = 0; ii < STAGE_MAX_DEPTH; ii++) {
-    Stage_Data* cur = &dec->sds[ii];
+    Stage_Data* cur = &dec->latches.sds[ii];
     cur->op_count = 0;
     for (jj = 0; jj < STAGE_MAX_OP_COUNT; jj++)
       cur->ops[jj] = NULL;
   }
+  dec->latches.head = 0;
+  dec->last_sd = stage_latches_get(&dec->latches, 0);
 }
 
 /**************************************************************************************/
@@ -126,7 +126,7 @@ void recover_decode_stage() {
   decode_off_path = false;
   ASSERT(0, dec);
   for (ii = 0; ii < STAGE_MAX_DEPTH; ii++) {
-    Stage_Data* cur = &dec->sds[ii];
+    Stage_Data* cur = &dec->latches.sds[ii];
     cur->op_count = 0;
     for (jj = 0; jj < STAGE_MAX_OP_COUNT; jj++) {
       if (cur->ops[jj]) {
@@ -148,8 +148,8 @@ void recover_decode_stage() {
 void debug_decode_stage() {
   uns ii;
   for (ii = 0; ii < STAGE_MAX_DEPTH; ii++) {
-    Stage_Data* cur = &dec->sds[STAGE_MAX_DEPTH - ii - 1];
-    DPRINTF("# %-10s  op_count:%d\n", cur->name, cur->op_count);
+    Stage_Data* cur = stage_latches_get(&dec->latches, STAGE_MAX_DEPTH - ii - 1);
+    DPRINTF("# %s %-3d  op_count:%d\n", cur->name, STAGE_MAX_DEPTH - ii - 1, cur->op_count);
     print_op_array(GLOBAL_DEBUG_STREAM, cur->ops, STAGE_MAX_OP_COUNT, cur->op_count);
   }
 }
@@ -162,8 +162,7 @@ void debug_decode_stage() {
 
 void update_decode_stage(Stage_Data* src_sd) {
   Flag stall = (dec->last_sd->op_count > 0);
-  Stage_Data *cur, *prev;
-  Op** temp;
+  Stage_Data* cur;
   uns ii;
 
   if (!decode_off_path) {
@@ -179,21 +178,12 @@ void update_decode_stage(Stage_Data* src_sd) {
     STAT_EVENT(dec->proc_id, DECODE_STAGE_OFF_PATH);
 
   /* do all the intermediate stages */
-  for (ii = 0; ii < STAGE_MAX_DEPTH - 1; ii++) {
-    cur = &dec->sds[ii];
-    if (cur->op_count)
-      continue;
-    prev = &dec->sds[ii + 1];
-    temp = cur->ops;
-    cur->ops = prev->ops;
-    prev->ops = temp;
-    cur->op_count = prev->op_count;
-    prev->op_count = 0;
-  }
+  stage_latches_advance(&dec->latches);
+  dec->last_sd = stage_latches_get(&dec->latches, 0);
 
   /* do the first decode stage */
   /* Ops from the uop cache do not go to the decode stage. */
-  cur = &dec->sds[STAGE_MAX_DEPTH - 1];
+  cur = stage_latches_get(&dec->latches, STAGE_MAX_DEPTH - 1);
   if (cur->op_count == 0 && src_sd->op_count) {
     for (int i = 0; i < src_sd->max_op_count; i++) {
       Op* src_op = src_sd->ops[i];
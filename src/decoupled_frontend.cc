@@ -32,11 +32,16 @@ class Decoupled_FE {
   decoupled_fe_iter* new_ftq_iter();
   Op* ftq_iter_get(decoupled_fe_iter* iter, bool* end_of_ft);
   Op* ftq_iter_get_next(decoupled_fe_iter* iter, bool* end_of_ft);
-  uint64_t ftq_num_ops();
-  uint64_t ftq_num_fts() { return ftq.size(); }
+  uint64_t ftq_iter_offset(decoupled_fe_iter* iter);
+  uint64_t ftq_iter_ft_offset(decoupled_fe_iter* iter);
+  uint64_t ftq_num_ops() { return ftq_ops; }
+  uint64_t ftq_num_fts() { return ftq_tail - ftq_head; }
   void stall(Op* op);
   void retire(Op* op, int op_proc_id, uns64 inst_uid);
-  void set_ftq_num(uint64_t set_ftq_ft_num) { ftq_ft_num = set_ftq_ft_num; }
+  void set_ftq_num(uint64_t set_ftq_ft_num) {
+    ASSERT(proc_id, set_ftq_ft_num <= ftq.size());
+    ftq_ft_num = set_ftq_ft_num;
+  }
   uint64_t get_ftq_num() { return ftq_ft_num; }
   Op* get_cur_op() { return cur_op; }
   uns get_conf() { return conf->get_conf(); }
@@ -45,26 +50,40 @@ class Decoupled_FE {
   void conf_resolve_cf(Op* op) { conf->resolve_cf(op); }
   Off_Path_Reason eval_off_path_reason(Op* op);
   void print_conf_data() { conf->print_data(); }
+  void set_fetch_gated(bool gated);
 
  private:
   void init(uns proc_id);
+  FT& ftq_slot(uint64_t ft_pos) { return ftq[ft_pos & (ftq.size() - 1)]; }
+  void sync_iter(decoupled_fe_iter* iter);
 
   uns proc_id;
 
   // Per core fetch target queue:
-  // Each core has a queue of FTs,
-  // where each FT contains a queue of micro instructions.
-  std::deque<FT> ftq;
+  // Each core has a ring of FTs, where each FT contains a queue of micro instructions.
+  // FT positions are absolute (they only grow), the ring slot is the position modulo
+  // the ring size. FT objects in the ring are recycled so their op storage is reused.
+  std::vector<FT> ftq;
+  // absolute position of the oldest FT and one past the youngest FT
+  uint64_t ftq_head;
+  uint64_t ftq_tail;
+  // absolute flattened position of the first op of the oldest FT
+  uint64_t ftq_head_op;
+  // running count of the ops in the FTQ
+  uint64_t ftq_ops;
   // keep track of the current FT to be pushed next
   FT current_ft_to_push;
 
   int off_path;
   int sched_off_path;
   uint64_t dfe_op_count;
-  std::vector<decoupled_fe_iter> ftq_iterators;
+  // deque so that handed out iterator pointers stay valid
+  std::deque<decoupled_fe_iter> ftq_iterators;
   uint64_t recovery_addr;
   uint64_t redirect_cycle;
   bool stalled;
+  // no new fetch targets are started while gated (used to drain the pipeline)
+  bool fetch_gated;
   uint64_t ftq_ft_num;
   bool trace_mode;
   Op* cur_op;
@@ -132,14 +151,14 @@ Op* decoupled_fe_ftq_iter_get_next(decoupled_fe_iter* iter, bool* end_of_ft) {
    by advancing the iter and decremented by the icache consuming FTQ entries,
    and reset by flushes */
 uint64_t decoupled_fe_ftq_iter_offset(decoupled_fe_iter* iter) {
-  return iter->flattened_op_pos;
+  return dfe->ftq_iter_offset(iter);
 }
 
 /* Returns iter ft offset from the start of the FTQ, this offset gets incremented
    by advancing the iter and decremented by the icache consuming FTQ entries,
    and reset by flushes */
 uint64_t decoupled_fe_ftq_iter_ft_offset(decoupled_fe_iter* iter) {
-  return iter->ft_pos;
+  return dfe->ftq_iter_ft_offset(iter);
 }
 
 uint64_t decoupled_fe_ftq_num_ops() {
@@ -158,6 +177,10 @@ void decoupled_fe_set_ftq_num(uint64_t ftq_ft_num) {
   dfe->set_ftq_num(ftq_ft_num);
 }
 
+void decoupled_fe_gate_fetch(uns proc_id, Flag gated) {
+  per_core_dfe[proc_id].set_fetch_gated(gated);
+}
+
 uint64_t decoupled_fe_get_ftq_num() {
   return dfe->get_ftq_num();
 }
@@ -204,12 +227,23 @@ void Decoupled_FE::init(uns _proc_id) {
   recovery_addr = 0;
   redirect_cycle = 0;
   stalled = false;
+  fetch_gated = false;
   ftq_ft_num = FE_FTQ_BLOCK_NUM;
   cur_op = nullptr;
 
   current_ft_to_push = FT(proc_id);
   current_ft_to_push.set_ft_started_by(FT_STARTED_BY_APP);
 
+  // size the ring for the largest FTQ the adjustable FTQ (UFTQ) may request
+  uint64_t ftq_size = 1;
+  while (ftq_size < MAX2(FE_FTQ_BLOCK_NUM, UFTQ_MAX_FTQ_BLOCK_NUM))
+    ftq_size <<= 1;
+  ftq.assign(ftq_size, FT(proc_id));
+  ftq_head = 0;
+  ftq_tail = 0;
+  ftq_head_op = 0;
+  ftq_ops = 0;
+
   if (CONFIDENCE_ENABLE)
     conf = new Conf(_proc_id);
 }
@@ -220,10 +254,13 @@ void Decoupled_FE::recover() {
   cur_op = nullptr;
   recovery_addr = bp_recovery_info->recovery_fetch_addr;
 
-  for (auto it = ftq.begin(); it != ftq.end(); it++) {
-    it->free_ops_and_clear();
+  for (uint64_t ft_pos = ftq_head; ft_pos < ftq_tail; ft_pos++) {
+    ftq_slot(ft_pos).free_ops_and_clear();
   }
-  ftq.clear();
+  // iterators now point before the head and are moved to it lazily by sync_iter()
+  ftq_head = ftq_tail;
+  ftq_head_op += ftq_ops;
+  ftq_ops = 0;
 
   current_ft_to_push.free_ops_and_clear();
   current_ft_to_push.set_ft_started_by(FT_STARTED_BY_RECOVERY);
@@ -231,13 +268,6 @@ void Decoupled_FE::recover() {
   dfe_op_count = bp_recovery_info->recovery_op_num + 1;
   DEBUG(proc_id, "Recovery signalled fetch_addr0x:%llx\n", bp_recovery_info->recovery_fetch_addr);
 
-  for (auto it = ftq_iterators.begin(); it != ftq_iterators.end(); it++) {
-    // When the FTQ flushes, reset all iterators
-    it->ft_pos = 0;
-    it->op_pos = 0;
-    it->flattened_op_pos = 0;
-  }
-
   auto op = bp_recovery_info->recovery_op;
 
   if (stalled) {
@@ -272,6 +302,8 @@ void Decoupled_FE::update() {
   uint64_t bytes_this_cycle = 0;
   uint64_t cfs_taken_this_cycle = 0;
   static int fwd_progress = 0;
+  if (fetch_gated)
+    fwd_progress = 0;  // a gated frontend is not expected to fetch
   fwd_progress++;
   if (fwd_progress >= 100000) {
     std::cout << "No forward progress for 1000000 cycles" << std::endl;
@@ -292,6 +324,11 @@ void Decoupled_FE::update() {
     ASSERT(proc_id, ftq_num_fts() <= ftq_ft_num);
     ASSERT(proc_id, cfs_taken_this_cycle <= FE_FTQ_TAKEN_CFS_PER_CYCLE);
 
+    if (fetch_gated && current_ft_to_push.ops.empty()) {
+      DEBUG(proc_id, "Break due to gated fetch\n");
+      break;
+    }
+
     if (ftq_num_fts() == ftq_ft_num) {
       DEBUG(proc_id, "Break due to full FTQ\n");
       if (off_path)
@@ -445,12 +482,13 @@ void Decoupled_FE::update() {
                           current_ft_to_push.ops.size());
       ASSERT(proc_id, current_ft_to_push.ops.front()->bom && current_ft_to_push.ops.back()->eom);
       current_ft_to_push.set_per_op_ft_info();
-      if (!ftq.empty()) {
+      if (ftq_num_fts()) {
         // sanity check of consecutivity
-        Op* last_op = ftq.back().ops.back();
-        if (ftq.back().ft_info.dynamic_info.ended_by == FT_TAKEN_BRANCH) {
+        FT& last_ft = ftq_slot(ftq_tail - 1);
+        Op* last_op = last_ft.ops.back();
+        if (last_ft.ft_info.dynamic_info.ended_by == FT_TAKEN_BRANCH) {
           ASSERT(proc_id, last_op->oracle_info.pred_npc == current_ft_to_push.ft_info.static_info.start);
-        } else if (ftq.back().ft_info.dynamic_info.ended_by == FT_BAR_FETCH) {
+        } else if (last_ft.ft_info.dynamic_info.ended_by == FT_BAR_FETCH) {
           ASSERT(proc_id, last_op->oracle_info.pred_npc == current_ft_to_push.ft_info.static_info.start ||
                               last_op->inst_info->addr + last_op->inst_info->trace_info.inst_size ==
                                   current_ft_to_push.ft_info.static_info.start);
@@ -459,8 +497,12 @@ void Decoupled_FE::update() {
                               current_ft_to_push.ft_info.static_info.start);
         }
       }
-      ftq.emplace_back(current_ft_to_push);
-      current_ft_to_push = FT(proc_id);
+      // swap the new FT into the ring; the recycled slot (cleared when popped) becomes the next FT to push
+      FT& tail_ft = ftq_slot(ftq_tail);
+      ASSERT(proc_id, tail_ft.ops.empty() && !tail_ft.consumed);
+      std::swap(tail_ft, current_ft_to_push);
+      ftq_tail++;
+      ftq_ops += tail_ft.ops.size();
       if (ft_ended_by == FT_ICACHE_LINE_BOUNDARY) {
         current_ft_to_push.set_ft_started_by(FT_STARTED_BY_ICACHE_LINE_BOUNDARY);
       } else if (ft_ended_by == FT_TAKEN_BRANCH) {
@@ -489,88 +531,100 @@ void Decoupled_FE::update() {
   }
 }
 
+/* Gating finishes the fetch target being built and then stops fetching, so that a
+   gated frontend drains completely once the ops in flight retire */
+void Decoupled_FE::set_fetch_gated(bool gated) {
+  if (fetch_gated && !gated) {
+    // fetch resumes at an unrelated address after the simulation skipped ahead
+    cur_op = nullptr;
+    if (current_ft_to_push.ops.empty())
+      current_ft_to_push.set_ft_started_by(FT_STARTED_BY_APP);
+  }
+  fetch_gated = gated;
+}
+
 FT* Decoupled_FE::get_ft(uint64_t ft_pos) {
-  if (ft_pos < ftq.size()) {
-    return &ftq[ft_pos];
+  if (ft_pos < ftq_num_fts()) {
+    return &ftq_slot(ftq_head + ft_pos);
   } else {
     return NULL;
   }
 }
 
 void Decoupled_FE::pop_fts() {
-  while (!ftq.empty() && ftq.front().consumed) {
-    uint64_t ft_num_ops = ftq.front().ops.size();
-    ftq.front().free_ops_and_clear();
-    ftq.pop_front();
-    for (auto it = ftq_iterators.begin(); it != ftq_iterators.end(); it++) {
-      // When the icache consumes an FT decrement the iter's offset so it points to the same entry as before
-      if (it->ft_pos > 0) {
-        ASSERT(proc_id, it->flattened_op_pos >= ft_num_ops);
-        it->flattened_op_pos -= ft_num_ops;
-        it->ft_pos--;
-      } else {
-        ASSERT(proc_id, it->flattened_op_pos < ft_num_ops);
-        it->flattened_op_pos = 0;
-        it->op_pos = 0;
-      }
-    }
+  while (ftq_num_fts() && ftq_slot(ftq_head).consumed) {
+    FT& head_ft = ftq_slot(ftq_head);
+    uint64_t ft_num_ops = head_ft.ops.size();
+    head_ft.free_ops_and_clear();
+    ftq_head++;
+    ftq_head_op += ft_num_ops;
+    ASSERT(proc_id, ftq_ops >= ft_num_ops);
+    ftq_ops -= ft_num_ops;
+  }
+}
+
+/* Iterators hold absolute positions, so consuming or flushing FTs does not need to touch them. An iterator that
+   pointed into an FT that has since left the FTQ is moved to the first op of the oldest FT. */
+void Decoupled_FE::sync_iter(decoupled_fe_iter* iter) {
+  if (iter->ft_pos < ftq_head) {
+    iter->ft_pos = ftq_head;
+    iter->op_pos = 0;
+    iter->flattened_op_pos = ftq_head_op;
   }
+  ASSERT(proc_id, iter->ft_pos <= ftq_tail);
 }
 
 decoupled_fe_iter* Decoupled_FE::new_ftq_iter() {
-  ftq_iterators.push_back(decoupled_fe_iter());
+  ftq_iterators.push_back(decoupled_fe_iter{ftq_head, 0, ftq_head_op});
   return &(ftq_iterators.back());
 }
 
 Op* Decoupled_FE::ftq_iter_get(decoupled_fe_iter* iter, bool* end_of_ft) {
+  sync_iter(iter);
   // if FTQ is empty or if iter has seen all FTs
-  if (ftq.empty() || iter->ft_pos == ftq.size()) {
-    if (ftq.empty())
-      ASSERT(proc_id, iter->ft_pos == 0 && iter->op_pos == 0 && iter->flattened_op_pos == 0);
+  if (iter->ft_pos == ftq_tail) {
+    if (!ftq_num_fts())
+      ASSERT(proc_id, iter->op_pos == 0 && iter->flattened_op_pos == ftq_head_op);
     return NULL;
   }
 
-  ASSERT(proc_id, iter->ft_pos >= 0);
-  ASSERT(proc_id, iter->ft_pos < ftq.size());
-  ASSERT(proc_id, iter->op_pos >= 0);
-  ASSERT(proc_id, iter->op_pos < ftq.at(iter->ft_pos).ops.size());
-  *end_of_ft = iter->op_pos == ftq.at(iter->ft_pos).ops.size() - 1;
-  return ftq.at(iter->ft_pos).ops[iter->op_pos];
+  FT& ft = ftq_slot(iter->ft_pos);
+  ASSERT(proc_id, iter->op_pos < ft.ops.size());
+  *end_of_ft = iter->op_pos == ft.ops.size() - 1;
+  return ft.ops[iter->op_pos];
 }
 
 Op* Decoupled_FE::ftq_iter_get_next(decoupled_fe_iter* iter, bool* end_of_ft) {
-  if (iter->ft_pos + 1 == ftq.size() && iter->op_pos + 1 == ftq.at(iter->ft_pos).ops.size()) {
-    // if iter is at the last op and the last FT
-    iter->ft_pos += 1;
-    // at this moment iter is at the last FT
-    // but later FTQ will receive new FT
-    // so we prepare for that case by setting op_pos to zero
-    iter->op_pos = 0;
-    iter->flattened_op_pos++;
-    return NULL;
-  } else if (iter->ft_pos == ftq.size()) {
+  sync_iter(iter);
+  if (iter->ft_pos == ftq_tail) {
     // if iter has seen all FTs
     ASSERT(proc_id, iter->op_pos == 0);
     return NULL;
-  } else if (iter->op_pos + 1 == ftq.at(iter->ft_pos).ops.size()) {
-    // if iter is at the last op, but not the last FT
+  } else if (iter->op_pos + 1 == ftq_slot(iter->ft_pos).ops.size()) {
+    // if iter is at the last op of an FT move to the next FT.
+    // If this was the last FT the iter now points one past the FTQ;
+    // later the FTQ will receive a new FT which starts at op_pos zero
     iter->ft_pos += 1;
     iter->op_pos = 0;
     iter->flattened_op_pos++;
+    if (iter->ft_pos == ftq_tail)
+      return NULL;
   } else {
-    // if iter is not at the last op, nor the last FT
+    // if iter is not at the last op of an FT
     iter->op_pos++;
     iter->flattened_op_pos++;
   }
-  return decoupled_fe_ftq_iter_get(iter, end_of_ft);
+  return ftq_iter_get(iter, end_of_ft);
 }
 
-uint64_t Decoupled_FE::ftq_num_ops() {
-  uint64_t num_ops = 0;
-  for (auto it = ftq.begin(); it != ftq.end(); it++) {
-    num_ops += it->ops.size();
-  }
-  return num_ops;
+uint64_t Decoupled_FE::ftq_iter_offset(decoupled_fe_iter* iter) {
+  sync_iter(iter);
+  return iter->flattened_op_pos - ftq_head_op;
+}
+
+uint64_t Decoupled_FE::ftq_iter_ft_offset(decoupled_fe_iter* iter) {
+  sync_iter(iter);
+  return iter->ft_pos - ftq_head;
 }
 
 void Decoupled_FE::stall(Op* op) {
@@ -78,11 +78,12 @@ typedef struct FT FT;
 typedef struct decoupled_fe_iter decoupled_fe_iter;
 
 struct decoupled_fe_iter {
-  // the ft index
+  // the absolute ft position (use decoupled_fe_ftq_iter_ft_offset for the offset in the FTQ)
   uint64_t ft_pos;
-  // the op index
+  // the op index within the ft
   uint64_t op_pos;
-  // the flattened op index, as if the ftq is an 1-d array
+  // the absolute flattened op position, as if the ftq is an 1-d array
+  // (use decoupled_fe_ftq_iter_offset for the offset in the FTQ)
   uint64_t flattened_op_pos;
 };
 
@@ -118,6 +119,8 @@ uint64_t decoupled_fe_ftq_iter_ft_offset(decoupled_fe_iter* iter);
 uint64_t decoupled_fe_ftq_num_ops();
 uint64_t decoupled_fe_ftq_num_fts();
 void decoupled_fe_set_ftq_num(uint64_t ftq_ft_num);
+/* Stop (or resume) fetching new instructions into the FTQ of a core */
+void decoupled_fe_gate_fetch(uns proc_id, Flag gated);
 uint64_t decoupled_fe_get_ftq_num();
 Op* decoupled_fe_get_cur_op();
 uns decoupled_fe_get_conf();
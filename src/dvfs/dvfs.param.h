@@ -38,6 +38,11 @@
 #include "dvfs/dvfs.param.def"
 #undef DEF_PARAM
 
+/* In a frozen build (make opt-frozen) hot parameters are compile-time constants */
+#if defined(SCARAB_FROZEN_PARAMS) && !defined(SCARAB_PARAM_DEFINITIONS)
+#include "frozen.param.h"
+#endif
+
 /**************************************************************************************/
 
 #endif /* #ifndef __DVFS_PARAM_H__ */
@@ -73,14 +73,14 @@ Freq_Domain_Id FREQ_DOMAIN_MEMORY;
 /**************************************************************************************/
 /* Local prototypes */
 
+static void freq_param_cycle_times(uns* core_cycle_times, uns* l1_cycle_time);
 static Freq_Domain_Id freq_domain_create(char* name, uns cycle_time);
 
 /**************************************************************************************/
 /* Function definitions */
 
-void freq_init(void) {
-  char buf[MAX_STR_LENGTH + 1];
-  uns core_cycle_times[MAX_NUM_PROCS] = {
+static void freq_param_cycle_times(uns* core_cycle_times, uns* l1_cycle_time) {
+  const uns param_core_cycle_times[MAX_NUM_PROCS] = {
       CORE_0_CYCLE_TIME,  CORE_1_CYCLE_TIME,  CORE_2_CYCLE_TIME,  CORE_3_CYCLE_TIME,  CORE_4_CYCLE_TIME,
       CORE_5_CYCLE_TIME,  CORE_6_CYCLE_TIME,  CORE_7_CYCLE_TIME,  CORE_8_CYCLE_TIME,  CORE_9_CYCLE_TIME,
       CORE_10_CYCLE_TIME, CORE_11_CYCLE_TIME, CORE_12_CYCLE_TIME, CORE_13_CYCLE_TIME, CORE_14_CYCLE_TIME,
@@ -95,14 +95,18 @@ void freq_init(void) {
       CORE_55_CYCLE_TIME, CORE_56_CYCLE_TIME, CORE_57_CYCLE_TIME, CORE_58_CYCLE_TIME, CORE_59_CYCLE_TIME,
       CORE_60_CYCLE_TIME, CORE_61_CYCLE_TIME, CORE_62_CYCLE_TIME, CORE_63_CYCLE_TIME,
   };
-  uns l1_cycle_time = L1_CYCLE_TIME;
-  if (CHIP_CYCLE_TIME) {
+  for (int proc_id = 0; proc_id < MAX_NUM_PROCS; proc_id++) {
     // if CHIP_CYCLE_TIME is set, it overrides core and L1 cycle times
-    for (int proc_id = 0; proc_id < MAX_NUM_PROCS; proc_id++) {
-      core_cycle_times[proc_id] = CHIP_CYCLE_TIME;
-    }
-    l1_cycle_time = CHIP_CYCLE_TIME;
+    core_cycle_times[proc_id] = CHIP_CYCLE_TIME ? CHIP_CYCLE_TIME : param_core_cycle_times[proc_id];
   }
+  *l1_cycle_time = CHIP_CYCLE_TIME ? CHIP_CYCLE_TIME : L1_CYCLE_TIME;
+}
+
+void freq_init(void) {
+  char buf[MAX_STR_LENGTH + 1];
+  uns core_cycle_times[MAX_NUM_PROCS];
+  uns l1_cycle_time;
+  freq_param_cycle_times(core_cycle_times, &l1_cycle_time);
   for (int proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     sprintf(buf, "CORE_%d", proc_id);
     FREQ_DOMAIN_CORES[proc_id] = freq_domain_create(buf, core_cycle_times[proc_id]);
@@ -118,6 +122,18 @@ void freq_init(void) {
   GET_STAT_EVENT(0, PARAM_MEMORY_CYCLE_TIME) = RAMULATOR_TCK;
 }
 
+void freq_reload_cycle_times(void) {
+  uns core_cycle_times[MAX_NUM_PROCS];
+  uns l1_cycle_time;
+  freq_param_cycle_times(core_cycle_times, &l1_cycle_time);
+  for (int proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    freq_set_cycle_time(FREQ_DOMAIN_CORES[proc_id], core_cycle_times[proc_id]);
+    GET_STAT_EVENT(proc_id, PARAM_CORE_CYCLE_TIME) = core_cycle_times[proc_id];
+  }
+  freq_set_cycle_time(FREQ_DOMAIN_L1, l1_cycle_time);
+  GET_STAT_EVENT(0, PARAM_L1_CYCLE_TIME) = l1_cycle_time;
+}
+
 static Freq_Domain_Id freq_domain_create(char* name, uns cycle_time) {
   ASSERT(0, num_domains < MAX_FREQ_DOMAINS);
   ASSERT(0, cycle_time > 0);
@@ -189,6 +205,10 @@ Counter freq_time(void) {
   return cur_time;
 }
 
+void freq_set_time(Counter time) {
+  cur_time = time;
+}
+
 Counter freq_future_time(Freq_Domain_Id id, Counter cycles) {
   ASSERT(0, id < num_domains);
   ASSERT(0, domains[id].cycles <= cycles);
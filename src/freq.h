@@ -53,6 +53,10 @@ extern Freq_Domain_Id FREQ_DOMAIN_MEMORY;
 /* Initialize frequency domains */
 void freq_init(void);
 
+/* Re-reads the core and L1 cycle time parameters (e.g., after they
+   were overridden for a forked sweep configuration) */
+void freq_reload_cycle_times(void);
+
 /* Is the frequency domain ready to be simulated at this time (is its
    cycle starting at this exact time)? */
 Flag freq_is_ready(Freq_Domain_Id id);
@@ -70,6 +74,10 @@ Counter freq_cycle_count(Freq_Domain_Id id);
 /* Returns the current simulation time (in femtoseconds) */
 Counter freq_time(void);
 
+/* Sets the current simulation time (in femtoseconds), e.g. to the time
+   at which a restored warm-state checkpoint was taken */
+void freq_set_time(Counter time);
+
 /* Returns the future simulation time (in femtoseconds) when the
    specified domain reaches the specified cycle count (without
    changing its frequency) */
@@ -38,6 +38,7 @@
 #include "bp/bp.h"
 
 #include "frontend_intf.h"
+#include "host_profile.h"
 #include "icache_stage.h"
 #include "op.h"
 #include "pin_exec_driven_fe.h"
@@ -117,7 +118,7 @@ Flag frontend_can_fetch_op(uns proc_id) {
 }
 
 void frontend_fetch_op(uns proc_id, Op* op) {
-  frontend->fetch_op(proc_id, op);
+  HOST_PROFILE(FRONTEND_FETCH, frontend->fetch_op(proc_id, op));
   collect_op_stats(op);
 }
 
@@ -145,7 +145,7 @@ void pin_exec_driven_fetch_op(uns proc_id, Op* op) {
         ASSERT(proc_id, roi_dump_began);
         // dump stats
         printf("Reached roi dump end marker, dump stats between\n");
-        dump_stats(proc_id, TRUE, global_stat_array[proc_id], NUM_GLOBAL_STATS);
+        dump_stats(proc_id, TRUE, 0, NUM_GLOBAL_STATS);
         roi_dump_began = FALSE;
         roi_dump_ID++;
       }
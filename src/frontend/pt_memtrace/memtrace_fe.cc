@@ -226,7 +226,7 @@ int memtrace_trace_read(int proc_id, ctype_pin_inst* next_onpath_pi) {
     assert(roi_dump_began);
     // dump stats
     std::cout << "Reached roi dump end marker, dump stats between" << std::endl;
-    dump_stats(proc_id, TRUE, global_stat_array[proc_id], NUM_GLOBAL_STATS);
+    dump_stats(proc_id, TRUE, 0, NUM_GLOBAL_STATS);
     roi_dump_began = FALSE;
     roi_dump_ID++;
   }
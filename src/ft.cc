@@ -56,6 +56,7 @@ void FT::free_ops_and_clear() {
   ft_info.dynamic_info.started_by = FT_NOT_STARTED;
   ft_info.dynamic_info.ended_by = FT_NOT_ENDED;
   ft_info.dynamic_info.first_op_off_path = FALSE;
+  consumed = false;
 }
 
 bool FT::can_fetch_op() {
@@ -0,0 +1,139 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : host_profile.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Host-time self-profiler (see host_profile.h).
+ ***************************************************************************************/
+
+#include "host_profile.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_vars.h"
+
+#include "core.param.h"
+#include "general.param.h"
+
+/**************************************************************************************/
+/* Enums */
+
+DEFINE_ENUM(Host_Profile_Component, HOST_PROFILE_COMPONENT_LIST);
+
+/**************************************************************************************/
+/* Global Variables */
+
+Flag host_profile_sampling = FALSE;
+uns64 host_profile_ticks[HOST_PROFILE_NUM_ELEMS];
+
+static Counter num_cycles;  // simulation loop iterations since init
+static Counter num_sampled_cycles;
+static uns64 start_tsc;
+static uns64 start_ns;
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static uns64 wall_ns(void);
+
+/**************************************************************************************/
+/* host_profile_init: */
+
+void host_profile_init(void) {
+  if (!HOST_PROFILE)
+    return;
+#ifdef SCARAB_FROZEN_PARAMS
+  WARNINGU(0, "host_profile is compiled out of frozen builds, no profile is written\n");
+#else
+  ASSERTM(0, HOST_PROFILE_PERIOD > 0, "host_profile_period must be positive\n");
+  memset(host_profile_ticks, 0, sizeof(host_profile_ticks));
+  num_cycles = 0;
+  num_sampled_cycles = 0;
+  start_tsc = host_profile_tsc();
+  start_ns = wall_ns();
+#endif
+}
+
+/**************************************************************************************/
+/* host_profile_cycle: */
+
+void host_profile_cycle(void) {
+#ifndef SCARAB_FROZEN_PARAMS
+  if (!HOST_PROFILE)
+    return;
+  host_profile_sampling = num_cycles % HOST_PROFILE_PERIOD == 0;
+  num_sampled_cycles += host_profile_sampling;
+  num_cycles++;
+#endif
+}
+
+/**************************************************************************************/
+/* host_profile_done: */
+
+void host_profile_done(void) {
+#ifndef SCARAB_FROZEN_PARAMS
+  if (!HOST_PROFILE)
+    return;
+  host_profile_sampling = FALSE;
+
+  uns64 elapsed_ns = wall_ns() - start_ns;
+  uns64 elapsed_ticks = host_profile_tsc() - start_tsc;
+  double ns_per_tick = elapsed_ticks ? (double)elapsed_ns / elapsed_ticks : 0.0;
+  double scale = num_sampled_cycles ? (double)num_cycles / num_sampled_cycles : 0.0;
+
+  Counter insts = 0;
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++)
+    insts += inst_count[proc_id];
+
+  char buf[MAX_STR_LENGTH + 1];
+  snprintf(buf, MAX_STR_LENGTH + 1, "%s/%s%s", OUTPUT_DIR, FILE_TAG, HOST_PROFILE_FILE);
+  FILE* file = fopen(buf, "w");
+  ASSERTUM(0, file, "Couldn't open host profile file '%s'.\n", buf);
+
+  fprintf(file, "Host time:         %.3f s\n", elapsed_ns / 1e9);
+  fprintf(file, "Simulated cycles:  %lld (core 0)\n", cycle_count);
+  fprintf(file, "Instructions:      %lld (all cores)\n", insts);
+  fprintf(file, "Sampled cycles:    %lld of %lld (host_profile_period %u)\n", num_sampled_cycles, num_cycles,
+          HOST_PROFILE_PERIOD);
+  fprintf(file, "\n%-20s %15s %15s %10s\n", "Component", "ns/cycle", "ns/inst", "%cycle");
+  double cycle_ns = host_profile_ticks[HOST_PROFILE_CYCLE] * ns_per_tick * scale;
+  for (uns ii = 0; ii < HOST_PROFILE_NUM_ELEMS; ii++) {
+    double ns = host_profile_ticks[ii] * ns_per_tick * scale;
+    fprintf(file, "%-20s %15.2f %15.2f %10.2f\n", Host_Profile_Component_str(ii), cycle_count ? ns / cycle_count : 0.0,
+            insts ? ns / insts : 0.0, cycle_ns > 0 ? 100.0 * ns / cycle_ns : 0.0);
+  }
+  fclose(file);
+#endif
+}
+
+/**************************************************************************************/
+/* wall_ns: */
+
+static uns64 wall_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uns64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
@@ -0,0 +1,103 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : host_profile.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Host-time self-profiler (host_profile). Attributes the host time
+ *spent simulating to the components of the simulator by reading the time stamp
+ *counter around their calls, in every host_profile_period-th simulation cycle.
+ *
+ * Components nest: MEMORY includes RAMULATOR, DECOUPLED_FE includes
+ * FRONTEND_FETCH, and CYCLE is the whole simulation cycle. The profiler is
+ * compiled out of frozen builds (SCARAB_FROZEN_PARAMS).
+ ***************************************************************************************/
+
+#ifndef __HOST_PROFILE_H__
+#define __HOST_PROFILE_H__
+
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "globals/enum.h"
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Types */
+
+#define HOST_PROFILE_COMPONENT_LIST(elem)                                                                       \
+  elem(CYCLE) elem(MEMORY) elem(RAMULATOR) elem(DCACHE_STAGE) elem(EXEC_STAGE) elem(NODE_STAGE) elem(MAP_STAGE) \
+      elem(IDQ_STAGE) elem(UOP_QUEUE_STAGE) elem(DECODE_STAGE) elem(ICACHE_STAGE) elem(DECOUPLED_FE) elem(FDIP) \
+          elem(EIP) elem(NODE_SCHED) elem(FRONTEND_FETCH)
+
+DECLARE_ENUM(Host_Profile_Component, HOST_PROFILE_COMPONENT_LIST, HOST_PROFILE_);
+
+/**************************************************************************************/
+/* Global Variables */
+
+extern Flag host_profile_sampling;  // TRUE in the cycles that are being measured
+extern uns64 host_profile_ticks[HOST_PROFILE_NUM_ELEMS];
+
+/**************************************************************************************/
+/* Macros */
+
+/* Run call, adding its host time to component in the sampled cycles */
+#ifdef SCARAB_FROZEN_PARAMS
+#define HOST_PROFILE(component, call) call
+#else
+#define HOST_PROFILE(component, call)                                                          \
+  do {                                                                                         \
+    if (host_profile_sampling) {                                                               \
+      uns64 host_profile_start = host_profile_tsc();                                           \
+      call;                                                                                    \
+      host_profile_ticks[HOST_PROFILE_##component] += host_profile_tsc() - host_profile_start; \
+    } else {                                                                                   \
+      call;                                                                                    \
+    }                                                                                          \
+  } while (0)
+#endif
+
+/**************************************************************************************/
+/* Prototypes */
+
+static inline uns64 host_profile_tsc(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uns64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+/* Start profiling (called when timing simulation starts) */
+void host_profile_init(void);
+
+/* Decide whether the next simulation cycle is sampled */
+void host_profile_cycle(void);
+
+/* Write host_profile_file */
+void host_profile_done(void);
+
+#endif /* #ifndef __HOST_PROFILE_H__ */
@@ -29,42 +29,95 @@
 #include "libs/hash_lib.h"
 
 #include <stdlib.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "globals/assert.h"
 #include "globals/global_defs.h"
 #include "globals/global_types.h"
 #include "globals/global_vars.h"
+#include "globals/utils.h"
 
 #include "debug/debug.param.h"
 #include "debug/debug_macros.h"
 
-#include "libs/malloc_lib.h"
-
 /**************************************************************************************/
 /* Macros */
 
-#define DEBUG(args...) _DEBUG(DEBUG_HASH_LIB, ##args)
+#define DEBUG(args...) _DEBUG(0, DEBUG_HASH_LIB, ##args)
 
-int64 HASH_INDEX(const Hash_Table* table, int64 key);
-int64 HASH_INDEX(const Hash_Table* table, int64 key) {
-  int64_t mask = (~0UL) % table->buckets;
-  int64_t hash = 0;
-  int log2 = 64 - __builtin_clzl(table->buckets);
-  for (int i = 0; i < 64; i += log2) {
-    hash ^= (key & mask);
-    key = key >> log2;
-  }
+/* control bytes of the slots that hold no entry (full slots hold 7 bits of the hash) */
+#define CTRL_EMPTY 0x80
+#define CTRL_DELETED 0xfe
+
+/* a table grows when more than 7/8 of its slots are full or deleted */
+#define HASH_TABLE_MAX_FILL(slots) ((slots) - (slots) / 8)
+
+/* data blocks are carved from chunks of at least this many blocks */
+#define HASH_TABLE_MIN_CHUNK 16
+
+/**************************************************************************************/
+/* Prototypes */
+
+static inline uns64 hash_key(int64 key);
+static inline uns group_match(const uns8* ctrl, uns8 value);
+static inline uns group_match_free(const uns8* ctrl);
+static void hash_table_alloc_slots(Hash_Table* table, uns slots);
+static uns hash_table_find(Hash_Table const* table, int64 key, void const* data, uns64 hash);
+static uns hash_table_find_free(Hash_Table const* table, uns64 hash);
+static void* hash_table_insert(Hash_Table* table, int64 key, uns64 hash, void* data);
+static void hash_table_erase(Hash_Table* table, uns slot);
+static void* hash_table_alloc_data(Hash_Table* table);
+
+/**************************************************************************************/
+/* hash_key: mix all bits of the key (the 64-bit finalizer of MurmurHash3). The low
+   7 bits go to the control byte, the rest pick the first group to probe. */
+
+static inline uns64 hash_key(int64 key) {
+  uns64 hash = (uns64)key;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
   return hash;
 }
 
 /**************************************************************************************/
-// Global variables
+/* group_match: bit mask of the slots of a group whose control byte is value */
+
+static inline uns group_match(const uns8* ctrl, uns8 value) {
+#ifdef __SSE2__
+  __m128i group = _mm_load_si128((const __m128i*)ctrl);
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)value)));
+#else
+  uns mask = 0;
+  for (uns ii = 0; ii < HASH_TABLE_GROUP_SIZE; ii++)
+    mask |= (uns)(ctrl[ii] == value) << ii;
+  return mask;
+#endif
+}
 
-#define NUM_HASH_TABLE_PRIMES 12
-static uns const hash_table_primes[NUM_HASH_TABLE_PRIMES] = {1, 5, 11, 23, 47, 101, 211, 401, 811, 1601, 3209, 6373};
+/**************************************************************************************/
+/* group_match_free: bit mask of the empty and deleted slots of a group (the only
+   control bytes with the top bit set) */
+
+static inline uns group_match_free(const uns8* ctrl) {
+#ifdef __SSE2__
+  return _mm_movemask_epi8(_mm_load_si128((const __m128i*)ctrl));
+#else
+  uns mask = 0;
+  for (uns ii = 0; ii < HASH_TABLE_GROUP_SIZE; ii++)
+    mask |= (uns)(ctrl[ii] >> 7) << ii;
+  return mask;
+#endif
+}
 
 /**************************************************************************************/
-/* init_hash_table: */
+/* init_hash_table: buckets is the number of entries the table is expected to hold.
+   The table grows past it as needed. */
 
 void init_hash_table(Hash_Table* table, const char* name, uns buckets, uns data_size) {
   init_complex_hash_table(table, name, buckets, data_size, NULL);
@@ -72,12 +125,138 @@ void init_hash_table(Hash_Table* table, const char* name, uns buckets, uns data_
 
 void init_complex_hash_table(Hash_Table* table, const char* name, uns buckets, uns data_size,
                              Flag (*eq_func)(void const*, void const*)) {
+  uns slots = HASH_TABLE_GROUP_SIZE;
+  while (HASH_TABLE_MAX_FILL(slots) < buckets)
+    slots *= 2;
+
   table->name = strdup(name);
-  table->buckets = buckets;
   table->data_size = data_size;
   table->count = 0;
-  table->entries = (Hash_Table_Entry**)calloc(buckets, sizeof(Hash_Table_Entry*));
+  table->free_data = NULL;
+  table->data_chunks = NULL;
   table->eq_func = eq_func;
+  hash_table_alloc_slots(table, slots);
+}
+
+/**************************************************************************************/
+/* hash_table_alloc_slots: give the table new, empty slots */
+
+static void hash_table_alloc_slots(Hash_Table* table, uns slots) {
+  ASSERT(0, slots >= HASH_TABLE_GROUP_SIZE && !(slots & (slots - 1)));
+  table->buckets = slots;
+  table->growth_left = HASH_TABLE_MAX_FILL(slots);
+  void* ctrl;
+  if (posix_memalign(&ctrl, HASH_TABLE_GROUP_SIZE, slots))
+    FATAL_ERROR(0, "Could not allocate the control bytes of hash table %s\n", table->name);
+  table->ctrl = (uns8*)ctrl;
+  memset(table->ctrl, CTRL_EMPTY, slots);
+  table->entries = (Hash_Table_Entry*)malloc(slots * sizeof(Hash_Table_Entry));
+  ASSERT(0, table->entries);
+}
+
+/**************************************************************************************/
+/* hash_table_find: index of the slot that holds key (and data, if the table has an
+   eq_func), or table->buckets if there is none. Groups are probed in triangular
+   order, which visits every group once. An empty slot ends the search, as the key
+   would have been placed there. */
+
+static uns hash_table_find(Hash_Table const* table, int64 key, void const* data, uns64 hash) {
+  uns group_mask = table->buckets / HASH_TABLE_GROUP_SIZE - 1;
+  uns group = (hash >> 7) & group_mask;
+  uns8 h2 = hash & 0x7f;
+
+  for (uns step = 1;; step++) {
+    const uns8* ctrl = table->ctrl + group * HASH_TABLE_GROUP_SIZE;
+    for (uns match = group_match(ctrl, h2); match; match &= match - 1) {
+      uns slot = group * HASH_TABLE_GROUP_SIZE + __builtin_ctz(match);
+      Hash_Table_Entry* entry = &table->entries[slot];
+      if (entry->key == key && (!data || table->eq_func(entry->data, data)))
+        return slot;
+    }
+    if (group_match(ctrl, CTRL_EMPTY) || step > group_mask)
+      return table->buckets;
+    group = (group + step) & group_mask;
+  }
+}
+
+/**************************************************************************************/
+/* hash_table_find_free: index of the first empty or deleted slot on the probe
+   sequence of hash */
+
+static uns hash_table_find_free(Hash_Table const* table, uns64 hash) {
+  uns group_mask = table->buckets / HASH_TABLE_GROUP_SIZE - 1;
+  uns group = (hash >> 7) & group_mask;
+
+  for (uns step = 1;; step++) {
+    uns match = group_match_free(table->ctrl + group * HASH_TABLE_GROUP_SIZE);
+    if (match)
+      return group * HASH_TABLE_GROUP_SIZE + __builtin_ctz(match);
+    ASSERT(0, step <= group_mask);
+    group = (group + step) & group_mask;
+  }
+}
+
+/**************************************************************************************/
+/* hash_table_insert: add an entry for a key that is not in the table, growing the
+   table first if it is too full */
+
+static void* hash_table_insert(Hash_Table* table, int64 key, uns64 hash, void* data) {
+  uns slot = hash_table_find_free(table, hash);
+  if (table->growth_left == 0 && table->ctrl[slot] == CTRL_EMPTY) {
+    // double the table, or only drop the deleted slots if it is less than half full
+    hash_table_rehash(table, (uns)table->count >= HASH_TABLE_MAX_FILL(table->buckets) / 2 ? 2 * table->buckets
+                                                                                           : table->buckets);
+    slot = hash_table_find_free(table, hash);
+  }
+  if (table->ctrl[slot] == CTRL_EMPTY)
+    table->growth_left--;
+  table->ctrl[slot] = hash & 0x7f;
+  table->entries[slot].key = key;
+  table->entries[slot].data = data;
+  table->count++;
+  return data;
+}
+
+/**************************************************************************************/
+/* hash_table_erase: remove the entry of a slot. The slot can only become empty again
+   if its group still has an empty slot, since then no probe sequence has ever passed
+   the group. Otherwise it is marked deleted so that later lookups keep probing. */
+
+static void hash_table_erase(Hash_Table* table, uns slot) {
+  const uns8* ctrl = table->ctrl + slot / HASH_TABLE_GROUP_SIZE * HASH_TABLE_GROUP_SIZE;
+  if (group_match(ctrl, CTRL_EMPTY)) {
+    table->ctrl[slot] = CTRL_EMPTY;
+    table->growth_left++;
+  } else {
+    table->ctrl[slot] = CTRL_DELETED;
+  }
+  table->count--;
+  ASSERT(0, table->count >= 0);
+}
+
+/**************************************************************************************/
+/* hash_table_alloc_data: take a data block from the free list, carving a new chunk
+   (as large as the table has entries) when it is empty. Blocks are never returned to
+   the system before hash_table_clear, so they never move. */
+
+static void* hash_table_alloc_data(Hash_Table* table) {
+  if (!table->free_data) {
+    uns block_size = ROUND_UP(MAX2(table->data_size, (uns)sizeof(void*)), (uns)sizeof(void*));
+    uns num_blocks = MAX2(HASH_TABLE_MIN_CHUNK, table->count);
+    char* chunk = (char*)malloc(sizeof(void*) + (size_t)num_blocks * block_size);
+    ASSERT(0, chunk);
+    *(void**)chunk = table->data_chunks;
+    table->data_chunks = chunk;
+    for (uns ii = num_blocks; ii > 0; ii--) {
+      void* block = chunk + sizeof(void*) + (size_t)(ii - 1) * block_size;
+      *(void**)block = table->free_data;
+      table->free_data = block;
+    }
+    DEBUG("allocated %u data blocks for %s (%d entries)\n", num_blocks, table->name, table->count);
+  }
+  void* data = table->free_data;
+  table->free_data = *(void**)data;
+  return data;
 }
 
 /**************************************************************************************/
@@ -85,34 +264,15 @@ void init_complex_hash_table(Hash_Table* table, const char* name, uns buckets, u
    if it hits, NULL otherwise */
 
 void* hash_table_access(Hash_Table const* table, int64 key) {
-  // {{{ access hash table using simple key compare
-  uns index = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
-
-  for (temp = bucket; temp != NULL; temp = temp->next)
-    if (temp->key == key)
-      return temp->data;
-
-  return NULL;
-  // }}}
+  uns slot = hash_table_find(table, key, NULL, hash_key(key));
+  return slot < table->buckets ? table->entries[slot].data : NULL;
 }
 
 void* complex_hash_table_access(Hash_Table const* table, int64 key, void const* data) {
-  // {{{ access hash table using a complex comparison
-  uns index = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
-
   ASSERT(0, table->eq_func);
   ASSERT(0, data);
-
-  for (temp = bucket; temp != NULL; temp = temp->next)
-    if (temp->key == key && table->eq_func(temp->data, data))
-      return temp->data;
-
-  return NULL;
-  // }}}
+  uns slot = hash_table_find(table, key, data, hash_key(key));
+  return slot < table->buckets ? table->entries[slot].data : NULL;
 }
 
 /**************************************************************************************/
@@ -121,80 +281,23 @@ void* complex_hash_table_access(Hash_Table const* table, int64 key, void const*
    entry and return its data pointer. */
 
 void* hash_table_access_create(Hash_Table* table, int64 key, Flag* new_entry) {
-  // {{{ access hash table using simple key compare
-  uns index = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* new_hash = NULL;
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
-
-  *new_entry = FALSE;
-  ASSERT(0, index < table->buckets);
-  for (temp = bucket; temp != NULL; temp = temp->next) {
-    if (temp->key == key)
-      return temp->data;
-    else
-      prev = temp;
-  }
-  table->count++;
-  *new_entry = TRUE;
-  new_hash = (Hash_Table_Entry*)smalloc(sizeof(Hash_Table_Entry));
-  ASSERT(0, new_hash);
-  new_hash->key = key;
-  new_hash->next = NULL;
-  new_hash->data = (void*)smalloc(table->data_size);
-  ASSERT(0, new_hash->data);
-
-  if (prev)
-    prev->next = new_hash;
-  else
-    table->entries[index] = new_hash;
-
-  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n",
-          (unsigned long int)sizeof(Hash_Table_Entry) + table->data_size, table->name, table->count);
-
-  return new_hash->data;
-  // }}}
+  uns64 hash = hash_key(key);
+  uns slot = hash_table_find(table, key, NULL, hash);
+  *new_entry = slot == table->buckets;
+  if (!*new_entry)
+    return table->entries[slot].data;
+  return hash_table_insert(table, key, hash, hash_table_alloc_data(table));
 }
 
 void* complex_hash_table_access_create(Hash_Table* table, int64 key, void const* data, Flag* new_entry) {
-  // {{{ access hash table using a complex comparison
-  uns index = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* new_hash = NULL;
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
-
   ASSERT(0, table->eq_func);
   ASSERT(0, data);
-
-  *new_entry = FALSE;
-  ASSERT(0, index < table->buckets);
-  for (temp = bucket; temp != NULL; temp = temp->next) {
-    if (temp->key == key && table->eq_func(temp->data, data))
-      return temp->data;
-    else
-      prev = temp;
-  }
-  table->count++;
-  *new_entry = TRUE;
-  new_hash = (Hash_Table_Entry*)smalloc(sizeof(Hash_Table_Entry));
-  ASSERT(0, new_hash);
-  new_hash->key = key;
-  new_hash->next = NULL;
-  new_hash->data = (void*)smalloc(table->data_size);
-  ASSERT(0, new_hash->data);
-
-  if (prev)
-    prev->next = new_hash;
-  else
-    table->entries[index] = new_hash;
-
-  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n",
-          (unsigned long int)sizeof(Hash_Table_Entry) + table->data_size, table->name, table->count);
-
-  return new_hash->data;
-  // }}}
+  uns64 hash = hash_key(key);
+  uns slot = hash_table_find(table, key, data, hash);
+  *new_entry = slot == table->buckets;
+  if (!*new_entry)
+    return table->entries[slot].data;
+  return hash_table_insert(table, key, hash, hash_table_alloc_data(table));
 }
 
 /**************************************************************************************/
@@ -202,83 +305,41 @@ void* complex_hash_table_access_create(Hash_Table* table, int64 key, void const*
    TRUE if it was found, FALSE otherwise */
 
 Flag hash_table_access_delete(Hash_Table* table, int64 key) {
-  // {{{ access hash table using simple key compare
-  uns index = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
-
-  for (temp = bucket; temp != NULL; temp = temp->next) {
-    if (temp->key == key) {
-      Hash_Table_Entry* next_ptr = temp->next;
-      sfree(table->data_size, temp->data);
-      sfree(sizeof(Hash_Table_Entry), temp);
-      if (prev)
-        prev->next = next_ptr;
-      else
-        table->entries[index] = next_ptr;
-      table->count--;
-      ASSERT(0, table->count >= 0);
-      return TRUE;
-    } else
-      prev = temp;
-  }
-
-  return FALSE;
-  // }}}
+  uns slot = hash_table_find(table, key, NULL, hash_key(key));
+  if (slot == table->buckets)
+    return FALSE;
+  void* data = table->entries[slot].data;
+  *(void**)data = table->free_data;
+  table->free_data = data;
+  hash_table_erase(table, slot);
+  return TRUE;
 }
 
 Flag complex_hash_table_access_delete(Hash_Table* table, int64 key, void const* data) {
-  // {{{ access hash table using a complex comparison
-  uns index = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
-
   ASSERT(0, table->eq_func);
   ASSERT(0, data);
-
-  for (temp = bucket; temp != NULL; temp = temp->next) {
-    if (temp->key == key && table->eq_func(temp->data, data)) {
-      Hash_Table_Entry* next_ptr = temp->next;
-      sfree(table->data_size, temp->data);
-      sfree(sizeof(Hash_Table_Entry), temp);
-      if (prev)
-        prev->next = next_ptr;
-      else
-        table->entries[index] = next_ptr;
-      table->count--;
-      ASSERT(0, table->count >= 0);
-      return TRUE;
-    } else
-      prev = temp;
-  }
-
-  return FALSE;
-  // }}}
+  uns slot = hash_table_find(table, key, data, hash_key(key));
+  if (slot == table->buckets)
+    return FALSE;
+  void* entry_data = table->entries[slot].data;
+  *(void**)entry_data = table->free_data;
+  table->free_data = entry_data;
+  hash_table_erase(table, slot);
+  return TRUE;
 }
 
 /**************************************************************************************/
-/* hash_table_clear: */
+/* hash_table_clear: delete every entry and release the data blocks */
 
 void hash_table_clear(Hash_Table* table) {
-  Hash_Table_Entry* temp0;
-  Hash_Table_Entry* temp1;
-  uns count = 0;
-  int ii;
-
-  for (ii = 0; ii < table->buckets; ii++) {
-    temp0 = table->entries[ii];
-    while (temp0) {
-      temp1 = temp0->next;
-      sfree(table->data_size, temp0->data);
-      sfree(sizeof(Hash_Table_Entry), temp0);
-      temp0 = temp1;
-      count++;
-    }
-    table->entries[ii] = NULL;
+  while (table->data_chunks) {
+    void* next = *(void**)table->data_chunks;
+    free(table->data_chunks);
+    table->data_chunks = next;
   }
-  ASSERT(0, count == table->count);
+  table->free_data = NULL;
+  memset(table->ctrl, CTRL_EMPTY, table->buckets);
+  table->growth_left = HASH_TABLE_MAX_FILL(table->buckets);
   table->count = 0;
 }
 
@@ -288,10 +349,8 @@ void hash_table_clear(Hash_Table* table) {
  */
 
 void** hash_table_flatten(Hash_Table* table, void** reuse_array) {
-  Hash_Table_Entry* temp;
   void** new_array;
-  uns count = 0;
-  int ii;
+  int count = 0;
 
   if (table->count == 0)
     return NULL;
@@ -304,17 +363,11 @@ void** hash_table_flatten(Hash_Table* table, void** reuse_array) {
   }
 
   /* write into the new array */
-  count = 0;
-  for (ii = 0; ii < table->buckets; ii++) {
-    temp = table->entries[ii];
-    while (temp) {
-      new_array[count++] = temp->data;
-      temp = temp->next;
-    }
-  }
+  for (uns ii = 0; ii < table->buckets; ii++)
+    if (!(table->ctrl[ii] & CTRL_EMPTY))
+      new_array[count++] = table->entries[ii].data;
 
   ASSERTM(0, count == table->count, "%d %d\n", count, table->count);
-  ASSERTM(0, count > 0, "%d %d\n", count, table->count);
 
   return new_array;
 }
@@ -325,73 +378,50 @@ void** hash_table_flatten(Hash_Table* table, void** reuse_array) {
 
 void hash_table_scan(Hash_Table* table, void (*scan_func)(void*, void*), void* arg) {
   int count = 0;
-  Hash_Table_Entry* temp;
-  int ii;
 
   ASSERT(0, scan_func);
 
   if (table->count == 0)
     return;
 
-  for (ii = 0; ii < table->buckets; ii++) {
-    temp = table->entries[ii];
-    while (temp) {
+  for (uns ii = 0; ii < table->buckets; ii++) {
+    if (!(table->ctrl[ii] & CTRL_EMPTY)) {
       count++;
-      scan_func(temp->data, arg);
-      temp = temp->next;
+      scan_func(table->entries[ii].data, arg);
     }
   }
   ASSERT(0, count == table->count);
 }
 
 /**************************************************************************************/
-// hash_table_rehash: expand or contract the hash table
-// WARNING: this hasn't really been tested
+// hash_table_rehash: move the entries into new_buckets slots (rounded up to a power
+// of 2 that fits them), or into twice as many slots if new_buckets is 0. This also
+// drops the deleted slots. The data of the entries does not move.
 
 void hash_table_rehash(Hash_Table* table, int new_buckets) {
-  Hash_Table_Entry** new_entries;
-  Hash_Table_Entry** flat_entries;
-  Hash_Table_Entry** old_entries = table->entries;
+  uns8* old_ctrl = table->ctrl;
+  Hash_Table_Entry* old_entries = table->entries;
   uns old_buckets = table->buckets;
-  Hash_Table_Entry* temp;
-  uns ii, jj;
 
   ASSERT(0, new_buckets >= 0);
-  if (new_buckets == 0) {  // use next prime
-    new_buckets = table->buckets;
-    for (ii = 0; ii < NUM_HASH_TABLE_PRIMES - 1; ii++)
-      if (hash_table_primes[ii] == old_buckets) {
-        new_buckets = hash_table_primes[ii + 1];
-        break;
-      }
+  uns slots = new_buckets ? HASH_TABLE_GROUP_SIZE : 2 * old_buckets;
+  while (slots < (uns)new_buckets || HASH_TABLE_MAX_FILL(slots) < (uns)table->count)
+    slots *= 2;
+
+  hash_table_alloc_slots(table, slots);
+  for (uns ii = 0; ii < old_buckets; ii++) {
+    if (!(old_ctrl[ii] & CTRL_EMPTY)) {
+      uns64 hash = hash_key(old_entries[ii].key);
+      uns slot = hash_table_find_free(table, hash);
+      table->ctrl[slot] = hash & 0x7f;
+      table->entries[slot] = old_entries[ii];
+      table->growth_left--;
+    }
   }
-  if (new_buckets == old_buckets)
-    return;
+  DEBUG("rehashed %s from %u to %u slots (%d entries)\n", table->name, old_buckets, slots, table->count);
 
-  // flatten hash table into an array of entries
-  flat_entries = (Hash_Table_Entry**)malloc(table->count * sizeof(Hash_Table_Entry*));
-  for (ii = 0, jj = 0; ii < old_buckets; ii++)
-    for (temp = old_entries[ii]; temp; temp = temp->next)
-      flat_entries[jj++] = temp;
-  ASSERT(0, jj == table->count);
-
-  // replace old with new and free the old entry array
-  new_entries = (Hash_Table_Entry**)calloc(new_buckets, sizeof(Hash_Table_Entry*));
-  ASSERT(0, new_entries);
-  ASSERT(0, new_buckets > 0 && new_buckets < 100000);
-  table->buckets = new_buckets;
-  table->entries = new_entries;
+  free(old_ctrl);
   free(old_entries);
-
-  // insert each element
-  for (ii = 0; ii < table->count; ii++) {
-    Hash_Table_Entry* temp = flat_entries[ii];
-    uns index = HASH_INDEX(table, temp->key);
-    temp->next = table->entries[index];
-    table->entries[index] = temp;
-  }
-
-  free(flat_entries);
 }
 
 /**************************************************************************************/
@@ -399,41 +429,14 @@ void hash_table_rehash(Hash_Table* table, int new_buckets) {
 // it
 //                            if it doesn't exist yet
 void hash_table_access_replace(Hash_Table* table, int64 key, void* replacement) {
-  // {{{ access hash table using simple key compare
-  uns index = HASH_INDEX(table, key);
-  Hash_Table_Entry* bucket = table->entries[index];
-  Hash_Table_Entry* new_hash = NULL;
-  Hash_Table_Entry* temp;
-  Hash_Table_Entry* prev = NULL;
-  Flag new_entry = FALSE;
-  UNUSED(new_entry);
   ASSERT(0, replacement);
-  ASSERT(0, index < table->buckets);
-  for (temp = bucket; temp != NULL; temp = temp->next) {
-    if (temp->key == key) {
-      /* May not want to free the memory in case there are other valid pointers
-         to it. ASSERT(0,temp->data); free(table->data_size, temp->data);
-      */
-      temp->data = replacement;
-      return;
-    } else {
-      prev = temp;
-    }
+  uns64 hash = hash_key(key);
+  uns slot = hash_table_find(table, key, NULL, hash);
+  if (slot < table->buckets) {
+    /* May not want to free the memory in case there are other valid pointers
+       to it. */
+    table->entries[slot].data = replacement;
+    return;
   }
-  table->count++;
-  new_entry = TRUE;
-  new_hash = (Hash_Table_Entry*)smalloc(sizeof(Hash_Table_Entry));
-  ASSERT(0, new_hash);
-  new_hash->key = key;
-  new_hash->next = NULL;
-  new_hash->data = replacement;
-
-  if (prev)
-    prev->next = new_hash;
-  else
-    table->entries[index] = new_hash;
-
-  _DEBUGA(0, 0, "smalloc'd %ld bytes for %s (%d entries)\n", (unsigned long int)sizeof(Hash_Table_Entry), table->name,
-          table->count);
-  // }}}
+  hash_table_insert(table, key, hash, replacement);
 }
@@ -35,18 +35,30 @@
 /**************************************************************************************/
 /* Types */
 
+/* The table is open addressed: entries are stored in groups of
+   HASH_TABLE_GROUP_SIZE slots, with one control byte per slot that holds 7 bits of
+   the key's hash (or marks the slot empty or deleted). A lookup compares the control
+   bytes of a whole group at once and only reads the keys whose hash bits match. The
+   data of the entries is carved out of chunks that never move, so data pointers stay
+   valid until their entry is deleted, even when the table grows. */
+
+#define HASH_TABLE_GROUP_SIZE 16
+
 typedef struct Hash_Table_Entry_struct {
   int64 key;
   void* data;
-  struct Hash_Table_Entry_struct* next;
 } Hash_Table_Entry;
 
 typedef struct Hash_Table_struct {
   char* name;
-  uns buckets;
+  uns buckets;  // number of slots, a power of 2 (at least HASH_TABLE_GROUP_SIZE)
   uns data_size;
-  int count;  // total number of elements in the hash table
-  Hash_Table_Entry** entries;
+  int count;          // total number of elements in the hash table
+  uns growth_left;    // empty slots that can be filled before the table has to grow
+  uns8* ctrl;         // control byte of each slot
+  Hash_Table_Entry* entries;
+  void* free_data;    // list of unused data blocks
+  void* data_chunks;  // list of the chunks the data blocks are carved from
   Flag (*eq_func)(void const* const, void const* const);
 } Hash_Table;
 
@@ -271,6 +271,18 @@ int main(int argc, char* argv[], char* envp[]) {
     case FULL_SIM_MODE:
       full_sim();
       break;
+    case SAMPLING_SIM_MODE:
+      sampling_sim();
+      break;
+    case SIMPOINT_SIM_MODE:
+      simpoint_sim();
+      break;
+    case BP_ONLY_SIM_MODE:
+      bp_only_sim();
+      break;
+    case CACHE_STUDY_SIM_MODE:
+      cache_study_sim();
+      break;
 #ifdef ENABLE_PT_MEMTRACE
     case TRACE_BBV_MODE:
     case TRACE_BBV_DISTRIBUTED_MODE:
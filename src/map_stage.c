@@ -86,7 +86,6 @@ void set_map_stage(Map_Stage* new_map) {
 /* init_map_stage: */
 
 void init_map_stage(uns8 proc_id, const char* name) {
-  char tmp_name[MAX_STR_LENGTH + 1];
   uns ii;
   ASSERT(proc_id, map);
   ASSERT(proc_id, STAGE_MAX_DEPTH > 0);
@@ -95,15 +94,14 @@ void init_map_stage(uns8 proc_id, const char* name) {
   memset(map, 0, sizeof(Map_Stage));
   map->proc_id = proc_id;
 
-  map->sds = (Stage_Data*)malloc(sizeof(Stage_Data) * STAGE_MAX_DEPTH);
+  map->latches.sds = (Stage_Data*)malloc(sizeof(Stage_Data) * STAGE_MAX_DEPTH);
+  map->latches.depth = STAGE_MAX_DEPTH;
   for (ii = 0; ii < STAGE_MAX_DEPTH; ii++) {
-    Stage_Data* cur = &map->sds[ii];
-    snprintf(tmp_name, MAX_STR_LENGTH, "%s %d", name, STAGE_MAX_DEPTH - ii - 1);
-    cur->name = (char*)strdup(tmp_name);
+    Stage_Data* cur = &map->latches.sds[ii];
+    cur->name = (char*)strdup(name);
     cur->max_op_count = STAGE_MAX_OP_COUNT;
     cur->ops = (Op**)malloc(sizeof(Op*) * STAGE_MAX_OP_COUNT);
   }
-  map->last_sd = &map->sds[0];
   reset_map_stage();
 }
 
@@ -114,11 +112,13 @@ void reset_map_stage() {
   uns ii, jj;
   ASSERT(0, map);
   for (ii = 0; ii < STAGE_MAX_DEPTH; ii++) {
-    Stage_Data* cur = &map->sds[ii];
+    Stage_Data* cur = &map->latches.sds[ii];
     cur->op_count = 0;
     for (jj = 0; jj < STAGE_MAX_OP_COUNT; jj++)
       cur->ops[jj] = NULL;
   }
+  map->latches.head = 0;
+  map->last_sd = stage_latches_get(&map->latches, 0);
 }
 
 /**************************************************************************************/
@@ -129,7 +129,7 @@ void recover_map_stage() {
   map_off_path = 0;
   ASSERT(0, map);
   for (ii = 0; ii < STAGE_MAX_DEPTH; ii++) {
-    Stage_Data* cur = &map->sds[ii];
+    Stage_Data* cur = &map->latches.sds[ii];
     cur->op_count = 0;
 
     for (jj = 0, kk = 0; jj < STAGE_MAX_OP_COUNT; jj++) {
@@ -159,8 +159,8 @@ void recover_map_stage() {
 void debug_map_stage() {
   uns ii;
   for (ii = 0; ii < STAGE_MAX_DEPTH; ii++) {
-    Stage_Data* cur = &map->sds[STAGE_MAX_DEPTH - ii - 1];
-    DPRINTF("# %-10s  op_count:%d\n", cur->name, cur->op_count);
+    Stage_Data* cur = stage_latches_get(&map->latches, STAGE_MAX_DEPTH - ii - 1);
+    DPRINTF("# %s %-3d  op_count:%d\n", cur->name, STAGE_MAX_DEPTH - ii - 1, cur->op_count);
     print_op_array(GLOBAL_DEBUG_STREAM, cur->ops, STAGE_MAX_OP_COUNT, STAGE_MAX_OP_COUNT);
   }
 }
@@ -181,22 +181,11 @@ void update_map_stage(Stage_Data* src_sd) {
   map_stage_collect_stat(stall, starved);
 
   /* do all the intermediate stages */
-  for (int ii = 0; ii < STAGE_MAX_DEPTH - 1; ii++) {
-    Stage_Data* cur = &map->sds[ii];
-    Stage_Data* prev = &map->sds[ii + 1];
-
-    if (cur->op_count)
-      continue;
-
-    Op** temp = cur->ops;
-    cur->ops = prev->ops;
-    prev->ops = temp;
-    cur->op_count = prev->op_count;
-    prev->op_count = 0;
-  }
+  stage_latches_advance(&map->latches);
+  map->last_sd = stage_latches_get(&map->latches, 0);
 
   /* do the first map stage */
-  if (map->sds[STAGE_MAX_DEPTH - 1].op_count == 0 && !starved) {
+  if (stage_latches_get(&map->latches, STAGE_MAX_DEPTH - 1)->op_count == 0 && !starved) {
     map_stage_fetch_op(src_sd);
   }
 
@@ -252,21 +241,19 @@ static inline void map_stage_collect_stat(Flag stall, Flag starved) {
 }
 
 static inline void map_stage_fetch_op(Stage_Data* src_sd) {
-  Stage_Data* first_sd = &map->sds[STAGE_MAX_DEPTH - 1];
-  int op_count_before_fetch = src_sd->op_count;
+  Stage_Data* first_sd = stage_latches_get(&map->latches, STAGE_MAX_DEPTH - 1);
+
+  /* the IDQ packs its output from slot 0 and the first map latch is empty, so all the
+     ops move over with the op arrays */
+  ASSERT(map->proc_id, first_sd->max_op_count == src_sd->max_op_count);
+  stage_data_hand_off(first_sd, src_sd);
 
-  for (int ii = 0; ii < op_count_before_fetch; ii++) {
-    Op* op = src_sd->ops[ii];
+  for (int ii = 0; ii < first_sd->op_count; ii++) {
+    Op* op = first_sd->ops[ii];
     ASSERT(map->proc_id, op->op_num == map_stage_next_op_num);
     DEBUG(map->proc_id, "Fetching opnum=%llu at idx=%i\n", op->op_num, ii);
 
     op->map_cycle = cycle_count;
-    first_sd->ops[ii] = op;
-    first_sd->op_count++;
-
-    src_sd->ops[ii] = NULL;
-    src_sd->op_count--;
-
     map_stage_next_op_num++;
     if (op->off_path) {
       map_off_path = 1;
@@ -37,8 +37,8 @@
 
 typedef struct Map_Stage_struct {
   uns proc_id;
-  Stage_Data* sds;     /* stage interface data (dynamically allocated number of pipe stages) */
-  Stage_Data* last_sd; /* pointer to last decode pipeline stage (for passing ops to map) */
+  Stage_Latches latches; /* stage interface data (dynamically allocated number of pipe stages) */
+  Stage_Data*   last_sd; /* pointer to last map pipeline stage (for passing ops to node) */
 } Map_Stage;
 
 /**************************************************************************************/
@@ -50,6 +50,7 @@
 /* Macros */
 
 #define DEBUG(proc_id, args...) _DEBUG(proc_id, DEBUG_CACHE_PART, ##args)
+#define DP_IDX(cores, ways) ((cores) * (L1_ASSOC + 1) + (ways))
 
 /**************************************************************************************/
 /* Types */
@@ -59,11 +60,7 @@ typedef struct Proc_Info_struct {
   double* miss_rates;  // indexed by number of ways - 1
 } Proc_Info;
 
-typedef struct Shadow_Cache_Data_struct {
-  Flag prefetched;
-} Shadow_Cache_Data;
-
-typedef double (*Metric_Func)(uns*);
+typedef double (*Metric_Term_Func)(uns proc_id, uns ways);
 typedef void (*Search_Func)(void);
 
 /**************************************************************************************/
@@ -74,13 +71,25 @@ Trigger* l1_part_start;    // indicates the L1 partition has been enabled
 Trigger* l1_part_trigger;  // external trigger for trigger repart (should not be
                            // set too often)
 Stat_Mon* stat_mon;
-Metric_Func metric_func;
+Metric_Term_Func metric_term_func;  // the metric of one core given its ways
+Flag metric_is_product;             // the metric multiplies the terms of the cores (sums otherwise)
 Search_Func search_func;
 uns* current_partition;  // actual enforced partition
 uns* new_partition;      // pre-allocated structure for new partition
 uns* temp_partition;     // pre-allocated structure for partition exploration
 uns tie_breaker_proc_id;
 
+// UMON set sampling: only the L1 sets that are a multiple of shadow_modulo are
+// monitored, and the shadow caches only have those (shadow_sets) sets
+static uns l1_sets;
+static uns shadow_modulo;
+static uns shadow_sets;
+
+// dynamic programming search tables, indexed by [cores][ways] (see DP_IDX)
+static double* dp_metric;
+static uns* dp_ways;
+static double* dp_terms;
+
 /**************************************************************************************/
 /* Enums */
 
@@ -91,13 +100,16 @@ DEFINE_ENUM(Cache_Part_Search, CACHE_PART_SEARCH_LIST);
 /* Local Prototypes */
 
 static Flag in_shadow_cache(Addr addr);
-static double get_global_miss_rate(uns* partition);
-static double get_miss_rate_sum(uns* partition);
-static double get_gmean_perf(uns* partition);
+static Addr get_shadow_addr(Addr addr);
+static double get_metric(uns* partition);
+static double get_global_miss_rate(uns proc_id, uns ways);
+static double get_miss_rate(uns proc_id, uns ways);
+static double get_gmean_perf(uns proc_id, uns ways);
 static double get_best_marginal_utility(uns* partition, uns proc_id, uns balance, uns* extra_ways);
 static void measure_miss_curves(void);
 static void search_lookahead(void);
 static void search_bruteforce(void);
+static void search_dynamic_prog(void);
 static void set_partition(void);
 static void debug_cache_part(uns* old_partition, uns* new_partition);
 
@@ -114,14 +126,28 @@ void cache_part_init(void) {
   ASSERT(0, L1_CACHE_REPL_POLICY == REPL_PARTITION);
   ASSERT(0, L1_ASSOC <= 128);
 
+  // pick the sampled sets
+  l1_sets = L1_SIZE / L1_LINE_SIZE / L1_ASSOC;
+  if (L1_SHADOW_SAMPLED_SETS) {
+    ASSERTM(0, L1_SHADOW_SAMPLED_SETS <= l1_sets && l1_sets % L1_SHADOW_SAMPLED_SETS == 0,
+            "L1_SHADOW_SAMPLED_SETS (%d) must divide the number of L1 sets (%d)\n", L1_SHADOW_SAMPLED_SETS, l1_sets);
+    shadow_modulo = l1_sets / L1_SHADOW_SAMPLED_SETS;
+  } else {
+    shadow_modulo = L1_SHADOW_TAGS_MODULO;
+  }
+  ASSERTM(0, shadow_modulo && !(shadow_modulo & (shadow_modulo - 1)) && l1_sets % shadow_modulo == 0,
+          "The shadow tag sampling interval (%d) must be a power of two that divides the L1 sets (%d)\n",
+          shadow_modulo, l1_sets);
+  shadow_sets = l1_sets / shadow_modulo;
+
   // create shadow cache for each core
   proc_infos = calloc(NUM_CORES, sizeof(Proc_Info));
   for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     Proc_Info* proc_info = &proc_infos[proc_id];
     char buf[MAX_STR_LENGTH + 1];
     sprintf(buf, "SHADOW L1[%d]", proc_id);
-    init_cache(&proc_info->shadow_cache, buf, L1_SIZE, L1_ASSOC, L1_LINE_SIZE, sizeof(Shadow_Cache_Data),
-               REPL_TRUE_LRU);
+    init_cache(&proc_info->shadow_cache, buf, shadow_sets * L1_ASSOC * L1_LINE_SIZE, L1_ASSOC, L1_LINE_SIZE,
+               sizeof(L1_Data), REPL_TRUE_LRU);
     proc_info->miss_rates = calloc(L1_ASSOC, sizeof(double));
   }
 
@@ -393,15 +419,17 @@ void cache_part_init(void) {
   // counting periodically
   stat_mon = stat_mon_create_from_array(monitored_stats, NUM_ELEMENTS(monitored_stats));
 
+  metric_is_product = FALSE;
   switch (L1_PART_METRIC) {
     case CACHE_PART_METRIC_GLOBAL_MISS_RATE:
-      metric_func = &get_global_miss_rate;
+      metric_term_func = &get_global_miss_rate;
       break;
     case CACHE_PART_METRIC_MISS_RATE_SUM:
-      metric_func = &get_miss_rate_sum;
+      metric_term_func = &get_miss_rate;
       break;
     case CACHE_PART_METRIC_GMEAN_PERF:
-      metric_func = &get_gmean_perf;
+      metric_term_func = &get_gmean_perf;
+      metric_is_product = TRUE;
       break;
     default:
       FATAL_ERROR(0, "Unknown metric %s\n", Cache_Part_Metric_str(L1_PART_METRIC));
@@ -415,6 +443,12 @@ void cache_part_init(void) {
     case CACHE_PART_SEARCH_BRUTE_FORCE:
       search_func = &search_bruteforce;
       break;
+    case CACHE_PART_SEARCH_DYNAMIC_PROG:
+      search_func = &search_dynamic_prog;
+      dp_metric = calloc((NUM_CORES + 1) * (L1_ASSOC + 1), sizeof(double));
+      dp_ways = calloc((NUM_CORES + 1) * (L1_ASSOC + 1), sizeof(uns));
+      dp_terms = calloc((NUM_CORES + 1) * (L1_ASSOC + 1), sizeof(double));
+      break;
     default:
       FATAL_ERROR(0, "Unknown search algorithm %s\n", Cache_Part_Search_str(L1_PART_METRIC));
       break;
@@ -438,7 +472,7 @@ void cache_part_init(void) {
  * Update various shadow cache stats, especially the hit positions.
  * and insert the blk into shadow cache on a miss
  *
- * Note the stat are directly commited to global_stat_array
+ * Note the stat are directly commited to global_stat_count
  *
  * Consumer later use a monitor to observe these stats
  *
@@ -451,14 +485,15 @@ void cache_part_l1_access(Mem_Req* req) {
     return;
 
   Proc_Info* proc_info = &proc_infos[req->proc_id];
+  Addr shadow_addr = get_shadow_addr(req->addr);
   Addr dummy_line_addr;
-  int pos = cache_find_pos_in_lru_stack(&proc_info->shadow_cache, req->proc_id, req->addr, &dummy_line_addr);
+  int pos = cache_find_pos_in_lru_stack(&proc_info->shadow_cache, req->proc_id, shadow_addr, &dummy_line_addr);
   Flag miss = (pos == -1);
   Flag untimely_hit = FALSE;
   Flag stalling = mem_req_type_is_stalling(req->type);
   Flag demand = mem_req_type_is_demand(req->type);
   if (!miss && L1_PART_FILL_DELAY) {
-    L1_Data* data = (L1_Data*)cache_access(&proc_info->shadow_cache, req->addr, &dummy_line_addr, FALSE);
+    L1_Data* data = (L1_Data*)cache_access(&proc_info->shadow_cache, shadow_addr, &dummy_line_addr, FALSE);
     ASSERT(req->proc_id, data);
     untimely_hit = data->fetch_cycle > freq_cycle_count(FREQ_DOMAIN_L1);
   }
@@ -484,10 +519,11 @@ void cache_part_l1_access(Mem_Req* req) {
 
   // update shadow tag
   if (miss) {
-    L1_Data* data = cache_insert(&proc_info->shadow_cache, req->proc_id, req->addr, &dummy_line_addr, &dummy_line_addr);
+    L1_Data* data = cache_insert(&proc_info->shadow_cache, req->proc_id, shadow_addr, &dummy_line_addr,
+                                 &dummy_line_addr);
     data->fetch_cycle = freq_cycle_count(FREQ_DOMAIN_L1) + (stalling || req->type == MRT_WB ? 0 : L1_PART_FILL_DELAY);
   } else {
-    cache_access(&proc_info->shadow_cache, req->addr, &dummy_line_addr, TRUE);
+    cache_access(&proc_info->shadow_cache, shadow_addr, &dummy_line_addr, TRUE);
   }
 }
 
@@ -495,11 +531,14 @@ void cache_part_l1_access(Mem_Req* req) {
 /* cache_part_l1_warmup: */
 
 void cache_part_l1_warmup(uns proc_id, Addr addr) {
+  if (!in_shadow_cache(addr))
+    return;
   Proc_Info* proc_info = &proc_infos[proc_id];
+  Addr shadow_addr = get_shadow_addr(addr);
   Addr dummy_line_addr;
-  L1_Data* data = (L1_Data*)cache_access(&proc_info->shadow_cache, addr, &dummy_line_addr, TRUE);
+  L1_Data* data = (L1_Data*)cache_access(&proc_info->shadow_cache, shadow_addr, &dummy_line_addr, TRUE);
   if (!data) {
-    L1_Data* data = cache_insert(&proc_info->shadow_cache, proc_id, addr, &dummy_line_addr, &dummy_line_addr);
+    L1_Data* data = cache_insert(&proc_info->shadow_cache, proc_id, shadow_addr, &dummy_line_addr, &dummy_line_addr);
     data->fetch_cycle = 0;
   }
 }
@@ -541,9 +580,20 @@ void cache_part_update(void) {
 /* Is the line with specified addr tracked in the shadow cache? */
 
 Flag in_shadow_cache(Addr addr) {
-  Addr dummy_addr;
-  uns set = ext_cache_index(&proc_infos[0].shadow_cache, addr, &dummy_addr, &dummy_addr);
-  return set % L1_SHADOW_TAGS_MODULO == 0;
+  uns set = (addr >> LOG2(L1_LINE_SIZE)) & (l1_sets - 1);
+  return set % shadow_modulo == 0;
+}
+
+/**************************************************************************************/
+/* Address of a sampled line in the shadow cache: the L1 set index is replaced by
+   the index of the set among the sampled ones, so that each shadow set holds the
+   lines of exactly one sampled L1 set. */
+
+Addr get_shadow_addr(Addr addr) {
+  Addr line_index = addr >> LOG2(L1_LINE_SIZE);
+  Addr set = line_index & (l1_sets - 1);
+  Addr shadow_line_index = (line_index >> LOG2(l1_sets) << LOG2(shadow_sets)) | (set / shadow_modulo);
+  return shadow_line_index << LOG2(L1_LINE_SIZE) | (addr & (L1_LINE_SIZE - 1));
 }
 
 /**************************************************************************************/
@@ -556,7 +606,7 @@ void measure_miss_curves(void) {
     uns pos0_hit_stat = L1_PART_USE_STALLING ? L1_SHADOW_STALLING_HIT_POS0 : L1_SHADOW_DEMAND_HIT_POS0;
     Counter shadow_accesses = stat_mon_get_count(stat_mon, proc_id, access_stat);
     Counter shadow_misses_sum = shadow_accesses;
-    for (uns ii = 0; ii < L1_ASSOC - 1; ii++) {
+    for (uns ii = 0; ii < L1_ASSOC; ii++) {
       Counter way_hits = stat_mon_get_count(stat_mon, proc_id, pos0_hit_stat + ii);
       shadow_misses_sum -= way_hits;
       proc_info->miss_rates[ii] = (double)shadow_misses_sum / (double)shadow_accesses;
@@ -576,12 +626,12 @@ double get_best_marginal_utility(uns* partition, uns proc_id, uns balance, uns*
   uns old_ways = partition[proc_id];
   uns max_ways = old_ways + balance;
   ASSERT(0, max_ways <= L1_ASSOC);
-  double cur_metric = metric_func(partition);
+  double cur_metric = get_metric(partition);
   double best_mu = 0.0;
   uns best_ways = old_ways;
   for (uns ways = old_ways + 1; ways <= max_ways; ways++) {
     partition[proc_id] = ways;
-    double new_metric = metric_func(partition);
+    double new_metric = get_metric(partition);
     double mu = (new_metric - cur_metric) / (double)(ways - old_ways);
     if (mu < best_mu) {
       best_mu = mu;
@@ -616,7 +666,7 @@ void search_bruteforce(void) {
     partition[NUM_CORES - 1] += L1_ASSOC - sum;
 
     /* check the metric for the partition */
-    double metric = metric_func(partition);
+    double metric = get_metric(partition);
     if (ENABLE_GLOBAL_DEBUG_PRINT && DEBUG_RANGE_COND(0)) {
       char buf[MAX_STR_LENGTH + 1];
       char* ptr = buf;
@@ -649,6 +699,57 @@ void search_bruteforce(void) {
   ASSERT(0, best_metric != 1.0e99);
 }
 
+/**************************************************************************************/
+/* Find the best partition with dynamic programming. The metric is a sum (or a
+   product) of per core terms, so the best way to give w ways to the first n cores
+   is the best over k of giving k ways to core n - 1 and w - k ways to the others.
+   Exact like search_bruteforce, but O(cores * ways^2) instead of exponential. */
+
+void search_dynamic_prog(void) {
+  uns* partition = new_partition;
+  ASSERT(0, NUM_CORES <= L1_ASSOC);
+
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    for (uns ways = 1; ways <= L1_ASSOC; ways++) {
+      dp_terms[DP_IDX(proc_id, ways)] = metric_term_func(proc_id, ways);
+      ASSERT(0, !metric_is_product || dp_terms[DP_IDX(proc_id, ways)] >= 0.0);
+    }
+  }
+
+  // dp_metric[DP_IDX(n, w)]: best sum/product of the terms of cores 0..n-1 sharing w ways
+  // dp_ways[DP_IDX(n, w)]: the ways core n - 1 gets in that partition
+  dp_metric[DP_IDX(0, 0)] = metric_is_product ? 1.0 : 0.0;
+  for (uns cores = 1; cores <= NUM_CORES; cores++) {
+    uns proc_id = cores - 1;
+    for (uns ways = cores; ways <= L1_ASSOC - (NUM_CORES - cores); ways++) {
+      // every core gets at least one way, so the other cores need at least cores - 1
+      Flag found = FALSE;
+      for (uns core_ways = cores == 1 ? ways : 1; core_ways + (cores - 1) <= ways; core_ways++) {
+        uns rest = ways - core_ways;
+        double term = dp_terms[DP_IDX(proc_id, core_ways)];
+        double prev = dp_metric[DP_IDX(cores - 1, rest)];
+        double value = metric_is_product ? prev * term : prev + term;
+        Flag better = metric_is_product ? value > dp_metric[DP_IDX(cores, ways)] :
+                                          value < dp_metric[DP_IDX(cores, ways)];
+        if (!found || better) {
+          dp_metric[DP_IDX(cores, ways)] = value;
+          dp_ways[DP_IDX(cores, ways)] = core_ways;
+          found = TRUE;
+        }
+      }
+      ASSERT(0, found);
+    }
+  }
+
+  uns ways = L1_ASSOC;
+  for (uns cores = NUM_CORES; cores > 0; cores--) {
+    partition[cores - 1] = dp_ways[DP_IDX(cores, ways)];
+    ways -= partition[cores - 1];
+  }
+  ASSERT(0, ways == 0);
+  DEBUG(0, "Dynamic programming partition metric: %.4f\n", get_metric(partition));
+}
+
 /**************************************************************************************/
 /* Use lookahead method to estimate best partition */
 
@@ -721,84 +822,84 @@ void debug_cache_part(uns* old_partition, uns* new_partition) {
   for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     ptr += sprintf(ptr, "%d,", new_partition[proc_id]);
     DPRINTF("Miss curve[%d]:", proc_id);
-    for (uns ii = 0; ii < L1_ASSOC - 1; ii++) {
+    for (uns ii = 0; ii < L1_ASSOC; ii++) {
       DPRINTF(" %.4f", proc_infos[proc_id].miss_rates[ii]);
     }
     DPRINTF("\n");
   }
-  DPRINTF("New partition {%s}, metric %.4f -> %.4f\n", buf, metric_func(old_partition), metric_func(new_partition));
+  DPRINTF("New partition {%s}, metric %.4f -> %.4f\n", buf, get_metric(old_partition), get_metric(new_partition));
 }
 
 /**************************************************************************************/
-/* get global miss rate */
+/* Metric of a partition: the sum of the per core terms, or the negated product
+   for the performance metric (negative because we minimize the metric) */
 
-double get_global_miss_rate(uns* partition) {
-  double sum = 0.0;
+double get_metric(uns* partition) {
+  double value = metric_is_product ? 1.0 : 0.0;
   for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-    Proc_Info* proc_info = &proc_infos[proc_id];
-    Counter accesses = stat_mon_get_count(stat_mon, proc_id,
-                                          L1_PART_USE_STALLING ? L1_SHADOW_ACCESS_STALLING : L1_SHADOW_ACCESS_DEMAND);
-    sum += proc_info->miss_rates[partition[proc_id]] * (double)accesses;
+    double term = metric_term_func(proc_id, partition[proc_id]);
+    value = metric_is_product ? value * term : value + term;
   }
-  return sum;
+  return metric_is_product ? -value : value;
 }
 
 /**************************************************************************************/
-/* get miss rate sum */
+/* get global miss rate: the misses of a core */
 
-double get_miss_rate_sum(uns* partition) {
-  double sum = 0.0;
-  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-    Proc_Info* proc_info = &proc_infos[proc_id];
-    sum += proc_info->miss_rates[partition[proc_id]];
-  }
-  return sum;
+double get_global_miss_rate(uns proc_id, uns ways) {
+  Proc_Info* proc_info = &proc_infos[proc_id];
+  Counter accesses = stat_mon_get_count(stat_mon, proc_id,
+                                        L1_PART_USE_STALLING ? L1_SHADOW_ACCESS_STALLING : L1_SHADOW_ACCESS_DEMAND);
+  return proc_info->miss_rates[ways - 1] * (double)accesses;
 }
 
 /**************************************************************************************/
-/* get negative gmean of core performance (negative because we minimize the
- * metric) */
+/* get miss rate sum: the miss rate of a core */
 
-double get_gmean_perf(uns* partition) {
-  double product = 1.0;
-  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-    /* Assuming constant stall time per miss and constant compute time per
-       access:
+double get_miss_rate(uns proc_id, uns ways) {
+  Proc_Info* proc_info = &proc_infos[proc_id];
+  return proc_info->miss_rates[ways - 1];
+}
 
-          stall time    misses      compute time       time
-          ---------- x --------  +  ------------  =  --------
-            misses     accesses       accesses       accesses
+/**************************************************************************************/
+/* get gmean of core performance: the predicted performance of a core */
 
-          stall time   miss rate    compute time       time
-           per miss                   per miss      per access
+double get_gmean_perf(uns proc_id, uns ways) {
+  /* Assuming constant stall time per miss and constant compute time per
+     access:
 
-           CONSTANT    VARIABLE       CONSTANT       VARIABLE
+        stall time    misses      compute time       time
+        ---------- x --------  +  ------------  =  --------
+          misses     accesses       accesses       accesses
 
-       From this model, we can derive that normalized performance
-       given a new vs old miss rate is the *reciprocal* of:
+        stall time   miss rate    compute time       time
+         per miss                   per miss      per access
 
-               / new miss rate     \
-           1 + | ------------- - 1 | x stall frac
-               \ old miss rate     /
-    */
-    Proc_Info* proc_info = &proc_infos[proc_id];
-    double stall_frac = (double)stat_mon_get_count(stat_mon, proc_id, RET_BLOCKED_L1_MISS) /
-                        (double)stat_mon_get_count(stat_mon, proc_id, NODE_CYCLE);
-    double miss_rate0 = proc_info->miss_rates[current_partition[proc_id]];
-    double miss_rate = proc_info->miss_rates[partition[proc_id]];
-    double pred_perf;
-    if (miss_rate0 == 0.0 || stall_frac == 0.0) {
-      // in case of zero misses or stall time make the smallest
-      // partition most attractive
-      if (partition[proc_id] == 1) {
-        pred_perf = 1.0;
-      } else {
-        pred_perf = 0.0;
-      }
+         CONSTANT    VARIABLE       CONSTANT       VARIABLE
+
+     From this model, we can derive that normalized performance
+     given a new vs old miss rate is the *reciprocal* of:
+
+             / new miss rate     \
+         1 + | ------------- - 1 | x stall frac
+             \ old miss rate     /
+  */
+  Proc_Info* proc_info = &proc_infos[proc_id];
+  double stall_frac = (double)stat_mon_get_count(stat_mon, proc_id, RET_BLOCKED_L1_MISS) /
+                      (double)stat_mon_get_count(stat_mon, proc_id, NODE_CYCLE);
+  double miss_rate0 = proc_info->miss_rates[current_partition[proc_id] - 1];
+  double miss_rate = proc_info->miss_rates[ways - 1];
+  double pred_perf;
+  if (miss_rate0 == 0.0 || stall_frac == 0.0) {
+    // in case of zero misses or stall time make the smallest
+    // partition most attractive
+    if (ways == 1) {
+      pred_perf = 1.0;
     } else {
-      pred_perf = 1.0 / (1.0 + (miss_rate / miss_rate0 - 1) * stall_frac);
+      pred_perf = 0.0;
     }
-    product *= pred_perf;
+  } else {
+    pred_perf = 1.0 / (1.0 + (miss_rate / miss_rate0 - 1) * stall_frac);
   }
-  return -product;
+  return pred_perf;
 }
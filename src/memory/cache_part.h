@@ -40,7 +40,7 @@ struct Mem_Req_struct;
 
 DECLARE_ENUM(Cache_Part_Metric, CACHE_PART_METRIC_LIST, CACHE_PART_METRIC_);
 
-#define CACHE_PART_SEARCH_LIST(elem) elem(LOOKAHEAD) elem(BRUTE_FORCE)
+#define CACHE_PART_SEARCH_LIST(elem) elem(LOOKAHEAD) elem(BRUTE_FORCE) elem(DYNAMIC_PROG)
 
 DECLARE_ENUM(Cache_Part_Search, CACHE_PART_SEARCH_LIST, CACHE_PART_SEARCH_);
 
@@ -0,0 +1,485 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : memory/cache_study.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Single-pass study of many cache configurations (--mode cache_study).
+ *The instruction and data references of the trace are filtered through the
+ *configured icache, dcache and mlc to form the reference stream of each level.
+ *Each level buffers its references and periodically replays the batch on every
+ *studied configuration. True LRU configurations with the same number of sets
+ *share one set of LRU stacks (stack distance analysis), so a single pass gives
+ *their misses for every associativity. The configurations of other replacement
+ *policies are simulated with cache_lib. The work of a batch is spread over
+ *cache_study_threads threads.
+ ***************************************************************************************/
+
+#include "memory/cache_study.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "general.param.h"
+#include "memory/memory.param.h"
+
+#include "libs/cache_lib.h"
+#include "op.h"
+#include "table_info.h"
+
+/**************************************************************************************/
+/* Macros */
+
+#define CACHE_STUDY_BATCH (1 << 16)  // references buffered by a level between two replays
+#define CACHE_STUDY_MAX_ASSOCS 32
+#define CACHE_STUDY_EMPTY ((Addr)-1)  // empty LRU stack entry, never a line number
+
+/**************************************************************************************/
+/* Types */
+
+typedef enum Cache_Study_Level_Id_enum {
+  CACHE_STUDY_ICACHE,
+  CACHE_STUDY_DCACHE,
+  CACHE_STUDY_MLC,
+  CACHE_STUDY_LLC,
+  NUM_CACHE_STUDY_LEVELS
+} Cache_Study_Level_Id;
+
+/* The true LRU configurations of a level with the same number of sets share their LRU
+   stacks: an access at stack distance d hits in every associativity above d. */
+typedef struct Cache_Study_Stack_struct {
+  uns num_sets;
+  uns depth;           // largest associativity studied with num_sets sets
+  Addr* lines;         // an LRU stack of depth line numbers per set, MRU first
+  Counter* dist_hist;  // accesses per stack distance, [depth] are misses in every associativity
+} Cache_Study_Stack;
+
+typedef struct Cache_Study_Config_struct {
+  uns size;
+  uns assoc;
+  uns num_sets;
+  Cache_Study_Stack* stack;  // true LRU
+  Cache cache;               // other replacement policies
+  Counter misses;            // other replacement policies
+} Cache_Study_Config;
+
+typedef struct Cache_Study_Level_struct {
+  const char* name;
+  uns line_size;
+  Flag studied;
+  Cache_Study_Config* configs;
+  uns num_configs;
+  Cache_Study_Stack* stacks;
+  uns num_stacks;
+  Addr* refs;  // references of the current batch
+  uns num_refs;
+  Counter accesses;
+} Cache_Study_Level;
+
+/* the work of a replay: one LRU stack or one configuration of a level */
+typedef struct Cache_Study_Unit_struct {
+  Cache_Study_Level* level;
+  Cache_Study_Stack* stack;
+  Cache_Study_Config* config;
+} Cache_Study_Unit;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static const char* const cache_study_level_names[NUM_CACHE_STUDY_LEVELS] = {"icache", "dcache", "mlc", "llc"};
+
+static Cache_Study_Level levels[NUM_CACHE_STUDY_LEVELS];
+static Cache_Study_Unit* units;
+static uns num_units;
+static uns next_unit;  // next unit of the current replay, shared by the threads
+static uns num_threads;
+static pthread_t* threads;
+
+/* the configured caches that filter the references of the lower levels */
+static Cache filter_icache;
+static Cache filter_dcache;
+static Cache filter_mlc;
+static Addr last_inst_line;
+
+/**************************************************************************************/
+/* Prototypes */
+
+static void init_cache_study_level(Cache_Study_Level* level, const char* name, uns line_size, uns* assocs,
+                                   uns num_assocs);
+static uns cache_study_read_assocs(uns* assocs);
+static Flag cache_study_filter(Cache* cache, Addr addr);
+static void cache_study_ref(Cache_Study_Level_Id id, Addr addr);
+static void cache_study_l1_miss(Addr addr);
+static void cache_study_replay(void);
+static void* cache_study_worker(void* arg);
+static void cache_study_run_unit(Cache_Study_Unit* unit);
+static void cache_study_lru_access(Cache_Study_Stack* stack, Addr line);
+static Counter cache_study_misses(Cache_Study_Level* level, Cache_Study_Config* config);
+
+/**************************************************************************************/
+/* init_cache_study: */
+
+void init_cache_study(void) {
+  Repl_Policy repl = (Repl_Policy)CACHE_STUDY_REPL;
+  ASSERTUM(0,
+           repl == REPL_TRUE_LRU || repl == REPL_RANDOM || repl == REPL_NOT_MRU || repl == REPL_ROUND_ROBIN ||
+               repl == REPL_LRU_REF || repl == REPL_NRU || repl == REPL_SRRIP || repl == REPL_BRRIP ||
+               repl == REPL_DRRIP,
+           "cache_study_repl %u needs more than the reference stream.\n", CACHE_STUDY_REPL);
+  ASSERTUM(0, CACHE_STUDY_MIN_SIZE && !(CACHE_STUDY_MIN_SIZE & (CACHE_STUDY_MIN_SIZE - 1)),
+           "cache_study_min_size must be a power of two.\n");
+  ASSERTUM(0, CACHE_STUDY_MIN_SIZE <= CACHE_STUDY_MAX_SIZE, "cache_study_max_size is below cache_study_min_size.\n");
+
+  char names[MAX_STR_LENGTH + 1];
+  strncpy(names, CACHE_STUDY_LEVELS, MAX_STR_LENGTH);
+  names[MAX_STR_LENGTH] = 0;
+  for (char* name = strtok(names, ", "); name; name = strtok(NULL, ", ")) {
+    uns id;
+    for (id = 0; id < NUM_CACHE_STUDY_LEVELS; id++)
+      if (!strcmp(name, cache_study_level_names[id]))
+        break;
+    ASSERTUM(0, id < NUM_CACHE_STUDY_LEVELS, "Unknown cache level '%s' in cache_study_levels.\n", name);
+    levels[id].studied = TRUE;
+  }
+  if (levels[CACHE_STUDY_MLC].studied && !MLC_PRESENT) {
+    fprintf(mystdout, "** cache_study: mlc_present is not set, the mlc is not studied\n");
+    levels[CACHE_STUDY_MLC].studied = FALSE;
+  }
+
+  uns assocs[CACHE_STUDY_MAX_ASSOCS];
+  uns num_assocs = cache_study_read_assocs(assocs);
+  uns line_sizes[NUM_CACHE_STUDY_LEVELS] = {ICACHE_LINE_SIZE, DCACHE_LINE_SIZE, MLC_LINE_SIZE, L1_LINE_SIZE};
+  for (uns id = 0; id < NUM_CACHE_STUDY_LEVELS; id++)
+    init_cache_study_level(&levels[id], cache_study_level_names[id], line_sizes[id], assocs, num_assocs);
+
+  units = (Cache_Study_Unit*)malloc(sizeof(Cache_Study_Unit) * (num_units ? num_units : 1));
+  num_units = 0;
+  for (uns id = 0; id < NUM_CACHE_STUDY_LEVELS; id++) {
+    Cache_Study_Level* level = &levels[id];
+    for (uns ii = 0; ii < level->num_stacks; ii++)
+      units[num_units++] = (Cache_Study_Unit){level, &level->stacks[ii], NULL};
+    for (uns ii = 0; ii < level->num_configs; ii++)
+      if (!level->configs[ii].stack)
+        units[num_units++] = (Cache_Study_Unit){level, NULL, &level->configs[ii]};
+  }
+
+  // random, BRRIP and DRRIP draw from the shared rand() state, so their replays stay serial
+  Flag shared_rand = repl == REPL_RANDOM || repl == REPL_BRRIP || repl == REPL_DRRIP;
+  num_threads = shared_rand ? 1 : MAX2(CACHE_STUDY_THREADS, 1);
+  threads = (pthread_t*)malloc(sizeof(pthread_t) * num_threads);
+
+  init_cache(&filter_icache, "cache_study icache", ICACHE_SIZE, ICACHE_ASSOC, ICACHE_LINE_SIZE, 0,
+             (Repl_Policy)ICACHE_REPL);
+  init_cache(&filter_dcache, "cache_study dcache", DCACHE_SIZE, DCACHE_ASSOC, DCACHE_LINE_SIZE, 0,
+             (Repl_Policy)DCACHE_REPL);
+  if (MLC_PRESENT)
+    init_cache(&filter_mlc, "cache_study mlc", MLC_SIZE, MLC_ASSOC, MLC_LINE_SIZE, 0,
+               (Repl_Policy)MLC_CACHE_REPL_POLICY);
+  last_inst_line = CACHE_STUDY_EMPTY;
+}
+
+/**************************************************************************************/
+/* init_cache_study_level: set up the configurations of a level and the LRU stacks they
+   share. A configuration needs a power of two number of sets of at least one line.
+   num_units counts the units of work of all the levels. */
+
+static void init_cache_study_level(Cache_Study_Level* level, const char* name, uns line_size, uns* assocs,
+                                   uns num_assocs) {
+  level->name = name;
+  level->line_size = line_size;
+  if (!level->studied)
+    return;
+
+  Repl_Policy repl = (Repl_Policy)CACHE_STUDY_REPL;
+  uns num_sizes = 0;
+  for (uns64 size = CACHE_STUDY_MIN_SIZE; size <= CACHE_STUDY_MAX_SIZE; size *= 2)
+    num_sizes++;
+  level->configs = (Cache_Study_Config*)calloc(num_sizes * num_assocs, sizeof(Cache_Study_Config));
+  level->stacks = (Cache_Study_Stack*)calloc(num_sizes * num_assocs, sizeof(Cache_Study_Stack));
+  level->refs = (Addr*)malloc(sizeof(Addr) * CACHE_STUDY_BATCH);
+
+  for (uns64 size = CACHE_STUDY_MIN_SIZE; size <= CACHE_STUDY_MAX_SIZE; size *= 2) {
+    for (uns ii = 0; ii < num_assocs; ii++) {
+      uns64 num_sets = size / line_size / assocs[ii];
+      if (!num_sets || num_sets * line_size * assocs[ii] != size || (num_sets & (num_sets - 1)))
+        continue;
+      Cache_Study_Config* config = &level->configs[level->num_configs++];
+      config->size = size;
+      config->assoc = assocs[ii];
+      config->num_sets = num_sets;
+      if (repl != REPL_TRUE_LRU) {
+        char cache_name[MAX_STR_LENGTH + 1];
+        snprintf(cache_name, MAX_STR_LENGTH + 1, "cache_study %s %u/%u", name, config->size, config->assoc);
+        init_cache(&config->cache, cache_name, config->size, config->assoc, line_size, 0, repl);
+        num_units++;
+        continue;
+      }
+
+      uns jj;
+      for (jj = 0; jj < level->num_stacks; jj++)
+        if (level->stacks[jj].num_sets == num_sets)
+          break;
+      if (jj == level->num_stacks) {
+        level->stacks[jj].num_sets = num_sets;
+        level->num_stacks++;
+        num_units++;
+      }
+      level->stacks[jj].depth = MAX2(level->stacks[jj].depth, config->assoc);
+    }
+  }
+
+  for (uns ii = 0; ii < level->num_configs; ii++) {
+    Cache_Study_Config* config = &level->configs[ii];
+    for (uns jj = 0; jj < level->num_stacks && repl == REPL_TRUE_LRU; jj++)
+      if (level->stacks[jj].num_sets == config->num_sets)
+        config->stack = &level->stacks[jj];
+  }
+  for (uns ii = 0; ii < level->num_stacks; ii++) {
+    Cache_Study_Stack* stack = &level->stacks[ii];
+    stack->lines = (Addr*)malloc(sizeof(Addr) * stack->num_sets * stack->depth);
+    memset(stack->lines, 0xff, sizeof(Addr) * stack->num_sets * stack->depth);  // CACHE_STUDY_EMPTY
+    stack->dist_hist = (Counter*)calloc(stack->depth + 1, sizeof(Counter));
+  }
+  ASSERTUM(0, level->num_configs, "No cache_study configuration fits the %u byte lines of the %s.\n", line_size,
+           name);
+}
+
+/**************************************************************************************/
+/* cache_study_read_assocs: parse the comma separated associativities of CACHE_STUDY_ASSOCS */
+
+static uns cache_study_read_assocs(uns* assocs) {
+  char list[MAX_STR_LENGTH + 1];
+  strncpy(list, CACHE_STUDY_ASSOCS, MAX_STR_LENGTH);
+  list[MAX_STR_LENGTH] = 0;
+
+  uns num_assocs = 0;
+  for (char* assoc = strtok(list, ", "); assoc; assoc = strtok(NULL, ", ")) {
+    ASSERTUM(0, num_assocs < CACHE_STUDY_MAX_ASSOCS, "More than %u associativities in cache_study_assocs.\n",
+             CACHE_STUDY_MAX_ASSOCS);
+    assocs[num_assocs] = strtoul(assoc, NULL, 0);
+    ASSERTUM(0, assocs[num_assocs], "Bad associativity '%s' in cache_study_assocs.\n", assoc);
+    num_assocs++;
+  }
+  ASSERTUM(0, num_assocs, "No associativities in cache_study_assocs.\n");
+  return num_assocs;
+}
+
+/**************************************************************************************/
+/* cache_study_op: pass the references of an op to the levels. An instruction accesses
+   the icache when it starts a new line, loads and stores access the dcache once for
+   every line they touch. Stores allocate; writebacks and prefetches are not modeled. */
+
+void cache_study_op(Op* op) {
+  if (op->bom) {
+    Addr inst_line = op->inst_info->addr >> LOG2(ICACHE_LINE_SIZE);
+    if (inst_line != last_inst_line) {
+      last_inst_line = inst_line;
+      cache_study_ref(CACHE_STUDY_ICACHE, op->inst_info->addr);
+      if (cache_study_filter(&filter_icache, op->inst_info->addr))
+        cache_study_l1_miss(op->inst_info->addr);
+    }
+  }
+
+  Mem_Type mem_type = op->table_info->mem_type;
+  if (mem_type != MEM_LD && mem_type != MEM_ST)
+    return;
+  uns shift = LOG2(DCACHE_LINE_SIZE);
+  Addr va = op->oracle_info.va;
+  Addr last_line = (va + MAX2(op->oracle_info.mem_size, 1) - 1) >> shift;
+  for (Addr line = va >> shift; line <= last_line; line++) {
+    Addr addr = line << shift;
+    cache_study_ref(CACHE_STUDY_DCACHE, addr);
+    if (cache_study_filter(&filter_dcache, addr))
+      cache_study_l1_miss(addr);
+  }
+}
+
+/**************************************************************************************/
+/* cache_study_l1_miss: the icache and dcache misses go to the mlc, and its misses to
+   the llc */
+
+static void cache_study_l1_miss(Addr addr) {
+  if (MLC_PRESENT) {
+    cache_study_ref(CACHE_STUDY_MLC, addr);
+    if (!cache_study_filter(&filter_mlc, addr))
+      return;
+  }
+  cache_study_ref(CACHE_STUDY_LLC, addr);
+}
+
+/**************************************************************************************/
+/* cache_study_filter: access a configured cache, returns TRUE and inserts the line on
+   a miss. sim_time only orders the LRU of the configured caches in this mode. */
+
+static Flag cache_study_filter(Cache* cache, Addr addr) {
+  Addr line_addr, repl_line_addr;
+  sim_time++;
+  if (cache_access(cache, addr, &line_addr, TRUE))
+    return FALSE;
+  cache_insert(cache, 0, addr, &line_addr, &repl_line_addr);
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* cache_study_ref: buffer a reference of a level, a full batch replays all the levels */
+
+static void cache_study_ref(Cache_Study_Level_Id id, Addr addr) {
+  Cache_Study_Level* level = &levels[id];
+  if (!level->studied)
+    return;
+  level->refs[level->num_refs++] = addr;
+  if (level->num_refs == CACHE_STUDY_BATCH)
+    cache_study_replay();
+}
+
+/**************************************************************************************/
+/* cache_study_replay: replay the buffered references of every level on its LRU stacks
+   and configurations. The units are independent, so the threads take them in turn. */
+
+static void cache_study_replay(void) {
+  next_unit = 0;
+  for (uns ii = 1; ii < num_threads; ii++) {
+    int error = pthread_create(&threads[ii], NULL, cache_study_worker, NULL);
+    ASSERTM(0, !error, "Could not start a cache_study thread\n");
+  }
+  cache_study_worker(NULL);
+  for (uns ii = 1; ii < num_threads; ii++)
+    pthread_join(threads[ii], NULL);
+
+  for (uns id = 0; id < NUM_CACHE_STUDY_LEVELS; id++) {
+    levels[id].accesses += levels[id].num_refs;
+    levels[id].num_refs = 0;
+  }
+}
+
+/**************************************************************************************/
+/* cache_study_worker: */
+
+static void* cache_study_worker(void* arg) {
+  uns unit;
+  while ((unit = __atomic_fetch_add(&next_unit, 1, __ATOMIC_RELAXED)) < num_units)
+    cache_study_run_unit(&units[unit]);
+  return NULL;
+}
+
+/**************************************************************************************/
+/* cache_study_run_unit: */
+
+static void cache_study_run_unit(Cache_Study_Unit* unit) {
+  Cache_Study_Level* level = unit->level;
+  if (unit->stack) {
+    uns shift = LOG2(level->line_size);
+    for (uns ii = 0; ii < level->num_refs; ii++)
+      cache_study_lru_access(unit->stack, level->refs[ii] >> shift);
+    return;
+  }
+
+  Cache_Study_Config* config = unit->config;
+  for (uns ii = 0; ii < level->num_refs; ii++) {
+    Addr line_addr, repl_line_addr;
+    if (!cache_access(&config->cache, level->refs[ii], &line_addr, TRUE)) {
+      cache_insert(&config->cache, 0, level->refs[ii], &line_addr, &repl_line_addr);
+      config->misses++;
+    }
+  }
+}
+
+/**************************************************************************************/
+/* cache_study_lru_access: find the stack distance of a line in its set and move it to
+   the top of the stack. Lines deeper than the stack miss in every associativity. */
+
+static void cache_study_lru_access(Cache_Study_Stack* stack, Addr line) {
+  Addr* set_lines = &stack->lines[(line & (stack->num_sets - 1)) * stack->depth];
+  uns dist;
+  for (dist = 0; dist < stack->depth && set_lines[dist] != line; dist++)
+    ;
+  stack->dist_hist[dist]++;
+  memmove(&set_lines[1], &set_lines[0], sizeof(Addr) * MIN2(dist, stack->depth - 1));
+  set_lines[0] = line;
+}
+
+/**************************************************************************************/
+/* cache_study_start_measure: the references so far only warmed the caches */
+
+void cache_study_start_measure(void) {
+  cache_study_replay();
+  for (uns id = 0; id < NUM_CACHE_STUDY_LEVELS; id++) {
+    Cache_Study_Level* level = &levels[id];
+    level->accesses = 0;
+    for (uns ii = 0; ii < level->num_stacks; ii++)
+      memset(level->stacks[ii].dist_hist, 0, sizeof(Counter) * (level->stacks[ii].depth + 1));
+    for (uns ii = 0; ii < level->num_configs; ii++)
+      level->configs[ii].misses = 0;
+  }
+}
+
+/**************************************************************************************/
+/* cache_study_misses: */
+
+static Counter cache_study_misses(Cache_Study_Level* level, Cache_Study_Config* config) {
+  if (!config->stack)
+    return config->misses;
+  Counter hits = 0;
+  for (uns dist = 0; dist < config->assoc; dist++)
+    hits += config->stack->dist_hist[dist];
+  return level->accesses - hits;
+}
+
+/**************************************************************************************/
+/* cache_study_done: write the misses of every configuration to CACHE_STUDY_FILE */
+
+void cache_study_done(Counter insts) {
+  cache_study_replay();
+
+  double kilo_insts = MAX2(insts, 1) / 1000.0;
+  char buf[MAX_STR_LENGTH + 1];
+  snprintf(buf, MAX_STR_LENGTH + 1, "%s/%s%s", OUTPUT_DIR, FILE_TAG, CACHE_STUDY_FILE);
+  FILE* file = fopen(buf, "w");
+  ASSERTUM(0, file, "Couldn't open cache_study output file '%s'.\n", buf);
+  fprintf(file, "# %s instructions measured after a warmup of %s, replacement policy %u\n", unsstr64(insts),
+          unsstr64(WARMUP), CACHE_STUDY_REPL);
+  fprintf(file, "%-8s %12s %6s %10s %6s %14s %14s %10s %10s\n", "level", "size", "assoc", "sets", "line",
+          "accesses", "misses", "miss_rate", "mpki");
+  for (uns id = 0; id < NUM_CACHE_STUDY_LEVELS; id++) {
+    Cache_Study_Level* level = &levels[id];
+    if (!level->studied)
+      continue;
+    for (uns ii = 0; ii < level->num_configs; ii++) {
+      Cache_Study_Config* config = &level->configs[ii];
+      Counter misses = cache_study_misses(level, config);
+      fprintf(file, "%-8s %12u %6u %10u %6u %14lld %14lld %10.4f %10.4f\n", level->name, config->size, config->assoc,
+              config->num_sets, level->line_size, level->accesses, misses,
+              (double)misses / MAX2(level->accesses, 1), misses / kilo_insts);
+    }
+    fprintf(mystdout, "** cache_study %-8s  accesses PKI: %10.4f  configurations: %u\n", level->name,
+            level->accesses / kilo_insts, level->num_configs);
+  }
+  fclose(file);
+}
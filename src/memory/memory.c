@@ -58,6 +58,7 @@
 #include "addr_trans.h"
 #include "cache_part.h"
 #include "cmp_model.h"
+#include "host_profile.h"
 #include "icache_stage.h"
 #include "mem_req.h"
 #include "op.h"
@@ -343,7 +344,7 @@ void init_memory() {
   mem->pref_replpos = INSERT_REPL_MRU;
   if (PREF_ANALYZE_LOAD) {
     mem->pref_loadPC_hash = (Hash_Table*)malloc(sizeof(Hash_Table));
-    init_hash_table(mem->pref_loadPC_hash, "Pref_loadPC_hash", 100000, sizeof(Pref_LoadPCInfo));
+    init_hash_table(mem->pref_loadPC_hash, "Pref_loadPC_hash", 1024, sizeof(Pref_LoadPCInfo));  // grows as needed
   }
 
   // BW
@@ -796,8 +797,11 @@ void update_on_chip_memory_stats() {
   for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     STAT_EVENT(proc_id, CORE_MLP_0 + MIN2(mem->uncores[proc_id].num_outstanding_l1_misses, 32));
     INC_STAT_EVENT(proc_id, CORE_MLP, mem->uncores[proc_id].num_outstanding_l1_misses);
-    Counter l1_lines = GET_TOTAL_STAT_EVENT(proc_id, NORESET_L1_FILL) - GET_TOTAL_STAT_EVENT(proc_id, NORESET_L1_EVICT);
-    INC_STAT_EVENT(proc_id, L1_LINES, l1_lines);
+    if (stat_on(L1_LINES)) {
+      Counter l1_lines =
+          GET_TOTAL_STAT_EVENT(proc_id, NORESET_L1_FILL) - GET_TOTAL_STAT_EVENT(proc_id, NORESET_L1_EVICT);
+      INC_STAT_EVENT(proc_id, L1_LINES, l1_lines);
+    }
   }
 }
 
@@ -825,7 +829,7 @@ void update_memory() {
     cycle_count = freq_cycle_count(FREQ_DOMAIN_MEMORY);
 
     // dram_process_main_memory_reqs();
-    ramulator_tick();
+    HOST_PROFILE(RAMULATOR, ramulator_tick());
   }
 
   if (freq_is_ready(FREQ_DOMAIN_L1)) {
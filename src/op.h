@@ -83,6 +83,10 @@ typedef struct Per_Branch_Stat_struct {
   Addr addr;
   Cf_Type cf_type;
   Addr target;
+  Counter fetched;   // on-path fetches
+  Counter mispred;   // on-path recoveries by cause
+  Counter misfetch;
+  Counter btb_miss;
 } Per_Branch_Stat;
 
 // this information is used when the op mispredicts
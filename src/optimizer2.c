@@ -43,11 +43,13 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
 #include "globals/assert.h"
 #include "globals/global_defs.h"
 #include "globals/global_types.h"
+#include "globals/global_vars.h"
 #include "globals/utils.h"
 
 #include "debug/debug.param.h"
@@ -290,6 +292,65 @@ void opt2_init(uns n, uns n_to_keep, void (*fn)(int)) {
   return;
 }
 
+/* Unlike opt2_init, the sweep children never talk to each other or to
+   the parent: each one runs its configuration to completion, and the
+   parent only reaps them. */
+uns opt2_sweep(uns n, uns max_parallel, void (*fn)(int)) {
+  ASSERTM(0, !in_use, "A parameter sweep cannot be combined with optimizer2 (e.g., oracle DVFS)\n");
+  ASSERT(0, n > 0);
+  pid_t* pids = (pid_t*)calloc(n, sizeof(pid_t));
+  int* statuses = (int*)calloc(n, sizeof(int));
+  uns num_started = 0;
+  uns num_running = 0;
+  uns num_failed = 0;
+  DEBUG(0, "Sweeping %d configurations, %d at a time\n", n, max_parallel ? max_parallel : n);
+  while (num_started < n || num_running > 0) {
+    if (num_started < n && (!max_parallel || num_running < max_parallel)) {
+      fflush(NULL); /* avoid repeated messages */
+      pid_t pid = fork();
+      if (pid < 0)
+        FATAL_ERROR(0, "Fork of sweep configuration %d FAILED. errno: %s\n", num_started, strerror(errno));
+      if (!pid) {
+        free(pids);
+        free(statuses);
+        decouple_open_files();
+        my_config_num = num_started;
+        fn(my_config_num);
+        return my_config_num;
+      }
+      DEBUG(0, "Sweep configuration %d is process %d\n", num_started, pid);
+      pids[num_started++] = pid;
+      num_running++;
+    } else {
+      int status;
+      pid_t pid = waitpid(-1, &status, 0);
+      if (pid < 0)
+        FATAL_ERROR(0, "Waiting for sweep configurations FAILED. errno: %s\n", strerror(errno));
+      for (uns config = 0; config < num_started; config++) {
+        if (pids[config] == pid) {
+          statuses[config] = status;
+          num_running--;
+          break;
+        }
+      }
+    }
+  }
+  for (uns config = 0; config < n; config++) {
+    Flag ok = WIFEXITED(statuses[config]) && WEXITSTATUS(statuses[config]) == 0;
+    if (ok)
+      fprintf(mystdout, "** Sweep configuration %d finished\n", config);
+    else if (WIFSIGNALED(statuses[config]))
+      fprintf(mystdout, "** Sweep configuration %d FAILED (signal %d)\n", config, WTERMSIG(statuses[config]));
+    else
+      fprintf(mystdout, "** Sweep configuration %d FAILED (exit code %d)\n", config, WEXITSTATUS(statuses[config]));
+    num_failed += !ok;
+  }
+  fflush(mystdout);
+  free(pids);
+  free(statuses);
+  exit(num_failed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
 void slave_clean_up(void) {
   char buf[MAX_STR_LENGTH + 1];
   fclose(read_stream);
@@ -37,6 +37,12 @@
  * control to them, spawns master */
 void opt2_init(uns n, uns n_to_keep, void (*setup_param_fn)(int));
 
+/* Forks one process per configuration (at most max_parallel at a time,
+   0 for no limit), calls setup_param_fn(config_num) in each and returns
+   config_num there. The calling process waits for all of them and exits,
+   failing if any configuration failed. */
+uns opt2_sweep(uns n, uns max_parallel, void (*setup_param_fn)(int));
+
 /* Called by slave once a comparison barrier is reached. Slave may die. */
 void opt2_comparison_barrier(double metric);
 
@@ -40,6 +40,10 @@ with all of the command-line and file arguments that were actually used to run
 the program.  This way, an exact duplicate run can be performed.
 ***************************************************************************************/
 
+/* This file defines the parameter variables, so they must not be replaced by the
+   constants of a frozen build (see frozen.param.h) */
+#define SCARAB_PARAM_DEFINITIONS
+
 #include "param_parser.h"
 
 #include <ctype.h>
@@ -80,7 +84,7 @@ the program.  This way, an exact duplicate run can be performed.
 /* Global Variables */
 
 const char* help_options[] = {"-help", "-h", "--help", "--h"}; /* cmd-line help options strings */
-const char* sim_mode_names[] = {"uop", "full"
+const char* sim_mode_names[] = {"uop", "full", "sampling", "simpoint", "bp_only", "cache_study"
 #ifdef ENABLE_PT_MEMTRACE
                                 ,
                                 "trace_bbv", "trace_bbv_distributed"
@@ -141,6 +145,22 @@ char* compiled_param_dump_array[][3] = {
     {0, 0, 0}};
 #undef DEF_PARAM
 
+/**************************************************************************************/
+/* In a frozen build (make opt-frozen) the rest of the simulator sees some parameters as
+   constants. The parameter variables still exist here, so a run that sets one of them
+   to a different value is rejected instead of silently using the frozen value. */
+
+#ifdef SCARAB_FROZEN_PARAMS
+static void check_frozen_params(void) {
+#define FROZEN_PARAM(name, variable, type, value)                                                     \
+  if (variable != (type)value)                                                                        \
+    FATAL_ERROR(0, "Cannot set parameter '%s' to a value other than %s, it was frozen at build time.\n", \
+                #name, #value);
+#include "frozen.param.def"
+#undef FROZEN_PARAM
+}
+#endif
+
 /**************************************************************************************/
 
 typedef struct Param_Record_struct {
@@ -724,26 +744,14 @@ uns get_param_file_args_and_command_line_args(char*** arg_list_ptr, int argc, ch
   return param_file_arg_count + argc; /*Return the total number of args in the arg_list*/
 }
 
-char** get_params(int argc, char* argv[]) {
-  uns arg_list_count;                   /*Count of all args and values in the arg_list (like argc
-                                           for the command line)*/
-  char** arg_list = NULL;               /*Merged list of all args and values from PARAMS.in
-                                           and the command line (like argv for the command
-                                           line)*/
-  Param_Record used_params[NUM_PARAMS]; /*Keeps track of the values that are
-                                           actually used by the simulator. */
-
-  if (contains_help_options(argc, argv)) {
-    print_help();
-    exit(0);
-  }
-
-  arg_list_count = get_param_file_args_and_command_line_args(&arg_list, argc, argv);
+/**************************************************************************************/
+/* parse_arg_list: Runs getopt_long over an argv-style list and sets every
+   parameter it names. optind must already point at the first argument. */
 
+static void parse_arg_list(int arg_list_count, char** arg_list, Param_Record* used_params) {
   int temp_index = 0;
   param_idx = -1;
   opterr = 0;  // Suppress getopt_long's error message (we have our own)
-  mark_all_params_as_unused(used_params);
   while (getopt_long(arg_list_count, arg_list, "", long_options, &temp_index) != -1) {
     int index = param_idx;
     param_idx = -1;
@@ -766,6 +774,30 @@ char** get_params(int argc, char* argv[]) {
     }
   }
 
+#ifdef SCARAB_FROZEN_PARAMS
+  check_frozen_params();
+#endif
+}
+
+char** get_params(int argc, char* argv[]) {
+  uns arg_list_count;                   /*Count of all args and values in the arg_list (like argc
+                                           for the command line)*/
+  char** arg_list = NULL;               /*Merged list of all args and values from PARAMS.in
+                                           and the command line (like argv for the command
+                                           line)*/
+  Param_Record used_params[NUM_PARAMS]; /*Keeps track of the values that are
+                                           actually used by the simulator. */
+
+  if (contains_help_options(argc, argv)) {
+    print_help();
+    exit(0);
+  }
+
+  arg_list_count = get_param_file_args_and_command_line_args(&arg_list, argc, argv);
+
+  mark_all_params_as_unused(used_params);
+  parse_arg_list(arg_list_count, arg_list, used_params);
+
   // Set global size variables.
   NUM_RS = num_tokens(RS_SIZES, DELIMITERS);
   uns temp = num_tokens(RS_CONNECTIONS, DELIMITERS);
@@ -795,6 +827,43 @@ char** get_params(int argc, char* argv[]) {
   return &arg_list[optind]; /* return pointer to simulated argv */
 }
 
+/**************************************************************************************/
+/* set_params: Applies a whitespace separated list of "--name value" overrides
+   on top of the parameters already parsed by get_params. Used to give forked
+   processes (e.g., parameter sweeps) their own settings. Only parameters that
+   are read after the call take effect, so the caller lists them with allowed
+   (NULL allows every parameter). */
+
+void set_params(const char* overrides, Flag (*allowed)(const char*)) {
+  char* buf = strdup(overrides);
+  uns max_args = strlen(buf) / 2 + 2; /* an argument is at least one character plus a separator */
+  char** arg_list = (char**)malloc(sizeof(char*) * (max_args + 1));
+  Param_Record* used_params = (Param_Record*)malloc(sizeof(Param_Record) * NUM_PARAMS);
+  uns arg_list_count = 0;
+  char* token;
+
+  arg_list[arg_list_count++] = "scarab";
+  for (token = strtok(buf, " \t\n"); token; token = strtok(NULL, " \t\n")) {
+    arg_list[arg_list_count++] = token;
+  }
+  arg_list[arg_list_count] = NULL;
+
+  mark_all_params_as_unused(used_params);
+  optind = 0;  // make getopt_long reinitialize for the new list
+  parse_arg_list(arg_list_count, arg_list, used_params);
+  if (optind < arg_list_count)
+    FATAL_ERROR(0, "Unexpected argument '%s' in parameter overrides '%s'\n", arg_list[optind], overrides);
+  for (uns ii = 0; allowed && ii < NUM_PARAMS; ii++) {
+    if (used_params[ii].used && !allowed(long_options[ii].name))
+      FATAL_ERROR(0, "Parameter '%s' cannot be changed after initialization (overrides '%s')\n",
+                  long_options[ii].name, overrides);
+  }
+
+  free(used_params);
+  free(arg_list);
+  free(buf);
+}
+
 static void print_help(void) {
   const char* help =
       "Scarab command-line option summary:\n"
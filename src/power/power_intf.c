@@ -87,6 +87,7 @@ void power_intf_init(void) {
   ASSERTM(0, NUM_CORES <= 8, "power_intf supports up to 8 cores\n");
 
   for (uns stat = POWER_STATS_BEGIN; stat <= POWER_STATS_END; ++stat) {
+    stat_require(stat, "power_intf_on");
     ASSERT(0, GET_TOTAL_STAT_EVENT(0, stat) == 0);
   }
 }
@@ -254,7 +255,7 @@ void update_energy_stats(void) {
 
 void dump_power_energy_stats(void) {
   for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-    dump_stats(proc_id, TRUE, global_stat_array[proc_id] + POWER_STATS_BEGIN, ENERGY_STATS_END - POWER_STATS_BEGIN + 1);
+    dump_stats(proc_id, TRUE, POWER_STATS_BEGIN, ENERGY_STATS_END - POWER_STATS_BEGIN + 1);
   }
 }
 
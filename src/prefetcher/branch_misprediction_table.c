@@ -41,15 +41,16 @@ Hash_Table inf_size_bm_table;
 
 void init_branch_misprediction_table(uns8 pid) {
   proc_id = pid;
-  if (BRANCH_MISPREDICTION_TABLE_SIZE == 0) {
-    init_hash_table(&inf_size_bm_table, "infinite sized", 15000000, sizeof(Bm_Info));
+  if (BRANCH_MISPREDICTION_TABLE_SIZE == 0 && !inf_size_bm_table.entries) {
+    // starts small and grows with the number of branches
+    init_hash_table(&inf_size_bm_table, "infinite sized", 1024, sizeof(Bm_Info));
     // cpp version is not a lib yet. only one instance.
   }
 }
 
 float get_branch_misprediction_rate(Addr pc) {
   float rate = 0;
-  if (BRANCH_MISPREDICTION_TABLE_SIZE == 0) {
+  if (BRANCH_MISPREDICTION_TABLE_SIZE == 0 && inf_size_bm_table.entries) {
     Bm_Info* info = (Bm_Info*)hash_table_access(&inf_size_bm_table, pc);
     if (info) {
       rate = info->branch_mispred_count / info->branch_count;
@@ -60,6 +61,7 @@ float get_branch_misprediction_rate(Addr pc) {
 
 void increment_branch_count(Addr pc) {
   if (BRANCH_MISPREDICTION_TABLE_SIZE == 0) {
+    init_branch_misprediction_table(proc_id);  // allocated at the first branch
     Flag new_entry;
     Bm_Info* info = (Bm_Info*)hash_table_access_create(&inf_size_bm_table, pc, &new_entry);
     if (new_entry)
@@ -70,6 +72,7 @@ void increment_branch_count(Addr pc) {
 
 void increment_branch_mispredictions(Addr pc) {
   if (BRANCH_MISPREDICTION_TABLE_SIZE == 0) {
+    init_branch_misprediction_table(proc_id);  // allocated at the first branch
     Flag new_entry;
     Bm_Info* info = (Bm_Info*)hash_table_access_create(&inf_size_bm_table, pc, &new_entry);
     if (new_entry)
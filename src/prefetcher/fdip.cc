@@ -56,12 +56,37 @@ typedef enum UTILITY_PREF_POLICY_enum {
   PREF_POL_END,  // add a new policy above this line
 } Utility_Pref_Policy;
 
+// Per cache line diagnostics. Only counters are kept, so the memory grows with the
+// number of lines and not with the length of the run.
+struct FDIP_Line_Info {
+  Counter icache_hit;
+  Counter icache_hit_aw;
+  Counter icache_miss;
+  Counter icache_miss_aw;
+  Counter useful_aw;
+  Counter unuseful_aw;
+  Counter prefetched_aw;
+  Counter new_prefetched;
+  Counter new_prefetched_aw;
+  Counter delay_aw;  // total miss delay after warm-up
+  Flag delayed_aw;
+  // events during warm-up, used to classify the first icache miss after warm-up
+  Counter bw_events;
+  Counter bw_not_prefetched;
+  Counter bw_useful;
+  Counter bw_unuseful;
+  // number of events after warm-up and the first two of them
+  Counter aw_events;
+  char aw_first[2];
+};
+
 class FDIP_Stat {
  public:
   FDIP_Stat()
       : last_imiss_reason(Imiss_Reason::IMISS_NOT_PREFETCHED),
         last_break_reason(BR_REACH_FTQ_END),
         last_recover_cycle(0),
+        seq_file(nullptr),
         cur_line_delay(0),
         ftq_occupancy_ops(0),
         ftq_occupancy_blocks(0) {}
@@ -75,8 +100,12 @@ class FDIP_Stat {
   void probe_prefetched_cls(Addr line_addr);
   void inc_icache_hit(Addr line_addr);
   void inc_cnt_unuseful(Addr line_addr);
+  void add_event(Addr line_addr, char event, Counter cycle);
 
  private:
+  FDIP_Line_Info* get_line_info(Addr line_addr);
+  void log_event(Addr line_addr, char event, Counter cycle);
+
   /* global variables for utility study and stats */
   // for icache miss stats
   uns last_imiss_reason;
@@ -85,55 +114,23 @@ class FDIP_Stat {
   Counter last_recover_cycle;
   // <CL address, # of first demand load on-path hits of cache lines, flag for learning from a true miss> - useful count
   unordered_map<Addr, pair<Counter, Flag>> cnt_useful;
-  // <CL address, # of first demand load on-path hits of cache lines, flag for learning from a true miss> - useful count
-  // after warm-up
-  unordered_map<Addr, pair<Counter, Flag>> cnt_useful_aw;
   // <CL address, # of evictions w/o hit of cache lines> - unuseful count
   unordered_map<Addr, Counter> cnt_unuseful;
-  // <CL address, # of evictions w/o hit of cache lines> - unuseful count after warm-up
-  unordered_map<Addr, Counter> cnt_unuseful_aw;
   // Increment if useful by UDP_WEIGHT_USEFUL, decrement if unuseful by UDP_WEIGHT_UNUSEFUL
   // <CL address, counter for on/off-path unuseful/useful> init by UDP_USEFUL_THRESHOLD
   // OPTIMISTIC POLICY : do not prefetch if < USEFUL_THRESHOLD, otherwise, prefetch (do not prefetch only when it was
   // unuseful at least once) CONSERVATIVE POLICY : prefetch if > USEFUL_THRESHOLD, otherwise, do not prefetch (prefetch
   // only when it was useful at least once)
   unordered_map<Addr, int32_t> cnt_useful_signed;
-  // <CL addresses, retirement count> - on-path retired cache line count
-  unordered_map<Addr, Counter> cnt_useful_ret;
-  // <CL addresses, icache miss count>
-  map<Addr, Counter> icache_miss;
-  // <CL addresses, icache miss count> after warm-up
-  map<Addr, Counter> icache_miss_aw;
-  // <CL addresses, icache hit count>
-  map<Addr, Counter> icache_hit;
-  // <CL addresses, icache hit count> after warm-up
-  map<Addr, Counter> icache_hit_aw;
-  // <CL addresses, fetched_cycle on the off-path>
-  map<Addr, Counter> off_fetched_cls;
-  ;
   // <CL addresses, prefetched count>
   map<Addr, Counter> prefetched_cls;
-  // <CL addresses, prefetched count> after warm-up
-  map<Addr, Counter> prefetched_cls_aw;
-  // <CL addresses, new_prefetched count>
-  map<Addr, Counter> new_prefetched_cls;
-  // <CL addresses, new_prefetched count> after warm-up
-  map<Addr, Counter> new_prefetched_cls_aw;
   // <CL address, cyc_access_by_fdip, conf_on/off-path, cyc_evicted_from_l1_by_demand_load, cyc_evicted_from_l1_by_FDIP>
   // - prefetched and access time information for timeliness analysis
   unordered_map<Addr, pair<pair<Counter, Flag>, pair<Counter, Counter>>> prefetched_cls_info;
-  // <CL address, sequence of useful/unuseful>
-  unordered_map<Addr, vector<uns8>> useful_sequence;
-  // <CL address, sequence of hit/miss>
-  unordered_map<Addr, vector<uns8>> icache_sequence;
-  // <CL address, all sequence> char - P: prefetch, p: not prefetch, m: icache miss, h: icache hit, U: useful, u:
-  // unuseful (Counter - cycle count)
-  unordered_map<Addr, vector<pair<char, Counter>>> sequence_bw;
-  // <CL address, all sequence> char - P: prefetch, p: not prefetch, m: icache miss, h: icache hit, U: useful, u:
-  // unuseful (Counter - cycle count)
-  unordered_map<Addr, vector<pair<char, Counter>>> sequence_aw;
-  // <CL address, total miss delay>
-  map<Addr, Counter> per_line_delay_aw;
+  // <CL address, per line diagnostics> - at most FDIP_LINE_STATS_MAX_LINES lines
+  unordered_map<Addr, FDIP_Line_Info> line_info;
+  // event sequences of the sampled lines (FDIP_LINE_SEQ_SAMPLE), written as they happen
+  FILE* seq_file;
   Counter cur_line_delay;
   // accumulated FTQ occupancy every cycle
   uint64_t ftq_occupancy_ops;
@@ -381,13 +378,76 @@ Counter fdip_get_last_recover_cycle() {
 }
 
 /* FDIP_Stat member functions */
+FDIP_Line_Info* FDIP_Stat::get_line_info(Addr line_addr) {
+  if (!FDIP_LINE_STATS)
+    return nullptr;
+  auto it = line_info.find(line_addr);
+  if (it != line_info.end())
+    return &it->second;
+  if (FDIP_LINE_STATS_MAX_LINES && line_info.size() >= FDIP_LINE_STATS_MAX_LINES) {
+    STAT_EVENT(fdip->get_proc_id(), FDIP_LINE_STATS_DROPPED);
+    return nullptr;
+  }
+  return &line_info[line_addr];
+}
+
+// Event sequence legend - P: prefetch, p: not prefetch, m: icache miss, h: icache hit, U: useful, u: unuseful,
+// e: evicted after hits, S/s: signed usefulness counter incremented/decremented. The cycle is negative for the
+// events of the off-path.
+void FDIP_Stat::log_event(Addr line_addr, char event, Counter cycle) {
+  if (!FDIP_LINE_SEQ_SAMPLE || (line_addr / ICACHE_LINE_SIZE) % FDIP_LINE_SEQ_SAMPLE)
+    return;
+  if (!seq_file) {
+    char file_name[MAX_STR_LENGTH + 1];
+    snprintf(file_name, MAX_STR_LENGTH + 1, "per_line_seq_core%u.csv", fdip->get_proc_id());
+    seq_file = fopen(file_name, "w");
+    ASSERTM(fdip->get_proc_id(), seq_file, "Could not open %s\n", file_name);
+    fprintf(seq_file, "cl_addr,warmed_up,event,cycle\n");
+  }
+  fprintf(seq_file, "%llx,%u,%c,%lld\n", line_addr, fdip->get_warmed_up(), event, cycle);
+}
+
+void FDIP_Stat::add_event(Addr line_addr, char event, Counter cycle) {
+  FDIP_Line_Info* info = get_line_info(line_addr);
+  if (info) {
+    if (fdip->get_warmed_up()) {
+      if (info->aw_events < 2)
+        info->aw_first[info->aw_events] = event;
+      info->aw_events++;
+    } else {
+      info->bw_events++;
+      if (event == 'p')
+        info->bw_not_prefetched++;
+      else if (event == 'U')
+        info->bw_useful++;
+      else if (event == 'u')
+        info->bw_unuseful++;
+    }
+  }
+  log_event(line_addr, event, cycle);
+}
+
 void FDIP_Stat::print_cl_info(Icache_Stage* ic_ref) {
   uns proc_id = fdip->get_proc_id();
+  map<Addr, Counter> icache_miss;
+  map<Addr, Counter> per_line_delay_aw;
+  Counter unique_hit_lines = 0;
+  for (auto it = line_info.begin(); it != line_info.end(); ++it) {
+    if (it->second.icache_miss)
+      icache_miss.insert(make_pair(it->first, it->second.icache_miss));
+    if (it->second.icache_hit)
+      unique_hit_lines++;
+    if (it->second.delayed_aw)
+      per_line_delay_aw.insert(make_pair(it->first, it->second.delay_aw));
+    if (it->second.aw_events == 2 && it->second.aw_first[0] == 'P' && it->second.aw_first[1] == 'u')
+      STAT_EVENT(proc_id, FDIP_PREFETCH_EVICT_NO_HIT_ONLY_ONCE);
+  }
+
   DEBUG(proc_id,
-        "icache miss cache lines (UNIQUE_MISSED_LINES) size: %lu, icache hit cache lines (UNIQUE_MISSED_LINES): %lu\n",
-        icache_miss.size(), icache_hit.size());
+        "icache miss cache lines (UNIQUE_MISSED_LINES) size: %lu, icache hit cache lines (UNIQUE_MISSED_LINES): %llu\n",
+        icache_miss.size(), unique_hit_lines);
   INC_STAT_EVENT(proc_id, ICACHE_UNIQUE_MISSED_LINES, icache_miss.size());
-  INC_STAT_EVENT(proc_id, ICACHE_UNIQUE_HIT_LINES, icache_hit.size());
+  INC_STAT_EVENT(proc_id, ICACHE_UNIQUE_HIT_LINES, unique_hit_lines);
   multimap<Counter, Addr> icache_miss_sorted = flip_map(icache_miss);
   for (multimap<Counter, Addr>::const_iterator it = icache_miss_sorted.begin(); it != icache_miss_sorted.end(); ++it) {
     DEBUG(proc_id, "[set %u] 0x%llx missed %llu times\n",
@@ -403,6 +463,7 @@ void FDIP_Stat::print_cl_info(Icache_Stage* ic_ref) {
     }
   }
 
+  FDIP_Line_Info no_info = {};
   unordered_map<Addr, int32_t>* cnt_learned_cl = &cnt_useful_signed;
   FILE* fp = fopen("per_line_icache_line_info.csv", "w");
   fprintf(fp, "cl_addr,useful_cnt,unuseful_cnt,prefetch_cnt,new_prefetch_cnt,icache_hit,icache_miss\n");
@@ -410,17 +471,13 @@ void FDIP_Stat::print_cl_info(Icache_Stage* ic_ref) {
     auto cnt_useful_iter = cnt_useful.find(it->first);
     auto cnt_unuseful_iter = cnt_unuseful.find(it->first);
     auto cnt_prefetch_iter = prefetched_cls.find(it->first);
-    auto cnt_new_prefetch_iter = new_prefetched_cls.find(it->first);
-    auto hit_iter = icache_hit.find(it->first);
-    auto miss_iter = icache_miss.find(it->first);
+    auto info_iter = line_info.find(it->first);
+    FDIP_Line_Info* info = (info_iter != line_info.end()) ? &info_iter->second : &no_info;
     Counter _cnt_useful = (cnt_useful_iter != cnt_useful.end()) ? cnt_useful_iter->second.first : 0;
     Counter _cnt_unuseful = (cnt_unuseful_iter != cnt_unuseful.end()) ? cnt_unuseful_iter->second : 0;
     Counter cnt_prefetch = (cnt_prefetch_iter != prefetched_cls.end()) ? cnt_prefetch_iter->second : 0;
-    Counter cnt_new_prefetch = (cnt_new_prefetch_iter != new_prefetched_cls.end()) ? cnt_new_prefetch_iter->second : 0;
-    Counter num_hit = (hit_iter != icache_hit.end()) ? hit_iter->second : 0;
-    Counter num_miss = (miss_iter != icache_miss.end()) ? miss_iter->second : 0;
     fprintf(fp, "%llx,%llu,%llu,%llu,%llu,%llu,%llu\n", it->first, _cnt_useful, _cnt_unuseful, cnt_prefetch,
-            cnt_new_prefetch, num_hit, num_miss);
+            info->new_prefetched, info->icache_hit, info->icache_miss);
     ASSERT(proc_id, (cnt_useful_iter != cnt_useful.end()) || (cnt_unuseful_iter != cnt_unuseful.end()));
   }
   fclose(fp);
@@ -428,66 +485,18 @@ void FDIP_Stat::print_cl_info(Icache_Stage* ic_ref) {
   fp = fopen("per_line_icache_line_info_after_warmup.csv", "w");
   fprintf(fp, "cl_addr,useful_cnt,unuseful_cnt,prefetch_cnt,new_prefetch_cnt,icache_hit,icache_miss\n");
   for (auto it = cnt_useful_signed.begin(); it != cnt_useful_signed.end(); ++it) {
-    auto cnt_useful_iter = cnt_useful_aw.find(it->first);
-    auto cnt_unuseful_iter = cnt_unuseful_aw.find(it->first);
-    auto cnt_prefetch_iter = prefetched_cls_aw.find(it->first);
-    auto cnt_new_prefetch_iter = new_prefetched_cls_aw.find(it->first);
-    auto hit_iter = icache_hit_aw.find(it->first);
-    auto miss_iter = icache_miss_aw.find(it->first);
-    Counter cnt_useful = (cnt_useful_iter != cnt_useful_aw.end()) ? cnt_useful_iter->second.first : 0;
-    Counter cnt_unuseful = (cnt_unuseful_iter != cnt_unuseful_aw.end()) ? cnt_unuseful_iter->second : 0;
-    Counter cnt_prefetch = (cnt_prefetch_iter != prefetched_cls_aw.end()) ? cnt_prefetch_iter->second : 0;
-    Counter cnt_new_prefetch =
-        (cnt_new_prefetch_iter != new_prefetched_cls_aw.end()) ? cnt_new_prefetch_iter->second : 0;
-    Counter num_hit = (hit_iter != icache_hit_aw.end()) ? hit_iter->second : 0;
-    Counter num_miss = (miss_iter != icache_miss_aw.end()) ? miss_iter->second : 0;
-    if (cnt_useful != 0 || cnt_unuseful != 0)
-      fprintf(fp, "%llx,%llu,%llu,%llu,%llu,%llu,%llu\n", it->first, cnt_useful, cnt_unuseful, cnt_prefetch,
-              cnt_new_prefetch, num_hit, num_miss);
+    auto info_iter = line_info.find(it->first);
+    if (info_iter == line_info.end())
+      continue;
+    FDIP_Line_Info* info = &info_iter->second;
+    if (info->useful_aw != 0 || info->unuseful_aw != 0)
+      fprintf(fp, "%llx,%llu,%llu,%llu,%llu,%llu,%llu\n", it->first, info->useful_aw, info->unuseful_aw,
+              info->prefetched_aw, info->new_prefetched_aw, info->icache_hit_aw, info->icache_miss_aw);
   }
   fclose(fp);
 
-  fp = fopen("per_line_useful_seq.csv", "w");
-  fprintf(fp, "cl_addr,seq\n");
-  for (auto it = useful_sequence.begin(); it != useful_sequence.end(); ++it) {
-    fprintf(fp, "%llx", it->first);
-    for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
-      fprintf(fp, ",%u", *it2);
-    }
-    fprintf(fp, "\n");
-  }
-  fclose(fp);
-
-  fp = fopen("per_line_icache_seq.csv", "w");
-  fprintf(fp, "cl_addr,seq\n");
-  for (auto it = icache_sequence.begin(); it != icache_sequence.end(); ++it) {
-    fprintf(fp, "%llx", it->first);
-    for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
-      fprintf(fp, ",%u", *it2);
-    }
-    fprintf(fp, "\n");
-  }
-  fclose(fp);
-
-  fp = fopen("per_line_seq_aw.csv", "w");
-  fprintf(fp, "cl_addr,seq\n");
-  for (auto it = sequence_aw.begin(); it != sequence_aw.end(); ++it) {
-    fprintf(fp, "%llx", it->first);
-    if (it->second.size() == 2) {
-      auto it2 = it->second.begin();
-      if (it2++->first == 'P' && it2->first == 'u')
-        STAT_EVENT(proc_id, FDIP_PREFETCH_EVICT_NO_HIT_ONLY_ONCE);
-    }
-    for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
-      fprintf(fp, ",%c", it2->first);
-    }
-    fprintf(fp, "\n");
-    for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2) {
-      fprintf(fp, ",%lld", it2->second);
-    }
-    fprintf(fp, "\n");
-  }
-  fclose(fp);
+  if (seq_file)
+    fflush(seq_file);
 
   multimap<Counter, Addr> per_line_delay_sorted = flip_map(per_line_delay_aw);
   fp = fopen("per_line_delay.csv", "w");
@@ -506,14 +515,7 @@ void FDIP_Stat::inc_cnt_useful_signed(Addr line_addr) {
   else if (it->second + UDP_WEIGHT_USEFUL <= UDP_WEIGHT_POSITIVE_SATURATION)
     it->second += UDP_WEIGHT_USEFUL;
 
-  uns8 useful_value = fdip->get_warmed_up() ? 3 : 1;
-  auto it2 = useful_sequence.find(line_addr);
-  if (it2 == useful_sequence.end()) {
-    useful_sequence.insert(make_pair(line_addr, vector<uns8>()));
-    useful_sequence[line_addr].push_back(useful_value);
-  } else {
-    it2->second.push_back(useful_value);
-  }
+  log_event(line_addr, 'S', cycle_count);
 }
 
 void FDIP_Stat::inc_cnt_unuseful(Addr line_addr) {
@@ -526,29 +528,10 @@ void FDIP_Stat::inc_cnt_unuseful(Addr line_addr) {
     unuseful_iter->second++;
   }
 
-  if (fdip->get_warmed_up()) {
-    auto it = cnt_unuseful_aw.find(line_addr);
-    if (it == cnt_unuseful_aw.end())
-      cnt_unuseful_aw.insert(make_pair(move(line_addr), 1));
-    else
-      it->second++;
-
-    auto it2 = sequence_aw.find(line_addr);
-    if (it2 == sequence_aw.end()) {
-      sequence_aw.insert(make_pair(line_addr, vector<pair<char, Counter>>()));
-      sequence_aw[line_addr].push_back(make_pair('u', cycle_count));
-    } else {
-      it2->second.push_back(make_pair('u', cycle_count));
-    }
-  } else {
-    auto it2 = sequence_bw.find(line_addr);
-    if (it2 == sequence_bw.end()) {
-      sequence_bw.insert(make_pair(line_addr, vector<pair<char, Counter>>()));
-      sequence_bw[line_addr].push_back(make_pair('u', cycle_count));
-    } else {
-      it2->second.push_back(make_pair('u', cycle_count));
-    }
-  }
+  FDIP_Line_Info* info = get_line_info(line_addr);
+  if (info && fdip->get_warmed_up())
+    info->unuseful_aw++;
+  add_event(line_addr, 'u', cycle_count);
 }
 
 void FDIP_Stat::inc_cnt_useful(Addr line_addr, Flag pref_miss) {
@@ -565,31 +548,10 @@ void FDIP_Stat::inc_cnt_useful(Addr line_addr, Flag pref_miss) {
   }
   DEBUG(proc_id, "cnt_useful size after inserted %ld\n", cnt_useful.size());
 
-  if (fdip->get_warmed_up()) {
-    auto it = cnt_useful_aw.find(line_addr);
-    if (it == cnt_useful_aw.end())
-      cnt_useful_aw.insert(make_pair(move(line_addr), make_pair(1, pref_miss)));
-    else {
-      it->second.first++;
-      it->second.second = pref_miss;
-    }
-
-    auto it2 = sequence_aw.find(line_addr);
-    if (it2 == sequence_aw.end()) {
-      sequence_aw.insert(make_pair(line_addr, vector<pair<char, Counter>>()));
-      sequence_aw[line_addr].push_back(make_pair('U', cycle_count));
-    } else {
-      it2->second.push_back(make_pair('U', cycle_count));
-    }
-  } else {
-    auto iter = sequence_bw.find(line_addr);
-    if (iter == sequence_bw.end()) {
-      sequence_bw.insert(make_pair(line_addr, vector<pair<char, Counter>>()));
-      sequence_bw[line_addr].push_back(make_pair('U', cycle_count));
-    } else {
-      iter->second.push_back(make_pair('U', cycle_count));
-    }
-  }
+  FDIP_Line_Info* info = get_line_info(line_addr);
+  if (info && fdip->get_warmed_up())
+    info->useful_aw++;
+  add_event(line_addr, 'U', cycle_count);
 }
 
 void FDIP_Stat::probe_prefetched_cls(Addr line_addr) {
@@ -599,95 +561,36 @@ void FDIP_Stat::probe_prefetched_cls(Addr line_addr) {
 }
 
 void FDIP_Stat::not_prefetch(Addr line_addr) {
-  if (fdip->get_warmed_up()) {
-    auto it = sequence_aw.find(line_addr);
-    Counter onoff_cycle_count = fdip_off_path() ? -cycle_count : cycle_count;
-    if (it == sequence_aw.end()) {
-      sequence_aw.insert(make_pair(line_addr, vector<pair<char, Counter>>()));
-      sequence_aw[line_addr].push_back(make_pair('p', onoff_cycle_count));
-    } else {
-      it->second.push_back(make_pair('p', onoff_cycle_count));
-    }
-  } else {
-    auto it = sequence_bw.find(line_addr);
-    Counter onoff_cycle_count = fdip_off_path() ? -cycle_count : cycle_count;
-    if (it == sequence_bw.end()) {
-      sequence_bw.insert(make_pair(line_addr, vector<pair<char, Counter>>()));
-      sequence_bw[line_addr].push_back(make_pair('p', onoff_cycle_count));
-    } else {
-      it->second.push_back(make_pair('p', onoff_cycle_count));
-    }
-  }
+  add_event(line_addr, 'p', fdip_off_path() ? -cycle_count : cycle_count);
 }
 
 void FDIP_Stat::inc_icache_miss(Addr line_addr) {
   uns proc_id = fdip->get_proc_id();
-  auto cl_iter = icache_miss.find(line_addr);
-  if (cl_iter == icache_miss.end()) {
-    STAT_EVENT(proc_id, UNIQUE_MISSED_LINES);
-    icache_miss.insert(pair<Addr, Counter>(line_addr, 1));
-  } else
-    cl_iter->second++;
-
-  if (fdip->get_warmed_up()) {
-    auto it = icache_miss_aw.find(line_addr);
-    if (it == icache_miss_aw.end())
-      icache_miss_aw.insert(pair<Addr, Counter>(line_addr, 1));
-    else
-      it->second++;
-
-    auto it2 = sequence_aw.find(line_addr);
-    if (it2 == sequence_aw.end()) {
-      sequence_aw.insert(make_pair(line_addr, vector<pair<char, Counter>>()));
-      sequence_aw[line_addr].push_back(make_pair('m', cycle_count));
-    } else {
-      it2->second.push_back(make_pair('m', cycle_count));
-    }
-
-    cur_line_delay = cycle_count;
-  } else {
-    auto it2 = sequence_bw.find(line_addr);
-    if (it2 == sequence_bw.end()) {
-      sequence_bw.insert(make_pair(line_addr, vector<pair<char, Counter>>()));
-      sequence_bw[line_addr].push_back(make_pair('m', cycle_count));
-    } else {
-      it2->second.push_back(make_pair('m', cycle_count));
-    }
+  Flag warmed_up = fdip->get_warmed_up();
+  FDIP_Line_Info* info = get_line_info(line_addr);
+  Flag first_access = info && !info->icache_hit && !info->icache_miss;
+  if (info) {
+    if (!info->icache_miss)
+      STAT_EVENT(proc_id, UNIQUE_MISSED_LINES);
+    info->icache_miss++;
+    if (warmed_up)
+      info->icache_miss_aw++;
   }
-
-  uns icache_val = fdip->get_warmed_up() ? 2 : 0;
-  auto it = icache_sequence.find(line_addr);
-  if (it == icache_sequence.end()) {
-    icache_sequence.insert(make_pair(line_addr, vector<uns8>()));
-    icache_sequence[line_addr].push_back(icache_val);
-    if (icache_val == 2) {
-      auto it2 = sequence_bw.find(line_addr);
-      if (it2 != sequence_bw.end()) {
-        STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_SEEN_DURING_WARMUP);
-        Counter no_pref = 0;
-        Counter unuseful = 0;
-        Counter useful = 0;
-        auto it3 = it2->second.begin();
-        while (it3 != it2->second.end()) {
-          if (it3->first == 'p')
-            no_pref++;
-          else if (it3->first == 'u')
-            useful++;
-          else if (it3->first == 'U')
-            unuseful++;
-          ++it3;
-        }
-        if (no_pref && !unuseful && !useful)
-          STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_NO_PREF_DURING_WARMUP);
-        if (!no_pref && unuseful && !useful)
-          STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_TRAINED_UNUSEFUL_DURING_WARMUP);
-        if (!no_pref && !unuseful && useful)
-          STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_TRAINED_USEFUL_DURING_WARMUP);
-      } else
-        STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_NOT_SEEN_DURING_WARMUP);
-    }
-  } else {
-    it->second.push_back(icache_val);
+  if (warmed_up)
+    cur_line_delay = cycle_count;
+  add_event(line_addr, 'm', cycle_count);
+
+  if (first_access && warmed_up) {
+    if (info->bw_events) {
+      STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_SEEN_DURING_WARMUP);
+      if (info->bw_not_prefetched && !info->bw_unuseful && !info->bw_useful)
+        STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_NO_PREF_DURING_WARMUP);
+      if (!info->bw_not_prefetched && info->bw_unuseful && !info->bw_useful)
+        STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_TRAINED_UNUSEFUL_DURING_WARMUP);
+      if (!info->bw_not_prefetched && !info->bw_unuseful && info->bw_useful)
+        STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_TRAINED_USEFUL_DURING_WARMUP);
+    } else
+      STAT_EVENT(proc_id, ICACHE_FIRST_MISS_AFTER_WARMUP_NOT_SEEN_DURING_WARMUP);
   }
 }
 
@@ -709,47 +612,16 @@ void FDIP_Stat::inc_prefetched_cls(Addr line_addr, Flag on_path, uns success) {
           cycle_count);
   }
 
-  if (success == Mem_Queue_Req_Result::SUCCESS_NEW) {
-    auto cl_new_iter = new_prefetched_cls.find(line_addr);
-    if (cl_new_iter == new_prefetched_cls.end())
-      new_prefetched_cls.insert(pair<Addr, Counter>(line_addr, 1));
-    else
-      cl_new_iter->second++;
-  }
-
-  if (fdip->get_warmed_up()) {
-    auto it = prefetched_cls_aw.find(line_addr);
-    if (it == prefetched_cls_aw.end())
-      prefetched_cls_aw.insert(pair<Addr, Counter>(line_addr, 1));
-    else
-      it->second++;
-
-    if (success == Mem_Queue_Req_Result::SUCCESS_NEW) {
-      it = new_prefetched_cls_aw.find(line_addr);
-      if (it == new_prefetched_cls_aw.end())
-        new_prefetched_cls_aw.insert(pair<Addr, Counter>(line_addr, 1));
-      else
-        it->second++;
-    }
-
-    auto it2 = sequence_aw.find(line_addr);
-    Counter onoff_cycle_count = fdip_off_path() ? -cycle_count : cycle_count;
-    if (it2 == sequence_aw.end()) {
-      sequence_aw.insert(make_pair(line_addr, vector<pair<char, Counter>>()));
-      sequence_aw[line_addr].push_back(make_pair('P', onoff_cycle_count));
-    } else {
-      it2->second.push_back(make_pair('P', onoff_cycle_count));
-    }
-  } else {
-    auto it2 = sequence_bw.find(line_addr);
-    Counter onoff_cycle_count = fdip_off_path() ? -cycle_count : cycle_count;
-    if (it2 == sequence_bw.end()) {
-      sequence_bw.insert(make_pair(line_addr, vector<pair<char, Counter>>()));
-      sequence_bw[line_addr].push_back(make_pair('P', onoff_cycle_count));
-    } else {
-      it2->second.push_back(make_pair('P', onoff_cycle_count));
+  FDIP_Line_Info* info = get_line_info(line_addr);
+  if (info) {
+    Flag new_prefetch = success == Mem_Queue_Req_Result::SUCCESS_NEW;
+    info->new_prefetched += new_prefetch;
+    if (fdip->get_warmed_up()) {
+      info->prefetched_aw++;
+      info->new_prefetched_aw += new_prefetch;
     }
   }
+  add_event(line_addr, 'P', fdip_off_path() ? -cycle_count : cycle_count);
 }
 
 void FDIP_Stat::dec_cnt_useful_signed(Addr line_addr) {
@@ -759,66 +631,27 @@ void FDIP_Stat::dec_cnt_useful_signed(Addr line_addr) {
   else
     it->second -= UDP_WEIGHT_UNUSEFUL;
 
-  uns8 unuseful_value = fdip->get_warmed_up() ? 2 : 0;
-  auto it2 = useful_sequence.find(line_addr);
-  if (it2 == useful_sequence.end()) {
-    useful_sequence.insert(make_pair(line_addr, vector<uns8>()));
-    useful_sequence[line_addr].push_back(unuseful_value);
-  } else {
-    it2->second.push_back(unuseful_value);
-  }
+  log_event(line_addr, 's', cycle_count);
 }
 
 void FDIP_Stat::inc_icache_hit(Addr line_addr) {
-  auto cl_iter = icache_hit.find(line_addr);
-  if (cl_iter == icache_hit.end()) {
-    STAT_EVENT(fdip->get_proc_id(), UNIQUE_HIT_LINES);
-    icache_hit.insert(pair<Addr, Counter>(line_addr, 1));
-  } else
-    cl_iter->second++;
-
-  if (fdip->get_warmed_up()) {
-    auto it = icache_hit_aw.find(line_addr);
-    if (it == icache_hit_aw.end())
-      icache_hit_aw.insert(pair<Addr, Counter>(line_addr, 1));
-    else
-      it->second++;
-
-    auto it2 = sequence_aw.find(line_addr);
-    if (it2 == sequence_aw.end()) {
-      sequence_aw.insert(make_pair(line_addr, vector<pair<char, Counter>>()));
-      sequence_aw[line_addr].push_back(make_pair('h', cycle_count));
-    } else {
-      it2->second.push_back(make_pair('h', cycle_count));
-    }
-
-    if (cur_line_delay) {
-      auto it3 = per_line_delay_aw.find(line_addr);
-      if (it3 == per_line_delay_aw.end()) {
-        per_line_delay_aw.insert(make_pair(line_addr, cycle_count - cur_line_delay));
-      } else {
-        it3->second += cycle_count - cur_line_delay;
+  Flag warmed_up = fdip->get_warmed_up();
+  FDIP_Line_Info* info = get_line_info(line_addr);
+  if (info) {
+    if (!info->icache_hit)
+      STAT_EVENT(fdip->get_proc_id(), UNIQUE_HIT_LINES);
+    info->icache_hit++;
+    if (warmed_up) {
+      info->icache_hit_aw++;
+      if (cur_line_delay) {
+        info->delay_aw += cycle_count - cur_line_delay;
+        info->delayed_aw = TRUE;
       }
     }
-    cur_line_delay = 0;
-  } else {
-    auto it2 = sequence_bw.find(line_addr);
-    if (it2 == sequence_bw.end()) {
-      sequence_bw.insert(make_pair(line_addr, vector<pair<char, Counter>>()));
-      sequence_bw[line_addr].push_back(make_pair('h', cycle_count));
-    } else {
-      it2->second.push_back(make_pair('h', cycle_count));
-    }
-  }
-
-  uns icache_val = fdip->get_warmed_up() ? 3 : 1;
-  auto it = icache_sequence.find(line_addr);
-  if (it == icache_sequence.end()) {
-    icache_sequence.insert(make_pair(line_addr, vector<uns8>()));
-    icache_sequence[line_addr].push_back(icache_val);
-  } else {
-    it->second.push_back(icache_val);
   }
+  if (warmed_up)
+    cur_line_delay = 0;
+  add_event(line_addr, 'h', cycle_count);
 }
 
 /* FDIP member functions */
@@ -1055,14 +888,7 @@ void FDIP::inc_prefetched_cls(Addr line_addr, uns success, Flag conf_off_path) {
 }
 
 void FDIP::inc_off_fetched_cls(Addr line_addr) {
-  auto cl_iter = fdip_stat.off_fetched_cls.find(line_addr);
-  if (cl_iter == fdip_stat.off_fetched_cls.end()) {
-    fdip_stat.off_fetched_cls.insert(pair<Addr, Counter>(line_addr, cycle_count));
-    DEBUG(proc_id, "%llx inserted into off_fetched_cls at %llu\n", line_addr, cycle_count);
-  } else {
-    cl_iter->second = cycle_count;
-    DEBUG(proc_id, "%llx in off_fetched_cls updated at %llu\n", line_addr, cycle_count);
-  }
+  DEBUG(proc_id, "%llx fetched on the off-path at %llu\n", line_addr, cycle_count);
 }
 
 void FDIP::evict_prefetched_cls(Addr line_addr, Flag by_fdip) {
@@ -1424,23 +1250,7 @@ void FDIP::assert_break_reason(Addr line_addr) {
 }
 
 void FDIP::add_evict_seq(Addr line_addr) {
-  if (warmed_up) {
-    auto it2 = fdip_stat.sequence_aw.find(line_addr);
-    if (it2 == fdip_stat.sequence_aw.end()) {
-      fdip_stat.sequence_aw.insert(make_pair(line_addr, vector<pair<char, Counter>>()));
-      fdip_stat.sequence_aw[line_addr].push_back(make_pair('e', cycle_count));
-    } else {
-      it2->second.push_back(make_pair('e', cycle_count));
-    }
-  } else {
-    auto it2 = fdip_stat.sequence_bw.find(line_addr);
-    if (it2 == fdip_stat.sequence_bw.end()) {
-      fdip_stat.sequence_bw.insert(make_pair(line_addr, vector<pair<char, Counter>>()));
-      fdip_stat.sequence_bw[line_addr].push_back(make_pair('e', cycle_count));
-    } else {
-      it2->second.push_back(make_pair('e', cycle_count));
-    }
-  }
+  fdip_stat.add_event(line_addr, 'e', cycle_count);
 }
 
 void FDIP::log_stats_path_conf_per_pref_candidate() {
@@ -91,6 +91,12 @@ FILE* PREF_DEGFB_FILE;
 
 static void pref_core_init(HWP_Core* pref_core);
 static void pref_update_core(uns proc_id);
+static int pref_queue_find_valid(Hash_Table* index, Pref_Mem_Req* queue, uns size, Addr line_index);
+static void pref_queue_write(Hash_Table* index, Pref_Mem_Req* queue, uns slot, Pref_Mem_Req* req);
+static void pref_queue_invalidate(Hash_Table* index, Pref_Mem_Req* queue, uns slot);
+static void pref_train(Pref_Train_Type type, uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_hist);
+static void pref_train_hwp(HWP* hwp, Pref_Train_Event const* event);
+static void pref_train_buffered(HWP_Core* pref_core);
 static void pref_polbv_update_on_evict(uns8 pref_proc_id, uns8 evicted_proc_id, Addr evicted_addr);
 static void pref_polbv_lookup_on_miss(uns8 proc_id, Addr addr);
 static void pref_polbv_update_on_repref(uns8 proc_id, Addr addr);
@@ -123,6 +129,175 @@ void pref_core_init(HWP_Core* pref_core) {
 
   pref_core->ul1req_queue_req_pos = -1;
   pref_core->ul1req_queue_send_pos = 0;
+
+  init_hash_table(&pref_core->dl0req_queue_index, "dl0req queue index", PREF_DL0REQ_QUEUE_SIZE,
+                  sizeof(Pref_Queue_Line));
+  init_hash_table(&pref_core->umlc_req_queue_index, "umlc req queue index", PREF_UMLC_REQ_QUEUE_SIZE,
+                  sizeof(Pref_Queue_Line));
+  init_hash_table(&pref_core->ul1req_queue_index, "ul1req queue index", PREF_UL1REQ_QUEUE_SIZE,
+                  sizeof(Pref_Queue_Line));
+}
+
+/**************************************************************************************/
+/* pref_queue_find_valid: the lowest valid slot of a request queue that holds
+   line_index, or -1. The index answers directly unless the line is in several slots,
+   which only happens when duplicates are not filtered on insertion. */
+
+static int pref_queue_find_valid(Hash_Table* index, Pref_Mem_Req* queue, uns size, Addr line_index) {
+  Pref_Queue_Line* line = (Pref_Queue_Line*)hash_table_access(index, line_index);
+  if (!line || !line->valid)
+    return -1;
+  if (line->count == 1)
+    return line->slot;
+  for (uns ii = 0; ii < size; ii++) {
+    if (queue[ii].valid && queue[ii].line_index == line_index)
+      return ii;
+  }
+  ASSERT(0, FALSE);
+  return -1;
+}
+
+/**************************************************************************************/
+/* pref_queue_write: overwrite a slot of a request queue, keeping its index up to date.
+   Line 0 (the empty slots) is not indexed, it is never looked up. */
+
+static void pref_queue_write(Hash_Table* index, Pref_Mem_Req* queue, uns slot, Pref_Mem_Req* req) {
+  Pref_Mem_Req* old_req = &queue[slot];
+  if (old_req->line_index) {
+    Pref_Queue_Line* line = (Pref_Queue_Line*)hash_table_access(index, old_req->line_index);
+    ASSERT(0, line && line->count && line->valid <= line->count);
+    line->valid -= old_req->valid;
+    if (--line->count == 0)
+      hash_table_access_delete(index, old_req->line_index);
+  }
+  *old_req = *req;
+  if (req->line_index) {
+    Flag new_entry;
+    Pref_Queue_Line* line = (Pref_Queue_Line*)hash_table_access_create(index, req->line_index, &new_entry);
+    if (new_entry)
+      memset(line, 0, sizeof(Pref_Queue_Line));
+    line->count++;
+    line->valid += req->valid;
+    line->slot = slot;
+  }
+}
+
+/**************************************************************************************/
+/* pref_queue_invalidate: invalidate a slot of a request queue (it keeps its line) */
+
+static void pref_queue_invalidate(Hash_Table* index, Pref_Mem_Req* queue, uns slot) {
+  if (queue[slot].valid && queue[slot].line_index) {
+    Pref_Queue_Line* line = (Pref_Queue_Line*)hash_table_access(index, queue[slot].line_index);
+    ASSERT(0, line && line->valid);
+    line->valid--;
+  }
+  queue[slot].valid = FALSE;
+}
+
+/**************************************************************************************/
+/* pref_train: hand a training event to the enabled prefetchers, or buffer it until the
+   next pref_update when PREF_BATCH_TRAINING is on. The framework's own bookkeeping
+   (traces, pollution and usefulness counters) is done by the callers right away
+   either way, only the prefetchers' training is deferred. */
+
+static void pref_train(Pref_Train_Type type, uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_hist) {
+  Pref_Train_Event event = {type, proc_id, line_addr, load_PC, global_hist};
+
+  if (!PREF_BATCH_TRAINING) {
+    for (int ii = 0; ii < pref_table_size; ii++) {
+      if (pref_table[ii].hwp_info->enabled)
+        pref_train_hwp(&pref_table[ii], &event);
+    }
+    return;
+  }
+
+  HWP_Core* pref_core = pref.cores[proc_id];
+  if (pref_core->num_train_events == pref_core->train_events_size) {
+    pref_core->train_events_size = pref_core->train_events_size ? 2 * pref_core->train_events_size : 64;
+    pref_core->train_events = (Pref_Train_Event*)realloc(pref_core->train_events, pref_core->train_events_size *
+                                                                                      sizeof(Pref_Train_Event));
+    ASSERT(proc_id, pref_core->train_events);
+  }
+  pref_core->train_events[pref_core->num_train_events++] = event;
+}
+
+/**************************************************************************************/
+/* pref_train_hwp: train one prefetcher on one event */
+
+static void pref_train_hwp(HWP* hwp, Pref_Train_Event const* event) {
+  if (hwp->train_batch_func) {
+    hwp->train_batch_func(event, 1);
+    return;
+  }
+
+  switch (event->type) {
+    case PREF_TRAIN_DL0_MISS:
+      if (hwp->dl0_miss_func)
+        hwp->dl0_miss_func(event->line_addr, event->load_PC);
+      break;
+    case PREF_TRAIN_DL0_HIT:
+      if (hwp->dl0_hit_func)
+        hwp->dl0_hit_func(event->line_addr, event->load_PC);
+      break;
+    case PREF_TRAIN_DL0_PREF_HIT:
+      if (hwp->dl0_pref_hit)
+        hwp->dl0_pref_hit(event->line_addr, event->load_PC);
+      break;
+    case PREF_TRAIN_UMLC_MISS:
+      if (hwp->umlc_miss_func)
+        hwp->umlc_miss_func(event->proc_id, event->line_addr, event->load_PC, event->global_hist);
+      break;
+    case PREF_TRAIN_UMLC_HIT:
+      if (hwp->umlc_hit_func)
+        hwp->umlc_hit_func(event->proc_id, event->line_addr, event->load_PC, event->global_hist);
+      break;
+    case PREF_TRAIN_UMLC_PREF_HIT:
+      if (hwp->umlc_pref_hit)
+        hwp->umlc_pref_hit(event->proc_id, event->line_addr, event->load_PC, event->global_hist);
+      break;
+    case PREF_TRAIN_UL1_MISS:
+      if (hwp->ul1_miss_func)
+        hwp->ul1_miss_func(event->proc_id, event->line_addr, event->load_PC, event->global_hist);
+      break;
+    case PREF_TRAIN_UL1_HIT:
+      if (hwp->ul1_hit_func)
+        hwp->ul1_hit_func(event->proc_id, event->line_addr, event->load_PC, event->global_hist);
+      break;
+    case PREF_TRAIN_UL1_PREF_HIT:
+      if (hwp->ul1_pref_hit)
+        hwp->ul1_pref_hit(event->proc_id, event->line_addr, event->load_PC, event->global_hist);
+      break;
+    default:
+      FATAL_ERROR(event->proc_id, "Unknown prefetcher training event %d\n", event->type);
+  }
+}
+
+/**************************************************************************************/
+/* pref_train_buffered: train the prefetchers on the events a core buffered since the
+   last pref_update. The buffer is walked once per prefetcher, in priority order, so
+   each prefetcher sees the events in the order they happened but the prefetches of
+   one prefetcher are queued before those of the next (with per event training they
+   interleave). */
+
+static void pref_train_buffered(HWP_Core* pref_core) {
+  uns num = pref_core->num_train_events;
+  if (num == 0)
+    return;
+
+  for (int ii = 0; ii < pref_table_size; ii++) {
+    HWP* hwp = &pref_table[ii];
+    if (!hwp->hwp_info->enabled)
+      continue;
+    if (hwp->train_batch_func) {
+      hwp->train_batch_func(pref_core->train_events, num);
+    } else {
+      for (uns jj = 0; jj < num; jj++)
+        pref_train_hwp(hwp, &pref_core->train_events[jj]);
+    }
+  }
+  STAT_EVENT(0, PREF_TRAIN_BATCHES);
+  INC_STAT_EVENT(0, PREF_TRAIN_BATCHED_EVENTS, num);
+  pref_core->num_train_events = 0;
 }
 
 void pref_init(void) {
@@ -246,51 +421,32 @@ void pref_done(void) {
 
 // FIXME LATER
 void pref_dl0_miss(Addr line_addr, Addr load_PC) {
-  int ii;
   if (!PREF_FRAMEWORK_ON)
     return;
-  if (PREF_DL0_MISS_ON) {
-    for (ii = 0; ii < pref_table_size; ii++) {
-      if (pref_table[ii].hwp_info->enabled && pref_table[ii].dl0_miss_func) {
-        pref_table[ii].dl0_miss_func(line_addr, load_PC);
-      }
-    }
-  }
+  if (PREF_DL0_MISS_ON)
+    pref_train(PREF_TRAIN_DL0_MISS, get_proc_id_from_cmp_addr(line_addr), line_addr, load_PC, 0);
 }
 
 // FIXME LATER
 void pref_dl0_hit(Addr line_addr, Addr load_PC) {
-  int ii;
   if (!PREF_FRAMEWORK_ON)
     return;
-  if (PREF_DL0_HIT_ON) {
-    for (ii = 0; ii < pref_table_size; ii++) {
-      if (pref_table[ii].hwp_info->enabled && pref_table[ii].dl0_hit_func) {
-        pref_table[ii].dl0_hit_func(line_addr, load_PC);
-      }
-    }
-  }
+  if (PREF_DL0_HIT_ON)
+    pref_train(PREF_TRAIN_DL0_HIT, get_proc_id_from_cmp_addr(line_addr), line_addr, load_PC, 0);
 }
 
 // FIXME LATER
 void pref_dl0_pref_hit(Addr line_addr, Addr load_PC, uns8 prefetcher_id) {
-  int ii;
   if (!PREF_FRAMEWORK_ON)
     return;
   if (prefetcher_id == 0)
     return;
 
-  if (PREF_DL0_HIT_ON) {
-    for (ii = 0; ii < pref_table_size; ii++) {
-      if (pref_table[ii].hwp_info->enabled && pref_table[ii].dl0_pref_hit) {
-        pref_table[ii].dl0_pref_hit(line_addr, load_PC);
-      }
-    }
-  }
+  if (PREF_DL0_HIT_ON)
+    pref_train(PREF_TRAIN_DL0_PREF_HIT, get_proc_id_from_cmp_addr(line_addr), line_addr, load_PC, 0);
 }
 
 void pref_umlc_miss(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_hist) {
-  int ii;
   if (!PREF_FRAMEWORK_ON)
     return;
   if (!PREF_UMLC_ON || !MLC_PRESENT)
@@ -306,15 +462,10 @@ void pref_umlc_miss(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_his
     pref_polbv_lookup_on_miss(proc_id, line_addr);
   }
 
-  for (ii = 0; ii < pref_table_size; ii++) {
-    if (pref_table[ii].hwp_info->enabled && pref_table[ii].umlc_miss_func) {
-      pref_table[ii].umlc_miss_func(proc_id, line_addr, load_PC, global_hist);
-    }
-  }
+  pref_train(PREF_TRAIN_UMLC_MISS, proc_id, line_addr, load_PC, global_hist);
 }
 
 void pref_umlc_hit(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_hist) {
-  int ii;
   if (!PREF_FRAMEWORK_ON)
     return;
   if (!PREF_UMLC_ON || !MLC_PRESENT)
@@ -323,11 +474,7 @@ void pref_umlc_hit(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_hist
     fprintf(PREF_TRACE_OUT, "%s \t %s \t %s \t %s\n", hexstr64s(cycle_count), hexstr64s(0), hexstr64s(line_addr),
             "UMLC_HIT");
 
-  for (ii = 0; ii < pref_table_size; ii++) {
-    if (pref_table[ii].hwp_info->enabled && pref_table[ii].umlc_hit_func) {
-      pref_table[ii].umlc_hit_func(proc_id, line_addr, load_PC, global_hist);
-    }
-  }
+  pref_train(PREF_TRAIN_UMLC_HIT, proc_id, line_addr, load_PC, global_hist);
 }
 
 void pref_umlc_pref_hit_late(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_hist, uns8 prefetcher_id) {
@@ -344,7 +491,6 @@ void pref_umlc_pref_hit_late(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 g
 
 void pref_umlc_pref_hit(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_hist, int lru_position,
                         uns8 prefetcher_id) {
-  int ii;
   if (prefetcher_id == 0)
     return;
 
@@ -359,15 +505,10 @@ void pref_umlc_pref_hit(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global
 
   pref_table[prefetcher_id].hwp_info->curr_useful_core[proc_id]++;
 
-  for (ii = 0; ii < pref_table_size; ii++) {
-    if (pref_table[ii].hwp_info->enabled && pref_table[ii].umlc_pref_hit) {
-      pref_table[ii].umlc_pref_hit(proc_id, line_addr, load_PC, global_hist);
-    }
-  }
+  pref_train(PREF_TRAIN_UMLC_PREF_HIT, proc_id, line_addr, load_PC, global_hist);
 }
 
 void pref_ul1_miss(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_hist) {
-  int ii;
   if (!PREF_FRAMEWORK_ON)
     return;
   if (!PREF_UL1_ON)
@@ -388,15 +529,10 @@ void pref_ul1_miss(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_hist
     pref_polbv_lookup_on_miss(proc_id, line_addr);
   }
 
-  for (ii = 0; ii < pref_table_size; ii++) {
-    if (pref_table[ii].hwp_info->enabled && pref_table[ii].ul1_miss_func) {
-      pref_table[ii].ul1_miss_func(proc_id, line_addr, load_PC, global_hist);
-    }
-  }
+  pref_train(PREF_TRAIN_UL1_MISS, proc_id, line_addr, load_PC, global_hist);
 }
 
 void pref_ul1_hit(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_hist) {
-  int ii;
   if (!PREF_FRAMEWORK_ON)
     return;
   if (!PREF_UL1_ON)
@@ -407,11 +543,7 @@ void pref_ul1_hit(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_hist)
     fprintf(PREF_TRACE_OUT, "%s \t %s \t %s \t %s\n", hexstr64s(cycle_count), hexstr64s(0), hexstr64s(line_addr),
             "UL1_HIT");
 
-  for (ii = 0; ii < pref_table_size; ii++) {
-    if (pref_table[ii].hwp_info->enabled && pref_table[ii].ul1_hit_func) {
-      pref_table[ii].ul1_hit_func(proc_id, line_addr, load_PC, global_hist);
-    }
-  }
+  pref_train(PREF_TRAIN_UL1_HIT, proc_id, line_addr, load_PC, global_hist);
 }
 
 void pref_ul1_pref_hit_late(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_hist, uns8 prefetcher_id) {
@@ -432,7 +564,6 @@ void pref_ul1_pref_hit_late(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 gl
 
 void pref_ul1_pref_hit(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_hist, int lru_position,
                        uns8 prefetcher_id) {
-  int ii;
   if (prefetcher_id == 0)
     return;
 
@@ -447,87 +578,65 @@ void pref_ul1_pref_hit(uns8 proc_id, Addr line_addr, Addr load_PC, uns32 global_
 
   pref_table[prefetcher_id].hwp_info->curr_useful_core[proc_id]++;
 
-  for (ii = 0; ii < pref_table_size; ii++) {
-    if (pref_table[ii].hwp_info->enabled && pref_table[ii].ul1_pref_hit) {
-      pref_table[ii].ul1_pref_hit(proc_id, line_addr, load_PC, global_hist);
-    }
-  }
+  pref_train(PREF_TRAIN_UL1_PREF_HIT, proc_id, line_addr, load_PC, global_hist);
 }
 
 Flag pref_dl0req_queue_filter(Addr line_addr) {
   if (!PREF_DL0REQ_QUEUE_FILTER_ON)
     return FALSE;
-  uns proc_id = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* dl0req_queue = pref.cores[proc_id]->dl0req_queue;
-  for (uns ii = 0; ii < PREF_DL0REQ_QUEUE_SIZE; ii++) {
-    if (dl0req_queue[ii].valid &&
-        (dl0req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) == (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      dl0req_queue[ii].valid = FALSE;
-      STAT_EVENT(0, PREF_DL0REQ_QUEUE_HIT_BY_DEMAND);
-      return TRUE;
-    }
-  }
-  return FALSE;
+  HWP_Core* pref_core = pref.cores[get_proc_id_from_cmp_addr(line_addr)];
+  int slot = pref_queue_find_valid(&pref_core->dl0req_queue_index, pref_core->dl0req_queue, PREF_DL0REQ_QUEUE_SIZE,
+                                   line_addr >> LOG2(DCACHE_LINE_SIZE));
+  if (slot < 0)
+    return FALSE;
+  pref_queue_invalidate(&pref_core->dl0req_queue_index, pref_core->dl0req_queue, slot);
+  STAT_EVENT(0, PREF_DL0REQ_QUEUE_HIT_BY_DEMAND);
+  return TRUE;
 }
 
 Flag pref_umlc_req_queue_filter(Addr line_addr) {
   if (!PREF_UMLC_REQ_QUEUE_FILTER_ON)
     return FALSE;
-  uns proc_id = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* umlc_req_queue = pref.cores[proc_id]->umlc_req_queue;
-  for (uns ii = 0; ii < PREF_UMLC_REQ_QUEUE_SIZE; ii++) {
-    if (umlc_req_queue[ii].valid &&
-        (umlc_req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) == (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      umlc_req_queue[ii].valid = FALSE;
-      STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_HIT_BY_DEMAND);
-      return TRUE;
-    }
-  }
-  return FALSE;
+  HWP_Core* pref_core = pref.cores[get_proc_id_from_cmp_addr(line_addr)];
+  int slot = pref_queue_find_valid(&pref_core->umlc_req_queue_index, pref_core->umlc_req_queue,
+                                   PREF_UMLC_REQ_QUEUE_SIZE, line_addr >> LOG2(DCACHE_LINE_SIZE));
+  if (slot < 0)
+    return FALSE;
+  pref_queue_invalidate(&pref_core->umlc_req_queue_index, pref_core->umlc_req_queue, slot);
+  STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_HIT_BY_DEMAND);
+  return TRUE;
 }
 
 Flag pref_ul1req_queue_filter(Addr line_addr) {
   if (!PREF_UL1REQ_QUEUE_FILTER_ON)
     return FALSE;
-  uns proc_id = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* ul1req_queue = pref.cores[proc_id]->ul1req_queue;
-  for (uns ii = 0; ii < PREF_UL1REQ_QUEUE_SIZE; ii++) {
-    if (ul1req_queue[ii].valid &&
-        (ul1req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) == (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      ul1req_queue[ii].valid = FALSE;
-      STAT_EVENT(0, PREF_UL1REQ_QUEUE_HIT_BY_DEMAND);
-      return TRUE;
-    }
-  }
-  return FALSE;
+  HWP_Core* pref_core = pref.cores[get_proc_id_from_cmp_addr(line_addr)];
+  int slot = pref_queue_find_valid(&pref_core->ul1req_queue_index, pref_core->ul1req_queue, PREF_UL1REQ_QUEUE_SIZE,
+                                   line_addr >> LOG2(DCACHE_LINE_SIZE));
+  if (slot < 0)
+    return FALSE;
+  pref_queue_invalidate(&pref_core->ul1req_queue_index, pref_core->ul1req_queue, slot);
+  STAT_EVENT(0, PREF_UL1REQ_QUEUE_HIT_BY_DEMAND);
+  return TRUE;
 }
 
 Flag pref_ul1req_queue_match(Addr line_addr) {
-  uns proc_id = get_proc_id_from_cmp_addr(line_addr);
-  Pref_Mem_Req* ul1req_queue = pref.cores[proc_id]->ul1req_queue;
-  for (uns ii = 0; ii < PREF_UL1REQ_QUEUE_SIZE; ii++) {
-    if (ul1req_queue[ii].valid &&
-        (ul1req_queue[ii].line_addr >> LOG2(DCACHE_LINE_SIZE)) == (line_addr >> LOG2(DCACHE_LINE_SIZE))) {
-      return TRUE;
-    }
-  }
-  return FALSE;
+  HWP_Core* pref_core = pref.cores[get_proc_id_from_cmp_addr(line_addr)];
+  Pref_Queue_Line* line =
+      (Pref_Queue_Line*)hash_table_access(&pref_core->ul1req_queue_index, line_addr >> LOG2(DCACHE_LINE_SIZE));
+  return line && line->valid;
 }
 
 Flag pref_addto_dl0req_queue(uns8 proc_id, Addr line_index, uns8 prefetcher_id) {
-  int ii;
   Pref_Mem_Req new_req = {0};
   if (!line_index)  // addr = 0
     return TRUE;
   Pref_Mem_Req* dl0req_queue = pref.cores[proc_id]->dl0req_queue;
   int* dl0req_queue_req_pos = &pref.cores[proc_id]->dl0req_queue_req_pos;
-  if (PREF_DL0REQ_ADD_FILTER_ON) {
-    for (ii = 0; ii < PREF_DL0REQ_QUEUE_SIZE; ii++) {
-      if (dl0req_queue[ii].line_index == line_index) {
-        STAT_EVENT(0, PREF_DL0REQ_QUEUE_MATCHED_REQ);
-        return TRUE;  // Hit another request
-      }
-    }
+  // any slot that still holds the line counts, sent or not
+  if (PREF_DL0REQ_ADD_FILTER_ON && hash_table_access(&pref.cores[proc_id]->dl0req_queue_index, line_index)) {
+    STAT_EVENT(0, PREF_DL0REQ_QUEUE_MATCHED_REQ);
+    return TRUE;  // Hit another request
   }
   if (dl0req_queue[(*dl0req_queue_req_pos + 1) % PREF_DL0REQ_QUEUE_SIZE].valid) {
     STAT_EVENT_ALL(PREF_DL0REQ_QUEUE_FULL);
@@ -544,24 +653,20 @@ Flag pref_addto_dl0req_queue(uns8 proc_id, Addr line_index, uns8 prefetcher_id)
 
   *dl0req_queue_req_pos = (*dl0req_queue_req_pos + 1) % PREF_DL0REQ_QUEUE_SIZE;
 
-  dl0req_queue[*dl0req_queue_req_pos] = new_req;
+  pref_queue_write(&pref.cores[proc_id]->dl0req_queue_index, dl0req_queue, *dl0req_queue_req_pos, &new_req);
   return TRUE;
 }
 
 Flag pref_addto_umlc_req_queue(uns8 proc_id, Addr line_index, uns8 prefetcher_id) {
-  int ii;
   Pref_Mem_Req new_req = {0};
   if (!line_index)  // addr = 0
     return TRUE;
   Pref_Mem_Req* umlc_req_queue = pref.cores[proc_id]->umlc_req_queue;
   int* umlc_req_queue_req_pos = &pref.cores[proc_id]->umlc_req_queue_req_pos;
-  if (PREF_UMLC_REQ_ADD_FILTER_ON) {
-    for (ii = 0; ii < PREF_UMLC_REQ_QUEUE_SIZE; ii++) {
-      if (umlc_req_queue[ii].line_index == line_index) {
-        STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_MATCHED_REQ);
-        return TRUE;  // Hit another request
-      }
-    }
+  // any slot that still holds the line counts, sent or not
+  if (PREF_UMLC_REQ_ADD_FILTER_ON && hash_table_access(&pref.cores[proc_id]->umlc_req_queue_index, line_index)) {
+    STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_MATCHED_REQ);
+    return TRUE;  // Hit another request
   }
   if (umlc_req_queue[(*umlc_req_queue_req_pos + 1) % PREF_UMLC_REQ_QUEUE_SIZE].valid) {
     STAT_EVENT_ALL(PREF_UMLC_REQ_QUEUE_FULL);
@@ -580,7 +685,7 @@ Flag pref_addto_umlc_req_queue(uns8 proc_id, Addr line_index, uns8 prefetcher_id
 
   *umlc_req_queue_req_pos = (*umlc_req_queue_req_pos + 1) % PREF_UMLC_REQ_QUEUE_SIZE;
 
-  umlc_req_queue[*umlc_req_queue_req_pos] = new_req;
+  pref_queue_write(&pref.cores[proc_id]->umlc_req_queue_index, umlc_req_queue, *umlc_req_queue_req_pos, &new_req);
   return TRUE;
 }
 
@@ -590,7 +695,6 @@ Flag pref_addto_ul1req_queue(uns8 proc_id, Addr line_index, uns8 prefetcher_id)
 
 Flag pref_addto_ul1req_queue_set(uns8 proc_id, Addr line_index, uns8 prefetcher_id, uns distance, Addr loadPC,
                                  uns32 global_hist, Flag bw) {
-  int ii;
   Pref_Mem_Req new_req;
   Addr line_addr;
   if (!line_index)  // addr = 0
@@ -603,13 +707,10 @@ Flag pref_addto_ul1req_queue_set(uns8 proc_id, Addr line_index, uns8 prefetcher_
 
   pref_feed_back_info_update(prefetcher_id);
 
-  if (PREF_UL1REQ_ADD_FILTER_ON) {
-    for (ii = 0; ii < PREF_UL1REQ_QUEUE_SIZE; ii++) {
-      if (ul1req_queue[ii].line_index == line_index) {
-        STAT_EVENT(0, PREF_UL1REQ_QUEUE_MATCHED_REQ);
-        return TRUE;  // Hit another request
-      }
-    }
+  // any slot that still holds the line counts, sent or not
+  if (PREF_UL1REQ_ADD_FILTER_ON && hash_table_access(&pref.cores[proc_id]->ul1req_queue_index, line_index)) {
+    STAT_EVENT(0, PREF_UL1REQ_QUEUE_MATCHED_REQ);
+    return TRUE;  // Hit another request
   }
   if (ul1req_queue[(*ul1req_queue_req_pos + 1) % PREF_UL1REQ_QUEUE_SIZE].valid) {
     STAT_EVENT_ALL(PREF_UL1REQ_QUEUE_FULL);
@@ -630,7 +731,7 @@ Flag pref_addto_ul1req_queue_set(uns8 proc_id, Addr line_index, uns8 prefetcher_
 
   *ul1req_queue_req_pos = (*ul1req_queue_req_pos + 1) % PREF_UL1REQ_QUEUE_SIZE;
 
-  ul1req_queue[*ul1req_queue_req_pos] = new_req;
+  pref_queue_write(&pref.cores[proc_id]->ul1req_queue_index, ul1req_queue, *ul1req_queue_req_pos, &new_req);
   return TRUE;
 }
 
@@ -641,6 +742,12 @@ void pref_update(void) {
   if (PREF_HFILTER_ON && PREF_HFILTER_RESET_ENABLE && cycle_count % PREF_HFILTER_RESET_INTERVAL == 0)
     pref_hfilter_pht_reset();
 
+  if (PREF_BATCH_TRAINING) {
+    for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+      pref_train_buffered(&pref.cores_array[proc_id]);
+    }
+  }
+
   if (PREF_SHARED_QUEUES) {
     pref_update_core(0);
   } else {
@@ -665,8 +772,10 @@ void pref_update_core(uns proc_id) {
   int* dl0req_queue_send_pos = &pref.cores[proc_id]->dl0req_queue_send_pos;
   Pref_Mem_Req* umlc_req_queue = pref.cores[proc_id]->umlc_req_queue;
   int* umlc_req_queue_send_pos = &pref.cores[proc_id]->umlc_req_queue_send_pos;
+  Hash_Table* umlc_req_queue_index = &pref.cores[proc_id]->umlc_req_queue_index;
   Pref_Mem_Req* ul1req_queue = pref.cores[proc_id]->ul1req_queue;
   int* ul1req_queue_send_pos = &pref.cores[proc_id]->ul1req_queue_send_pos;
+  Hash_Table* ul1req_queue_index = &pref.cores[proc_id]->ul1req_queue_index;
 
   set_dcache_stage(&cmp_model.dcache_stage[proc_id]);
 
@@ -737,7 +846,7 @@ void pref_update_core(uns proc_id) {
                                         PREF_L1Q_DEMAND_RESERVE)) {  // really req buffer demand reserve
         STAT_EVENT(0, PREF_MLCQ_STALL);
         if (PREF_REQ_DROP && MEM_REQ_BUFFER_ENTRIES == mem_get_req_count(proc_id)) {
-          umlc_req_queue[q_index].valid = FALSE;
+          pref_queue_invalidate(umlc_req_queue_index, umlc_req_queue, q_index);
         } else {
           inc_send_pos = FALSE;
         }
@@ -749,7 +858,7 @@ void pref_update_core(uns proc_id) {
                       &info)) {  // CMP maybe unique_count_per_core[proc_id]?
         DEBUG(0, "Sent req %llx to umlc Qpos:%d\n", umlc_req_queue[q_index].line_index, *umlc_req_queue_send_pos);
         STAT_EVENT(0, PREF_UMLC_REQ_QUEUE_SENTREQ);
-        umlc_req_queue[q_index].valid = FALSE;
+        pref_queue_invalidate(umlc_req_queue_index, umlc_req_queue, q_index);
       } else {
         STAT_EVENT(0, PREF_UMLC_REQ_SEND_QUEUE_STALL);
         inc_send_pos = FALSE;
@@ -789,7 +898,7 @@ void pref_update_core(uns proc_id) {
           ((MEM_REQ_BUFFER_ENTRIES - mem_get_req_count(proc_id)) < PREF_L1Q_DEMAND_RESERVE)) {
         STAT_EVENT(0, PREF_L1Q_STALL);
         if (PREF_REQ_DROP && MEM_REQ_BUFFER_ENTRIES == mem_get_req_count(proc_id)) {
-          ul1req_queue[q_index].valid = FALSE;
+          pref_queue_invalidate(ul1req_queue_index, ul1req_queue, q_index);
         } else {
           inc_send_pos = FALSE;
         }
@@ -800,7 +909,7 @@ void pref_update_core(uns proc_id) {
                                                    unique_count, &info)) {  // CMP maybe unique_count_per_core[proc_id]?
         DEBUG(0, "Sent req %llx to ul1 Qpos:%d\n", ul1req_queue[q_index].line_index, *ul1req_queue_send_pos);
         STAT_EVENT(0, PREF_UL1REQ_QUEUE_SENTREQ);
-        ul1req_queue[q_index].valid = FALSE;
+        pref_queue_invalidate(ul1req_queue_index, ul1req_queue, q_index);
       } else {
         STAT_EVENT(0, PREF_UL1REQ_SEND_QUEUE_STALL);
         inc_send_pos = FALSE;
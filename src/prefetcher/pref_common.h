@@ -29,6 +29,7 @@
 #ifndef __PREF_COMMON_H__
 #define __PREF_COMMON_H__
 
+#include "libs/hash_lib.h"
 #include "memory/mem_req.h"
 
 #define PREF_TRACKERS_NUM 16
@@ -48,6 +49,34 @@ struct Pref_Mem_Req_struct {
   Counter rdy_cycle;  // Move this out
 };
 
+/* Entry of a request queue index: the queue slots that hold a line */
+typedef struct Pref_Queue_Line_struct {
+  uns count;  // slots that hold the line, valid or not
+  uns valid;  // valid slots that hold the line
+  uns slot;   // the slot written last
+} Pref_Queue_Line;
+
+/* Training events, the accesses the prefetchers learn from */
+typedef enum Pref_Train_Type_enum {
+  PREF_TRAIN_DL0_MISS,
+  PREF_TRAIN_DL0_HIT,
+  PREF_TRAIN_DL0_PREF_HIT,
+  PREF_TRAIN_UMLC_MISS,
+  PREF_TRAIN_UMLC_HIT,
+  PREF_TRAIN_UMLC_PREF_HIT,
+  PREF_TRAIN_UL1_MISS,
+  PREF_TRAIN_UL1_HIT,
+  PREF_TRAIN_UL1_PREF_HIT,
+} Pref_Train_Type;
+
+typedef struct Pref_Train_Event_struct {
+  Pref_Train_Type type;
+  uns8 proc_id;
+  Addr line_addr;
+  Addr load_PC;
+  uns32 global_hist;
+} Pref_Train_Event;
+
 typedef struct Pref_Polbv_Info_struct {
   uns8 proc_id;
   Flag pollution;
@@ -121,6 +150,11 @@ struct HWP_struct {
                        uns32 global_hist);  // called when a ul1 access hits a
                                             // prefetched line for the first
                                             // time
+
+  // Optional, used with PREF_BATCH_TRAINING: trains on all buffered events of a
+  // core at once, in the order they happened. Prefetchers without it get the
+  // events one at a time through the functions above.
+  void (*train_batch_func)(Pref_Train_Event const* events, uns num);
 };
 
 /* Per core prefetching data */
@@ -138,6 +172,16 @@ typedef struct HWP_Core_struct {
   int ul1req_queue_req_pos;
   int ul1req_queue_send_pos;
 
+  // line_index -> Pref_Queue_Line of each queue, so that the filters need no scan
+  Hash_Table dl0req_queue_index;
+  Hash_Table umlc_req_queue_index;
+  Hash_Table ul1req_queue_index;
+
+  // training events buffered until the next pref_update (PREF_BATCH_TRAINING)
+  Pref_Train_Event* train_events;
+  uns num_train_events;
+  uns train_events_size;
+
   Counter ul1_misses;
   Counter curr_ul1_misses;
 
@@ -113,6 +113,21 @@ void pref_stream_init(HWP* hwp) {
   }
 }
 
+/* pref_stream_reload_params: re-read the parameters init_stream_core copied (after
+   they were overridden, e.g., in a forked sweep configuration) */
+void pref_stream_reload_params(void) {
+  Pref_Stream* cores[] = {stream_prefetchers_array.pref_stream_core_umlc, stream_prefetchers_array.pref_stream_core_ul1};
+  if (!PREF_STREAM_ON)
+    return;
+  for (uns ii = 0; ii < sizeof(cores) / sizeof(cores[0]); ii++) {
+    for (uns proc_id = 0; cores[ii] && proc_id < NUM_CORES; proc_id++) {
+      cores[ii][proc_id].train_num = STREAM_TRAIN_NUM;
+      cores[ii][proc_id].distance = STREAM_LENGTH;
+      cores[ii][proc_id].num_tosend = STREAM_PREFETCH_N;
+    }
+  }
+}
+
 void init_stream_core(HWP* hwp, Pref_Stream* pref_stream_core) {
   uns8 proc_id;
   for (proc_id = 0; proc_id < NUM_CORES; proc_id++) {
@@ -90,6 +90,7 @@ typedef struct {
 } stream_prefetchers;
 
 void pref_stream_init(HWP* hwp);
+void pref_stream_reload_params(void);
 
 void pref_stream_per_core_done(uns proc_id);
 /*************************************************************/
@@ -34,6 +34,7 @@
 #include "ramulator/Config.h"
 #include "ramulator/Request.h"
 #include "ramulator/ScarabWrapper.h"
+#include "ramulator/StatType.h"
 
 extern "C" {
 #include "globals/assert.h"
@@ -96,6 +97,12 @@ void ramulator_finish() {
   delete configs;
 }
 
+// Moves the Ramulator stat file to the current OUTPUT_DIR (e.g., for a forked
+// sweep configuration that must not overwrite the stats of its siblings)
+void ramulator_reopen_output() {
+  Stats::statlist.output(string(OUTPUT_DIR) + "/ramulator.stat.out");
+}
+
 void stats_callback(int coreid, int type) {
   switch (type) {
     case int(StatCallbackType::DRAM_ACT):
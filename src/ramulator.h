@@ -41,6 +41,7 @@
 
 EXTERNC void ramulator_init();
 EXTERNC void ramulator_finish();
+EXTERNC void ramulator_reopen_output();
 
 EXTERNC int ramulator_send(Mem_Req* scarab_req);
 EXTERNC void ramulator_tick();
@@ -29,8 +29,13 @@
 #include "sim.h"
 
 #include <fcntl.h>
+#include <math.h>
 #include <signal.h>
 #include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <time.h>
 
 #include "globals/assert.h"
@@ -45,6 +50,7 @@
 #include "debug/memview.h"
 #include "debug/pipeview.h"
 
+#include "bp/bp.h"
 #include "bp/bp.param.h"
 #include "core.param.h"
 #include "general.param.h"
@@ -53,27 +59,54 @@
 #include "frontend/frontend.h"
 #include "frontend/frontend_intf.h"
 #include "frontend/pin_trace_fe.h"
+#include "memory/cache_study.h"
 #include "power/power_intf.h"
 #include "prefetcher/eip.h"
 #include "prefetcher/fdip.h"
+#include "prefetcher/pref_stream.h"
 
 #include "cmp_model.h"
 #include "dumb_model.h"
 #include "freq.h"
+#include "host_profile.h"
 #include "model.h"
 #include "op_pool.h"
 #include "optimizer2.h"
+#include "param_parser.h"
 #include "ramulator.h"
+#include "stat_bin.h"
 #include "stat_trace.h"
 #include "statistics.h"
+#include "telemetry.h"
 #include "thread.h"
 #include "trigger.h"
+#include "warm_state.h"
 
 /**************************************************************************************/
 /* Macros */
 
 #define HEARTBEAT_PRINT_CPS FALSE /* default FALSE */
 
+/**************************************************************************************/
+/* Types */
+
+typedef struct Simpoint_Region_struct {
+  Counter interval;  // index of the region in units of segment_instr_count instructions
+  uns cluster;
+  double weight;
+} Simpoint_Region;
+
+typedef struct Bp_Only_Pred_struct {
+  uns mech;  // index into bp_table
+  Bp_Data bp_data;
+  Counter cbrs;
+  Counter cbr_mispreds;  // wrong direction predictions of conditional branches
+  Counter ibrs;
+  Counter ibr_mispreds;  // wrong targets of indirect jumps and calls
+  Counter btb_misses;
+  Counter flushes;  // branches of any type that would have redirected the frontend
+} Bp_Only_Pred;
+
 /**************************************************************************************/
 /* Global Variables */
 
@@ -113,6 +146,12 @@ Counter period_ID = 0;
 /* the global warmup dump flags */
 Flag* warmup_dump_done;
 
+/* the warmed state was restored from a checkpoint, so warmup only fast-forwards */
+static Flag warm_state_restored = FALSE;
+
+/* the parameter overrides of each configuration of a sweep (SWEEP_FILE) */
+static char** sweep_configs;
+
 time_t sim_start_time; /* the time that the simulator was started */
 
 FILE* mystdout;      /* default output (can be redirected via --stdout) */
@@ -143,6 +182,19 @@ static inline Counter check_forward_progress(uns8 proc_id);
 static inline double sim_progress(void);
 static inline void set_last_sim_param(uns8 proc_id);
 static inline void print_bogus_sim_param(uns8 proc_id);
+static void sampling_init(void);
+static void sampling_done(void);
+static Flag sampling_functional(Counter until, Flag warm);
+static Flag sampling_detailed(Counter until);
+static void sampling_drain(void);
+static void sampling_cycle(void);
+static uns simpoint_read_regions(Simpoint_Region** regions);
+static int simpoint_region_cmp(const void* a, const void* b);
+static uns sweep_read_configs(void);
+static uns bp_only_read_mechs(Bp_Only_Pred** preds);
+static void bp_only_predict(Bp_Only_Pred* pred, Op* op, Flag measure);
+static void sweep_setup(int config);
+static Flag sweep_param_allowed(const char* name);
 
 /**************************************************************************************/
 /* handle_SIGINT: this handler is for exiting smoothly when a SIGINT is caught
@@ -204,7 +256,7 @@ static inline void check_heartbeat(uns8 proc_id, Flag final) {
   /* dump warmup stats */
   if (FULL_WARMUP && !warmup_dump_done[proc_id] && inst_count_to_use >= FULL_WARMUP) {
     ASSERT(proc_id, !PERIODIC_DUMP);
-    dump_stats(proc_id, TRUE, global_stat_array[proc_id], NUM_GLOBAL_STATS);
+    dump_stats(proc_id, TRUE, 0, NUM_GLOBAL_STATS);
     period_last_cycle_count = cycle_count;
     // this number is used to calcute IPC, so it uses inst_count always
     period_last_inst_count[proc_id] = inst_count[proc_id];
@@ -214,7 +266,7 @@ static inline void check_heartbeat(uns8 proc_id, Flag final) {
   /* print heartbeat message if necessary */
   if ((HEARTBEAT_INTERVAL && inst_diff >= rounded_interval) || final) {
     if (PERIODIC_DUMP) {
-      dump_stats(proc_id, TRUE, global_stat_array[proc_id], NUM_GLOBAL_STATS);
+      dump_stats(proc_id, TRUE, 0, NUM_GLOBAL_STATS);
       period_last_cycle_count = cycle_count;
       // this number is used to calcute IPC, so it uses inst_count always
       period_last_inst_count[proc_id] = inst_count[proc_id];
@@ -300,7 +352,7 @@ static inline Counter check_forward_progress(uns8 proc_id) {
     uns8 proc_id2;
     for (proc_id2 = 0; proc_id2 < NUM_CORES; proc_id2++) {
       if (!sim_done[proc_id2])
-        dump_stats(proc_id2, TRUE, global_stat_array[proc_id2], NUM_GLOBAL_STATS);
+        dump_stats(proc_id2, TRUE, 0, NUM_GLOBAL_STATS);
     }
 
     if (cmp_model.node_stage[proc_id].node_head) {
@@ -579,13 +631,14 @@ void uop_sim() {
 
           switch (operating_mode) {
             case WARMUP_MODE:
-              model->warmup_func(&op);
+              if (!warm_state_restored)
+                model->warmup_func(&op);
               break;
             case SIMULATION_MODE:
               if (!sim_done[proc_id]) {
                 if (retired_exit[proc_id] || (INST_LIMIT && inst_count[proc_id] == inst_limit[proc_id])) {
                   sim_done[proc_id] = TRUE;
-                  dump_stats(proc_id, TRUE, global_stat_array[proc_id], NUM_GLOBAL_STATS);
+                  dump_stats(proc_id, TRUE, 0, NUM_GLOBAL_STATS);
                   check_heartbeat(proc_id, TRUE);
                 } else {
                   uop_sim_done = FALSE;
@@ -609,6 +662,8 @@ void uop_sim() {
           uop_sim_done = TRUE;
           check_heartbeat(0, TRUE);
         }
+        if (warm_state_restored)
+          break;  // time stays where the checkpoint was taken
         // HACK that ensures that cache replacement works in warmup
         do {
           freq_advance_time();
@@ -623,6 +678,89 @@ void uop_sim() {
 }
 
 /**************************************************************************************/
+/**************************************************************************************/
+/* sweep_read_configs: read the parameter overrides of each configuration (one
+   per non-empty line) from SWEEP_FILE */
+
+static uns sweep_read_configs(void) {
+  FILE* file = fopen(SWEEP_FILE, "r");
+  ASSERTUM(0, file, "Couldn't open sweep file '%s'.\n", SWEEP_FILE);
+
+  uns num_configs = 0;
+  uns size = 16;
+  char line[MAX_STR_LENGTH + 1];
+  sweep_configs = (char**)malloc(size * sizeof(char*));
+  while (fgets(line, MAX_STR_LENGTH + 1, file)) {
+    ASSERTUM(0, strchr(line, '\n') || feof(file), "Line %u of sweep file '%s' is too long.\n", num_configs + 1,
+             SWEEP_FILE);
+    line[strcspn(line, "\r\n")] = 0;
+    char* start = line + strspn(line, " \t");
+    if (!*start || *start == '#')
+      continue;
+    if (num_configs == size) {
+      size *= 2;
+      sweep_configs = (char**)realloc(sweep_configs, size * sizeof(char*));
+    }
+    sweep_configs[num_configs++] = strdup(start);
+  }
+  fclose(file);
+
+  ASSERTUM(0, num_configs, "No configurations in sweep file '%s'.\n", SWEEP_FILE);
+  return num_configs;
+}
+
+/**************************************************************************************/
+/* sweep_setup: called in the forked process of a sweep configuration before it
+   starts simulating. Outputs go to OUTPUT_DIR/sweep<config> unless the
+   configuration sets its own output_dir. */
+
+static void sweep_setup(int config) {
+  char buf[MAX_STR_LENGTH + 1];
+  snprintf(buf, MAX_STR_LENGTH + 1, "%s/sweep%d", OUTPUT_DIR, config);
+  OUTPUT_DIR = strdup(buf);
+  set_params(sweep_configs[config], sweep_param_allowed);
+  ASSERTUM(0, !mkdir(OUTPUT_DIR, 0777) || errno == EEXIST, "Couldn't create sweep directory '%s': %s\n", OUTPUT_DIR,
+           strerror(errno));
+
+  /* the configurations run concurrently, so each one gets its own stdout */
+  if (STDOUT_FILE)
+    fclose(mystdout);
+  mystdout = file_tag_fopen(OUTPUT_DIR, STDOUT_FILE ? STDOUT_FILE : "sweep", "w");
+  ASSERTUM(0, mystdout, "Couldn't open the output of sweep configuration %d in '%s'.\n", config, OUTPUT_DIR);
+  if (!STDOUT_FILE)
+    STDOUT_FILE = "sweep";  // so that close_output_streams closes it
+  if (STDERR_FILE) {
+    fclose(mystderr);
+    mystderr = file_tag_fopen(OUTPUT_DIR, STDERR_FILE, "w");
+    ASSERTUM(0, mystderr, "Couldn't open '%s' in '%s'.\n", STDERR_FILE, OUTPUT_DIR);
+  }
+  fprintf(mystdout, "** Sweep configuration %d: %s\n", config, sweep_configs[config]);
+
+  freq_reload_cycle_times();
+  pref_stream_reload_params();
+  ramulator_reopen_output();
+  stat_trace_reopen(OUTPUT_DIR);
+}
+
+/**************************************************************************************/
+/* sweep_param_allowed: the parameters a sweep configuration may override. Everything
+   else sized a structure or was copied during init, so an override would be silently
+   ignored. Parameters copied at init are re-read by sweep_setup. */
+
+static Flag sweep_param_allowed(const char* name) {
+  static const char* const runtime_params[] = {
+      "output_dir",        "stdout",        "stderr",           "pipeview_file",    "memview_file",
+      "chip_cycle_time",   "l1_cycle_time", "stream_prefetch_n", "stream_length",   "stream_start_dis",
+      "stream_train_num",  NULL,
+  };
+  for (uns ii = 0; runtime_params[ii]; ii++)
+    if (!strcmp(name, runtime_params[ii]))
+      return TRUE;
+  uns core;
+  int len = 0;
+  return sscanf(name, "core_%u_cycle_time%n", &core, &len) == 1 && !name[len];  // core_<N>_cycle_time
+}
+
 /* full_sim: This is the main loop for running in full simulation mode.*/
 
 void full_sim() {
@@ -635,7 +773,13 @@ void full_sim() {
 
   if (WARMUP) {
     operating_mode = WARMUP_MODE;
+    ASSERTUM(0, SIM_MODEL == CMP_MODEL || (!WARM_STATE_LOAD_FILE && !WARM_STATE_SAVE_FILE),
+             "Warm-state checkpoints are only supported by the cmp model\n");
+    if (WARM_STATE_LOAD_FILE)
+      warm_state_restored = warm_state_load();
     uop_sim();
+    if (WARM_STATE_SAVE_FILE && !warm_state_restored)
+      warm_state_save();
     reset_uop_mode_counters();
     reset_stats(FALSE);  // ignore stats accumulated during warmup
     /* The call below resets the cycle counts of all frequency
@@ -651,6 +795,9 @@ void full_sim() {
     freq_reset_cycle_counts();
   }
 
+  if (SWEEP_FILE)
+    opt2_sweep(sweep_read_configs(), SWEEP_MAX_PARALLEL, sweep_setup);
+
   operating_mode = SIMULATION_MODE;
   init_model(operating_mode);
 
@@ -658,6 +805,8 @@ void full_sim() {
     pipeview_init();
   if (MEMVIEW)
     memview_init();
+  host_profile_init();
+  telemetry_init();
 
   init_op_pool();
   unique_count = 1;
@@ -672,7 +821,8 @@ void full_sim() {
       break;
     freq_advance_time();
     sim_time = freq_time();
-    model->cycle_func();
+    host_profile_cycle();
+    HOST_PROFILE(CYCLE, model->cycle_func());
     if (SIM_MODEL != DUMB_MODEL && DUMB_CORE_ON)
       model_table[DUMB_MODEL].cycle_func();
 
@@ -687,6 +837,7 @@ void full_sim() {
     check_heartbeat(0, FALSE);
 
     stat_trace_cycle();
+    telemetry_cycle();
     if (trigger_fired(clear_stats)) {
       reset_stats(TRUE);
     }
@@ -714,7 +865,7 @@ void full_sim() {
           print_eip_stats(proc_id);
         }
         if (PERIODIC_DUMP == FALSE) {
-          dump_stats(proc_id, TRUE, global_stat_array[proc_id], NUM_GLOBAL_STATS);
+          dump_stats(proc_id, TRUE, 0, NUM_GLOBAL_STATS);
         }
         sim_done[proc_id] = TRUE;
         any_sim_done = TRUE;
@@ -762,11 +913,14 @@ void full_sim() {
   for (proc_id = 0; proc_id < NUM_CORES; proc_id++) {
     if (!sim_done[proc_id]) {
       if (PERIODIC_DUMP == FALSE) {
-        dump_stats(proc_id, TRUE, global_stat_array[proc_id], NUM_GLOBAL_STATS);
+        dump_stats(proc_id, TRUE, 0, NUM_GLOBAL_STATS);
       }
       check_heartbeat(proc_id, TRUE);
     }
   }
+  stat_bin_done();
+  host_profile_done();
+  telemetry_done();
 
   // fdip_print_hash_tables();
 
@@ -774,6 +928,506 @@ void full_sim() {
   trigger_free(clear_stats);
 }
 
+/**************************************************************************************/
+/* sampling_sim: Statistical sampling (SMARTS). The run is divided into periods of
+   SAMPLING_PERIOD instructions. Most of each period only warms the caches and the
+   branch predictor functionally (model->warmup_func); its last SAMPLING_DETAILED_WARMUP
+   instructions are simulated in detail to warm the pipeline and the last
+   SAMPLING_MEASURE instructions are measured. The stats only accumulate the measured
+   windows. The run ends with the trace, at the instruction limit, or once the CPI
+   estimate is within SAMPLING_TARGET_ERROR. */
+
+void sampling_sim() {
+  ASSERTM(0, SAMPLING_MEASURE > 0 && SAMPLING_DETAILED_WARMUP + SAMPLING_MEASURE <= SAMPLING_PERIOD,
+          "sampling_detailed_warmup + sampling_measure must be positive and at most sampling_period\n");
+
+  sampling_init();
+
+  char buf[MAX_STR_LENGTH + 1];
+  snprintf(buf, MAX_STR_LENGTH + 1, "%s/%s%s", OUTPUT_DIR, FILE_TAG, SAMPLING_FILE);
+  FILE* file = fopen(buf, "w");
+  ASSERTUM(0, file, "Couldn't open sampling file '%s'.\n", buf);
+  fprintf(file, "%-8s %15s %10s %10s %10s\n", "sample", "start_inst", "insts", "cycles", "cpi");
+
+  /* running mean and variance of the per-sample CPI (Welford) */
+  uns num_samples = 0;
+  double mean_cpi = 0.0;
+  double m2_cpi = 0.0;
+  double error = 0.0;
+  Counter last_report = 0;
+
+  reset_stats(FALSE);  // nothing has been measured yet
+  for (Counter period_end = WARMUP + SAMPLING_PERIOD; !INST_LIMIT || period_end <= inst_limit[0];
+       period_end += SAMPLING_PERIOD) {
+    Counter measure_start = period_end - SAMPLING_MEASURE;
+    if (!sampling_functional(measure_start - SAMPLING_DETAILED_WARMUP, TRUE))
+      break;
+    if (!sampling_detailed(measure_start))
+      break;
+
+    reset_stats_quiet(FALSE);  // drop the stats of everything but the measured windows
+    Counter start_inst = inst_count[0];
+    Counter start_cycle = cycle_count;
+    if (!sampling_detailed(period_end))
+      break;  // an incomplete sample would bias the estimate
+    reset_stats_quiet(TRUE);
+
+    Counter insts = inst_count[0] - start_inst;
+    Counter cycles = cycle_count - start_cycle;
+    double cpi = (double)cycles / insts;
+    double delta = cpi - mean_cpi;
+    num_samples++;
+    mean_cpi += delta / num_samples;
+    m2_cpi += delta * (cpi - mean_cpi);
+    error = num_samples > 1 ? SAMPLING_CONFIDENCE_Z * sqrt(m2_cpi / (num_samples - 1) / num_samples) / mean_cpi
+                            : 0.0;
+    fprintf(file, "%-8u %15lld %10lld %10lld %10.4f\n", num_samples, start_inst, insts, cycles, cpi);
+
+    if (HEARTBEAT_INTERVAL && inst_count[0] - last_report >= HEARTBEAT_INTERVAL) {
+      fprintf(mystdout, "** Sampling: insts:%-10s  samples:%-6u  CPI:%.4f +- %.2f%%\n", unsstr64(inst_count[0]),
+              num_samples, mean_cpi, 100.0 * error);
+      fflush(mystdout);
+      last_report = inst_count[0];
+    }
+
+    if (SAMPLING_TARGET_ERROR > 0 && num_samples >= MAX2(SAMPLING_MIN_SAMPLES, 2) && error <= SAMPLING_TARGET_ERROR)
+      break;
+    sampling_drain();
+  }
+  reset_stats_quiet(FALSE);
+
+  fprintf(file, "\nSamples:           %u (sampling_period %llu, detailed warmup %llu, measure %llu)\n", num_samples,
+          SAMPLING_PERIOD, SAMPLING_DETAILED_WARMUP, SAMPLING_MEASURE);
+  fprintf(file, "CPI:               %.4f\n", mean_cpi);
+  fprintf(file, "IPC:               %.4f\n", mean_cpi > 0 ? 1.0 / mean_cpi : 0.0);
+  fprintf(file, "Error bound:       %.2f%% (%.1f standard errors)\n", 100.0 * error, SAMPLING_CONFIDENCE_Z);
+  fclose(file);
+  fprintf(mystdout, "** Sampling Finished:  insts:%-10s  samples:%-6u  CPI:%.4f +- %.2f%%  (%.4f IPC)\n",
+          unsstr64(inst_count[0]), num_samples, mean_cpi, 100.0 * error, mean_cpi > 0 ? 1.0 / mean_cpi : 0.0);
+  fflush(mystdout);
+  sampling_done();
+}
+
+/**************************************************************************************/
+/* simpoint_sim: Simulates the regions of SIMPOINT_FILE in trace order in one run. Up to
+   SIMPOINT_WARMUP + SIMPOINT_DETAILED_WARMUP instructions before each region the program
+   is only skipped, then it is warmed functionally and in detail. The stats of every
+   region are folded into the totals scaled by its weight, so the stat files hold the
+   weighted average of the regions. */
+
+void simpoint_sim() {
+  ASSERTM(0, SIMPOINT_FILE && SIMPOINT_WEIGHTS_FILE, "Simpoint mode needs simpoint_file and simpoint_weights_file\n");
+  ASSERTM(0, SEGMENT_INSTR_COUNT > 0, "segment_instr_count must be set to the interval length of the simpoints\n");
+
+  Simpoint_Region* regions;
+  uns num_regions = simpoint_read_regions(&regions);
+  sampling_init();
+
+  char buf[MAX_STR_LENGTH + 1];
+  snprintf(buf, MAX_STR_LENGTH + 1, "%s/%s%s", OUTPUT_DIR, FILE_TAG, SIMPOINT_OUTPUT);
+  FILE* file = fopen(buf, "w");
+  ASSERTUM(0, file, "Couldn't open simpoint output file '%s'.\n", buf);
+  fprintf(file, "%-10s %8s %10s %15s %12s %12s %10s\n", "interval", "cluster", "weight", "start_inst", "insts",
+          "cycles", "cpi");
+
+  double total_weight = 0.0;
+  double weighted_cpi = 0.0;
+  reset_stats(FALSE);  // nothing has been measured yet
+  for (uns ii = 0; ii < num_regions; ii++) {
+    Simpoint_Region* region = &regions[ii];
+    Counter region_start = region->interval * SEGMENT_INSTR_COUNT;
+    Counter region_end = region_start + SEGMENT_INSTR_COUNT;
+    Counter detailed_start = region_start > SIMPOINT_DETAILED_WARMUP ? region_start - SIMPOINT_DETAILED_WARMUP : 0;
+    Counter warmup_start = detailed_start > SIMPOINT_WARMUP ? detailed_start - SIMPOINT_WARMUP : 0;
+
+    fprintf(mystdout, "** Simpoint %u/%u:  interval:%-8s  weight:%.4f  insts:%-10s\n", ii + 1, num_regions,
+            unsstr64(region->interval), region->weight, unsstr64(inst_count[0]));
+    fflush(mystdout);
+    if (!sampling_functional(warmup_start, FALSE) || !sampling_functional(detailed_start, TRUE) ||
+        !sampling_detailed(region_start))
+      break;
+
+    reset_stats_quiet(FALSE);  // drop the stats of everything but the regions
+    Counter start_inst = inst_count[0];
+    Counter start_cycle = cycle_count;
+    if (!sampling_detailed(region_end))
+      break;  // the trace ended inside the region
+    reset_stats_scaled(region->weight);
+
+    Counter insts = inst_count[0] - start_inst;
+    Counter cycles = cycle_count - start_cycle;
+    double cpi = (double)cycles / insts;
+    total_weight += region->weight;
+    weighted_cpi += region->weight * cpi;
+    fprintf(file, "%-10lld %8u %10.5f %15lld %12lld %12lld %10.4f\n", region->interval, region->cluster,
+            region->weight, start_inst, insts, cycles, cpi);
+    sampling_drain();
+  }
+  reset_stats_quiet(FALSE);
+
+  if (total_weight < 0.999)
+    WARNINGU(0, "The simulated simpoints cover only %.1f%% of the weight\n", 100.0 * total_weight);
+  double cpi = total_weight > 0 ? weighted_cpi / total_weight : 0.0;
+  fprintf(file, "\nWeight simulated:  %.4f\n", total_weight);
+  fprintf(file, "CPI:               %.4f\n", cpi);
+  fprintf(file, "IPC:               %.4f\n", cpi > 0 ? 1.0 / cpi : 0.0);
+  fclose(file);
+  fprintf(mystdout, "** Simpoints Finished:  insts:%-10s  weight:%.4f  CPI:%.4f  (%.4f IPC)\n",
+          unsstr64(inst_count[0]), total_weight, cpi, cpi > 0 ? 1.0 / cpi : 0.0);
+  fflush(mystdout);
+  free(regions);
+  sampling_done();
+}
+
+/**************************************************************************************/
+/* simpoint_read_regions: read SIMPOINT_FILE ("<interval> <cluster>" lines) and
+   SIMPOINT_WEIGHTS_FILE ("<weight> <cluster>" lines), sorted by interval */
+
+static uns simpoint_read_regions(Simpoint_Region** regions) {
+  FILE* points = fopen(SIMPOINT_FILE, "r");
+  ASSERTUM(0, points, "Couldn't open simpoint file '%s'.\n", SIMPOINT_FILE);
+  FILE* weights = fopen(SIMPOINT_WEIGHTS_FILE, "r");
+  ASSERTUM(0, weights, "Couldn't open simpoint weights file '%s'.\n", SIMPOINT_WEIGHTS_FILE);
+
+  uns num_regions = 0;
+  uns size = 16;
+  Simpoint_Region* r = (Simpoint_Region*)malloc(size * sizeof(Simpoint_Region));
+  unsigned long long interval;
+  uns cluster;
+  while (fscanf(points, "%llu %u", &interval, &cluster) == 2) {
+    if (num_regions == size) {
+      size *= 2;
+      r = (Simpoint_Region*)realloc(r, size * sizeof(Simpoint_Region));
+    }
+    r[num_regions].interval = interval;
+    r[num_regions].cluster = cluster;
+    r[num_regions].weight = -1.0;
+    num_regions++;
+  }
+  double weight;
+  while (fscanf(weights, "%lf %u", &weight, &cluster) == 2) {
+    for (uns ii = 0; ii < num_regions; ii++) {
+      if (r[ii].cluster == cluster)
+        r[ii].weight = weight;
+    }
+  }
+  fclose(points);
+  fclose(weights);
+
+  ASSERTUM(0, num_regions, "No simpoints in '%s'.\n", SIMPOINT_FILE);
+  for (uns ii = 0; ii < num_regions; ii++) {
+    ASSERTUM(0, r[ii].weight >= 0, "Simpoint cluster %u has no weight in '%s'.\n", r[ii].cluster,
+             SIMPOINT_WEIGHTS_FILE);
+  }
+  qsort(r, num_regions, sizeof(Simpoint_Region), simpoint_region_cmp);
+  *regions = r;
+  return num_regions;
+}
+
+/**************************************************************************************/
+/* simpoint_region_cmp: */
+
+static int simpoint_region_cmp(const void* a, const void* b) {
+  Counter interval_a = ((const Simpoint_Region*)a)->interval;
+  Counter interval_b = ((const Simpoint_Region*)b)->interval;
+  return interval_a < interval_b ? -1 : interval_a > interval_b;
+}
+
+/**************************************************************************************/
+/* sampling_init: set up the model for the sampled modes (sampling_sim, simpoint_sim) */
+
+static void sampling_init(void) {
+  ASSERTM(0, NUM_CORES == 1, "Sampled simulation supports a single core\n");
+  ASSERTM(0, !DUMB_CORE_ON && !PERIODIC_DUMP, "Sampled simulation does not support dumb cores or periodic dumps\n");
+
+  init_model(WARMUP_MODE);  // make sure this happens before init_op_pool
+  ASSERTM(0, model->warmup_func, "Model %s does not have a warmup function\n", model->name);
+  init_model(SIMULATION_MODE);
+  init_op_pool();
+  unique_count = 1;
+  telemetry_init();
+}
+
+/**************************************************************************************/
+/* sampling_done: finish the sampled modes and dump the accumulated stats */
+
+static void sampling_done(void) {
+  if (model->per_core_done_func)
+    model->per_core_done_func(0);
+  sim_done[0] = TRUE;
+  if (model->done_func)
+    model->done_func();
+
+  power_intf_done();
+  frontend_done(retired_exit);
+  ramulator_finish();
+  dump_stats(0, TRUE, 0, NUM_GLOBAL_STATS);
+  telemetry_done();
+}
+
+/**************************************************************************************/
+/* sampling_functional: execute core 0 functionally until it has executed until
+   instructions, warming the caches and the branch predictor if warm is set (otherwise
+   the instructions are only skipped). Returns FALSE if the program ended. */
+
+static Flag sampling_functional(Counter until, Flag warm) {
+  Op op;
+  Table_Info table_info;
+  Inst_Info inst_info;
+  op.table_info = &table_info;
+  op.inst_info = &inst_info;
+  op.mbp7_info = NULL;
+
+  operating_mode = WARMUP_MODE;
+  while (inst_count[0] < until && !retired_exit[0]) {
+    do {
+      frontend_fetch_op(0, &op);
+      if (op.eom)
+        inst_count[0]++;
+      if (op.exit)
+        retired_exit[0] = TRUE;
+      if (warm)
+        model->warmup_func(&op);
+      if (op.eom)
+        frontend_retire(0, op.inst_uid);
+    } while (!op.eom);
+
+    if (warm) {
+      // HACK that ensures that cache replacement works in warmup (see uop_sim)
+      do {
+        freq_advance_time();
+      } while (!freq_is_ready(FREQ_DOMAIN_L1));
+      sim_time = freq_time();
+    }
+  }
+  operating_mode = SIMULATION_MODE;
+
+  /* the cycles skipped by the functional warmup are not a lack of forward progress */
+  cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+  last_forward_progress[0] = cycle_count;
+  last_uop_count[0] = uop_count[0];
+  return !retired_exit[0];
+}
+
+/**************************************************************************************/
+/* sampling_detailed: simulate in detail until core 0 has retired until instructions.
+   Returns FALSE if the program ended. */
+
+static Flag sampling_detailed(Counter until) {
+  while (inst_count[0] < until && !retired_exit[0])
+    sampling_cycle();
+  return !retired_exit[0];
+}
+
+/**************************************************************************************/
+/* sampling_drain: stop fetching and simulate until every op in flight has left the
+   pipeline, so that the functional warmup can continue after the last retired
+   instruction. The trace frontends cannot rewind, so no op may be left behind. */
+
+static void sampling_drain(void) {
+  decoupled_fe_gate_fetch(0, TRUE);
+  while (op_pool_active_ops && !retired_exit[0])
+    sampling_cycle();
+  decoupled_fe_gate_fetch(0, FALSE);
+}
+
+/**************************************************************************************/
+/* sampling_cycle: one detailed simulation cycle (the body of the full_sim loop) */
+
+static void sampling_cycle(void) {
+  freq_advance_time();
+  sim_time = freq_time();
+  model->cycle_func();
+  cycle_count = freq_cycle_count(FREQ_DOMAIN_CORES[0]);
+  telemetry_cycle();
+  if (cycle_count % FORWARD_PROGRESS_INTERVAL == 0)
+    check_forward_progress(0);
+}
+
+/**************************************************************************************/
+/* bp_only_sim: evaluates the branch predictors of BP_ONLY_MECHS (BP_MECH by default)
+   and the BTB and indirect target predictor on one functional pass over the trace.
+   Every control flow op is predicted, resolved and retired by each predictor in turn,
+   so the trace is decoded once no matter how many predictors are compared. */
+
+void bp_only_sim() {
+  ASSERTUM(0, NUM_CORES == 1, "bp_only mode supports a single core\n");
+  ASSERTUM(0, LATE_BP_MECH == NUM_BP && !ENABLE_BP_CONF, "bp_only mode does not support late_bp_mech or bp_conf\n");
+
+  Bp_Only_Pred* preds;
+  uns num_preds = bp_only_read_mechs(&preds);
+  Bp_Recovery_Info recovery_info;
+  init_bp_recovery_info(0, &recovery_info);
+  uns bp_mech = BP_MECH;
+  for (uns ii = 0; ii < num_preds; ii++) {
+    BP_MECH = preds[ii].mech;  // init_bp_data sets up the predictor of BP_MECH
+    init_bp_data(0, &preds[ii].bp_data);
+  }
+  BP_MECH = bp_mech;
+
+  Op op;
+  Table_Info table_info;
+  Inst_Info inst_info;
+  op.table_info = &table_info;
+  op.inst_info = &inst_info;
+  op.mbp7_info = NULL;
+
+  Flag measure = !WARMUP;
+  while (!retired_exit[0] && !(INST_LIMIT && inst_count[0] >= inst_limit[0])) {
+    do {
+      frontend_fetch_op(0, &op);
+      op_count[0]++;
+      if (op.eom)
+        inst_count[0]++;
+      if (op.exit)
+        retired_exit[0] = TRUE;
+      if (op.table_info->cf_type != NOT_CF) {
+        for (uns ii = 0; ii < num_preds; ii++)
+          bp_only_predict(&preds[ii], &op, measure);
+      }
+      if (op.eom)
+        frontend_retire(0, op.inst_uid);
+    } while (!op.eom);
+
+    if (!measure && inst_count[0] >= WARMUP) {
+      measure = TRUE;
+      reset_stats(FALSE);  // the bp stats only count the measured instructions
+    }
+    if (measure)
+      check_heartbeat(0, FALSE);
+  }
+  check_heartbeat(0, TRUE);
+
+  Counter insts = inst_count[0] > WARMUP ? inst_count[0] - WARMUP : 0;
+  double kilo_insts = MAX2(insts, 1) / 1000.0;
+  char buf[MAX_STR_LENGTH + 1];
+  snprintf(buf, MAX_STR_LENGTH + 1, "%s/%s%s", OUTPUT_DIR, FILE_TAG, BP_ONLY_FILE);
+  FILE* file = fopen(buf, "w");
+  ASSERTUM(0, file, "Couldn't open bp_only output file '%s'.\n", buf);
+  fprintf(file, "# %s instructions measured after a warmup of %s\n", unsstr64(insts), unsstr64(WARMUP));
+  fprintf(file, "%-12s %12s %12s %10s %12s %12s %10s %12s %10s %10s\n", "predictor", "cbrs", "cbr_mispred",
+          "cbr_mpki", "ibrs", "ibr_mispred", "ibr_mpki", "btb_misses", "btb_mpki", "flush_pki");
+  for (uns ii = 0; ii < num_preds; ii++) {
+    Bp_Only_Pred* pred = &preds[ii];
+    fprintf(file, "%-12s %12lld %12lld %10.4f %12lld %12lld %10.4f %12lld %10.4f %10.4f\n", bp_table[pred->mech].name,
+            pred->cbrs, pred->cbr_mispreds, pred->cbr_mispreds / kilo_insts, pred->ibrs, pred->ibr_mispreds,
+            pred->ibr_mispreds / kilo_insts, pred->btb_misses, pred->btb_misses / kilo_insts,
+            pred->flushes / kilo_insts);
+    fprintf(mystdout, "** bp_only %-12s  cbr MPKI: %8.4f  ibr MPKI: %8.4f  flushes PKI: %8.4f\n",
+            bp_table[pred->mech].name, pred->cbr_mispreds / kilo_insts, pred->ibr_mispreds / kilo_insts,
+            pred->flushes / kilo_insts);
+  }
+  fclose(file);
+  free(preds);
+
+  sim_done[0] = TRUE;
+  frontend_done(retired_exit);
+  dump_stats(0, TRUE, 0, NUM_GLOBAL_STATS);  // the bp stats are summed over all predictors
+}
+
+/**************************************************************************************/
+/* bp_only_read_mechs: parse the comma separated predictor names of BP_ONLY_MECHS */
+
+static uns bp_only_read_mechs(Bp_Only_Pred** preds) {
+  char mechs[MAX_STR_LENGTH + 1];
+  strncpy(mechs, BP_ONLY_MECHS ? BP_ONLY_MECHS : bp_table[BP_MECH].name, MAX_STR_LENGTH);
+  mechs[MAX_STR_LENGTH] = 0;
+
+  uns num_preds = 0;
+  Bp_Only_Pred* p = (Bp_Only_Pred*)calloc(NUM_BP, sizeof(Bp_Only_Pred));
+  for (char* name = strtok(mechs, ", "); name; name = strtok(NULL, ", ")) {
+    uns mech;
+    for (mech = 0; bp_table[mech].name; mech++)
+      if (!strcmp(name, bp_table[mech].name))
+        break;
+    ASSERTUM(0, bp_table[mech].name, "Unknown branch predictor '%s' in bp_only_mechs.\n", name);
+    // predictors that share an init function share their tables (e.g., tagescl and tagescl80)
+    for (uns ii = 0; ii < num_preds; ii++)
+      ASSERTUM(0, bp_table[p[ii].mech].init_func != bp_table[mech].init_func,
+               "Branch predictors '%s' and '%s' cannot be evaluated in the same run.\n", bp_table[p[ii].mech].name,
+               name);
+    p[num_preds++].mech = mech;
+  }
+  ASSERTUM(0, num_preds, "No branch predictors in bp_only_mechs.\n");
+  *preds = p;
+  return num_preds;
+}
+
+/**************************************************************************************/
+/* bp_only_predict: predict, resolve and retire a control flow op with one predictor
+   (the same sequence as the functional warmup in cmp_warmup) */
+
+static void bp_only_predict(Bp_Only_Pred* pred, Op* op, Flag measure) {
+  Bp_Data* bp_data = &pred->bp_data;
+  set_bp_data(bp_data);
+  bp_predict_op(bp_data, op, 1, op->inst_info->addr);
+  bp_target_known_op(bp_data, op);
+  bp_resolve_op(bp_data, op);
+  Flag flush = op->oracle_info.mispred || op->oracle_info.misfetch;
+  if (flush)
+    bp_recover_op(bp_data, op->table_info->cf_type, &op->recovery_info);
+  bp_data->bp->retire_func(op);
+
+  if (!measure)
+    return;
+  Cf_Type cf_type = op->table_info->cf_type;
+  if (cf_type == CF_CBR) {
+    pred->cbrs++;
+    pred->cbr_mispreds += op->oracle_info.pred_orig != op->oracle_info.dir;
+  } else if (cf_type == CF_IBR || cf_type == CF_ICALL) {
+    pred->ibrs++;
+    pred->ibr_mispreds += flush;
+  }
+  pred->btb_misses += op->oracle_info.btb_miss;
+  pred->flushes += flush;
+}
+
+/**************************************************************************************/
+/* cache_study_sim: measures the misses of many cache configurations on one functional
+   pass over the trace (see memory/cache_study.c). */
+
+void cache_study_sim() {
+  ASSERTUM(0, NUM_CORES == 1, "cache_study mode supports a single core\n");
+  init_cache_study();
+
+  Op op;
+  Table_Info table_info;
+  Inst_Info inst_info;
+  op.table_info = &table_info;
+  op.inst_info = &inst_info;
+  op.mbp7_info = NULL;
+
+  Flag measure = !WARMUP;
+  while (!retired_exit[0] && !(INST_LIMIT && inst_count[0] >= inst_limit[0])) {
+    do {
+      frontend_fetch_op(0, &op);
+      op_count[0]++;
+      if (op.eom)
+        inst_count[0]++;
+      if (op.exit)
+        retired_exit[0] = TRUE;
+      cache_study_op(&op);
+      if (op.eom)
+        frontend_retire(0, op.inst_uid);
+    } while (!op.eom);
+
+    if (!measure && inst_count[0] >= WARMUP) {
+      measure = TRUE;
+      reset_stats(FALSE);
+      cache_study_start_measure();
+    }
+    if (measure)
+      check_heartbeat(0, FALSE);
+  }
+  check_heartbeat(0, TRUE);
+
+  cache_study_done(inst_count[0] > WARMUP ? inst_count[0] - WARMUP : 0);
+
+  sim_done[0] = TRUE;
+  frontend_done(retired_exit);
+  dump_stats(0, TRUE, 0, NUM_GLOBAL_STATS);
+}
+
 /**************************************************************************************/
 #ifdef ENABLE_PT_MEMTRACE
 /* trace_bbv: This is the main loop for extracting basic block vectors from the trace.*/
@@ -37,6 +37,10 @@
 enum sim_mode_enum {
   UOP_SIM_MODE,
   FULL_SIM_MODE,
+  SAMPLING_SIM_MODE,
+  SIMPOINT_SIM_MODE,
+  BP_ONLY_SIM_MODE,
+  CACHE_STUDY_SIM_MODE,
 #ifdef ENABLE_PT_MEMTRACE
   TRACE_BBV_MODE,
   TRACE_BBV_DISTRIBUTED_MODE,
@@ -68,6 +72,9 @@ void init_global(char*[], char*[]);
 void uop_sim(void);
 void monitor_sim(void);
 void sampling_sim(void);
+void simpoint_sim(void);
+void bp_only_sim(void);
+void cache_study_sim(void);
 void full_sim(void);
 void handle_SIGINT(int);
 void close_output_streams(void);
@@ -64,6 +64,57 @@ typedef struct Stage_Data_struct {
   Op** ops;         /* array of ops in the stage */
 } Stage_Data;
 
+/* A stage that is several cycles deep (e.g. decode, map) is a ring of latches. Latch 0
+   is the oldest one, read by the next stage, and latch depth - 1 receives new ops. When
+   latch 0 has drained, moving every latch forward rotates the ring instead of moving ops. */
+typedef struct Stage_Latches_struct {
+  Stage_Data* sds; /* physical latches */
+  uns depth;       /* number of latches */
+  uns head;        /* physical index of latch 0 */
+} Stage_Latches;
+
+/**************************************************************************************/
+/* Inline Methods */
+
+/* Hands all the ops of src to the empty latch dst by swapping their op arrays, so no op
+   pointer is copied. The empty latch's array, all NULL, becomes the array of src. */
+static inline void stage_data_hand_off(Stage_Data* dst, Stage_Data* src) {
+  Op** temp = dst->ops;
+  dst->ops = src->ops;
+  src->ops = temp;
+  dst->op_count = src->op_count;
+  src->op_count = 0;
+}
+
+static inline Stage_Data* stage_latches_get(Stage_Latches* latches, uns idx) {
+  uns phys = latches->head + idx;
+  if (phys >= latches->depth)
+    phys -= latches->depth;
+  return &latches->sds[phys];
+}
+
+/* Moves ops forward into empty latches. Every latch behind the first empty one moves one
+   latch forward and the youngest latch becomes empty. */
+static inline void stage_latches_advance(Stage_Latches* latches) {
+  uns ii;
+  if (latches->depth < 2)
+    return;
+
+  if (stage_latches_get(latches, 0)->op_count == 0) {
+    /* the drained latch 0 becomes the (empty) youngest latch */
+    latches->head = latches->head + 1 == latches->depth ? 0 : latches->head + 1;
+    return;
+  }
+
+  /* latch 0 is stalled, close the first bubble behind it by swapping op arrays */
+  for (ii = 1; ii < latches->depth - 1; ii++) {
+    Stage_Data* cur = stage_latches_get(latches, ii);
+    if (cur->op_count)
+      continue;
+    stage_data_hand_off(cur, stage_latches_get(latches, ii + 1));
+  }
+}
+
 /**************************************************************************************/
 
 #endif /* #ifndef __STAGE_H__ */
@@ -0,0 +1,136 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : stat_bin.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Binary stat stream for periodic dumps. Each dump appends one
+ *fixed-width row of raw counters per core instead of formatting the .out/.csv
+ *files, see stat_bin.h for the layout.
+ ***************************************************************************************/
+
+#include "stat_bin.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "core.param.h"
+#include "general.param.h"
+
+#include "statistics.h"
+
+/**************************************************************************************/
+/* Global Variables */
+
+#define STAT_BIN_BUFFER_SIZE (1 << 20)
+
+static FILE* stat_bin_file = NULL;
+
+/**************************************************************************************/
+/* stat_bin_open: writes the header and the stat descriptions */
+
+static void stat_bin_open(void) {
+  char buf[MAX_STR_LENGTH + 1];
+  snprintf(buf, MAX_STR_LENGTH + 1, "%s/%s%s", OUTPUT_DIR, FILE_TAG, STAT_BIN_FILE);
+  stat_bin_file = fopen(buf, "wb");
+  ASSERTUM(0, stat_bin_file, "Couldn't open binary stat file '%s'.\n", buf);
+  setvbuf(stat_bin_file, NULL, _IOFBF, STAT_BIN_BUFFER_SIZE);
+
+  uns32 strings_size = 0;
+  for (uns ii = 0; ii < NUM_GLOBAL_STATS; ii++)
+    strings_size += strlen(global_stat_desc[ii].name) + 1 + strlen(global_stat_desc[ii].file_name) + 1;
+
+  Stat_Bin_Header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, STAT_BIN_MAGIC, sizeof(header.magic));
+  header.version = STAT_BIN_VERSION;
+  header.num_stats = NUM_GLOBAL_STATS;
+  header.num_cores = NUM_CORES;
+  header.row_size = sizeof(Stat_Bin_Row_Header) + 2 * NUM_GLOBAL_STATS * sizeof(Stat_Counter);
+  header.header_size =
+      ROUND_UP(sizeof(Stat_Bin_Header) + NUM_GLOBAL_STATS * sizeof(Stat_Bin_Stat_Desc) + strings_size, 8);
+  fwrite(&header, sizeof(header), 1, stat_bin_file);
+
+  uns32 offset = 0;
+  for (uns ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+    const Stat_Desc* stat = &global_stat_desc[ii];
+    Stat_Bin_Stat_Desc desc;
+    memset(&desc, 0, sizeof(desc));
+    desc.type = stat->type;
+    desc.ratio_stat = stat->ratio_stat;
+    desc.flags = stat_on(ii) ? 0 : STAT_BIN_STAT_COMPILED_OUT;
+    desc.name_offset = offset;
+    offset += strlen(stat->name) + 1;
+    desc.file_name_offset = offset;
+    offset += strlen(stat->file_name) + 1;
+    fwrite(&desc, sizeof(desc), 1, stat_bin_file);
+  }
+  ASSERT(0, offset == strings_size);
+
+  for (uns ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+    fwrite(global_stat_desc[ii].name, strlen(global_stat_desc[ii].name) + 1, 1, stat_bin_file);
+    fwrite(global_stat_desc[ii].file_name, strlen(global_stat_desc[ii].file_name) + 1, 1, stat_bin_file);
+  }
+
+  static const char padding[8] = {0};
+  long pad = header.header_size - ftell(stat_bin_file);
+  ASSERT(0, pad >= 0 && pad < 8);
+  fwrite(padding, pad, 1, stat_bin_file);
+}
+
+/**************************************************************************************/
+/* stat_bin_write_row: */
+
+void stat_bin_write_row(uns8 proc_id) {
+  if (!stat_bin_file)
+    stat_bin_open();
+
+  Stat_Bin_Row_Header row;
+  memset(&row, 0, sizeof(row));
+  row.period_id = period_ID;
+  row.proc_id = proc_id;
+  row.cycle_count = cycle_count;
+  row.inst_count = inst_count[proc_id];
+  row.pret_inst_count = pret_inst_count[proc_id];
+  row.pret_inst_count_0 = pret_inst_count[0];
+  row.period_cycles = cycle_count - period_last_cycle_count;
+  row.period_insts = inst_count[proc_id] - period_last_inst_count[proc_id];
+
+  fwrite(&row, sizeof(row), 1, stat_bin_file);
+  fwrite(global_stat_count[proc_id], sizeof(Stat_Counter), NUM_GLOBAL_STATS, stat_bin_file);
+  fwrite(global_stat_total[proc_id], sizeof(Stat_Counter), NUM_GLOBAL_STATS, stat_bin_file);
+}
+
+/**************************************************************************************/
+/* stat_bin_done: */
+
+void stat_bin_done(void) {
+  if (!stat_bin_file)
+    return;
+  fclose(stat_bin_file);
+  stat_bin_file = NULL;
+}
@@ -0,0 +1,95 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : stat_bin.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Binary stat stream for periodic dumps (periodic_dump_binary).
+ *
+ * The stream is a single append-only file for all cores. All fields are
+ * native-endian (little-endian on x86) and 8-byte aligned so the file can be
+ * mmap'ed; utils/stat_bin/stat_bin_reader.h reads it and
+ * bin/scarab_stat_bin.py converts it to the .out/.csv stat files.
+ *
+ *   Stat_Bin_Header                                  (64 bytes)
+ *   Stat_Bin_Stat_Desc[num_stats]                    (24 bytes each)
+ *   string table: "name\0file_name\0" for every stat, padded to header_size
+ *   rows, row_size bytes each, one per core per dump:
+ *     Stat_Bin_Row_Header                            (64 bytes)
+ *     uns64 interval[num_stats]   count (or double value) of the interval
+ *     uns64 total[num_stats]      count (or double value) since the beginning
+ ***************************************************************************************/
+
+#ifndef __STAT_BIN_H__
+#define __STAT_BIN_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Types */
+
+#define STAT_BIN_MAGIC "SCRBSTAT"
+#define STAT_BIN_VERSION 1
+
+#define STAT_BIN_STAT_COMPILED_OUT 0x1  // Stat_Bin_Stat_Desc flag: group compiled out
+
+typedef struct Stat_Bin_Header_struct {
+  char magic[8];        // STAT_BIN_MAGIC, not NUL terminated
+  uns32 version;        // STAT_BIN_VERSION
+  uns32 num_stats;      // number of stats in each row
+  uns32 num_cores;      // number of cores writing rows
+  uns32 row_size;       // bytes per row
+  uns64 header_size;    // file offset of the first row
+  uns64 reserved[4];
+} Stat_Bin_Header;
+
+typedef struct Stat_Bin_Stat_Desc_struct {
+  uns32 type;              // Stat_Type
+  uns32 ratio_stat;        // index of the ratio stat (num_stats if none)
+  uns32 flags;             // STAT_BIN_STAT_* flags
+  uns32 name_offset;       // offset of the name in the string table
+  uns32 file_name_offset;  // offset of the .stat.def file name in the string table
+  uns32 reserved;
+} Stat_Bin_Stat_Desc;
+
+typedef struct Stat_Bin_Row_Header_struct {
+  uns64 period_id;          // period of the dump
+  uns32 proc_id;            // core of the row
+  uns32 reserved;
+  uns64 cycle_count;        // cycles at the time of the dump
+  uns64 inst_count;         // instructions of the core at the time of the dump
+  uns64 pret_inst_count;    // pseudo-retired instructions of the core
+  uns64 pret_inst_count_0;  // pseudo-retired instructions of core 0 (PER_1000_PRET totals)
+  uns64 period_cycles;      // cycles since the previous dump
+  uns64 period_insts;       // instructions of the core since the previous dump
+} Stat_Bin_Row_Header;
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Append the stats of a core to the stream, opening it on the first call */
+void stat_bin_write_row(uns8 proc_id);
+
+/* Flush and close the stream */
+void stat_bin_done(void);
+
+#endif  // __STAT_BIN_H__
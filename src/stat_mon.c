@@ -70,6 +70,7 @@ Stat_Mon* stat_mon_create_from_array(uns* stat_idx_array, uns num) {
   mon->num_stats = num;
   mon->stat_infos = malloc(num * sizeof(Stat_Info));
   for (uns i = 0; i < num; i++) {
+    stat_require(stat_idx_array[i], "A stat monitor");
     init_stat_info(&mon->stat_infos[i], stat_idx_array[i]);
   }
   stat_mon_reset(mon);
@@ -86,6 +87,7 @@ Stat_Mon* stat_mon_create_from_range(uns first_stat_idx, uns last_stat_idx) {
   mon->num_stats = last_stat_idx - first_stat_idx + 1;
   mon->stat_infos = malloc(mon->num_stats * sizeof(Stat_Info));
   for (uns i = 0; i < mon->num_stats; i++) {
+    stat_require(first_stat_idx + i, "A stat monitor");
     init_stat_info(&mon->stat_infos[i], first_stat_idx + i);
   }
   stat_mon_reset(mon);
@@ -98,10 +100,9 @@ Stat_Mon* stat_mon_create_from_range(uns first_stat_idx, uns last_stat_idx) {
 Counter stat_mon_get_count(Stat_Mon* mon, uns proc_id, uns stat_idx) {
   ASSERT(0, proc_id < NUM_CORES);
   ASSERT(proc_id, stat_idx < NUM_GLOBAL_STATS);
-  Stat* stat = &global_stat_array[proc_id][stat_idx];
-  ASSERT(proc_id, stat->type != FLOAT_TYPE_STAT);
+  ASSERT(proc_id, global_stat_desc[stat_idx].type != FLOAT_TYPE_STAT);
   Stat_Info* info = find_stat_info(mon, stat_idx);
-  return stat->count + stat->total_count - info->last_data[proc_id].count;
+  return GET_TOTAL_STAT_EVENT(proc_id, stat_idx) - info->last_data[proc_id].count;
 }
 
 /**************************************************************************************/
@@ -110,10 +111,9 @@ Counter stat_mon_get_count(Stat_Mon* mon, uns proc_id, uns stat_idx) {
 double stat_mon_get_value(Stat_Mon* mon, uns proc_id, uns stat_idx) {
   ASSERT(0, proc_id < NUM_CORES);
   ASSERT(proc_id, stat_idx < NUM_GLOBAL_STATS);
-  Stat* stat = &global_stat_array[proc_id][stat_idx];
-  ASSERT(proc_id, stat->type == FLOAT_TYPE_STAT);
+  ASSERT(proc_id, global_stat_desc[stat_idx].type == FLOAT_TYPE_STAT);
   Stat_Info* info = find_stat_info(mon, stat_idx);
-  return stat->value + stat->total_value - info->last_data[proc_id].value;
+  return GET_TOTAL_STAT_VALUE(proc_id, stat_idx) - info->last_data[proc_id].value;
 }
 
 /**************************************************************************************/
@@ -128,11 +128,10 @@ void stat_mon_reset(Stat_Mon* mon) {
   for (uns i = 0; i < mon->num_stats; i++) {
     Stat_Info* info = &mon->stat_infos[i];
     for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-      Stat* stat = &global_stat_array[proc_id][info->stat_idx];
-      if (stat->type == FLOAT_TYPE_STAT) {
-        info->last_data[proc_id].value = stat->value + stat->total_value;
+      if (global_stat_desc[info->stat_idx].type == FLOAT_TYPE_STAT) {
+        info->last_data[proc_id].value = GET_TOTAL_STAT_VALUE(proc_id, info->stat_idx);
       } else {
-        info->last_data[proc_id].count = stat->count + stat->total_count;
+        info->last_data[proc_id].count = GET_TOTAL_STAT_EVENT(proc_id, info->stat_idx);
       }
     }
   }
@@ -160,7 +159,7 @@ static Stat_Info* find_stat_info(Stat_Mon* mon, uns stat_idx) {
       return &mon->stat_infos[i];
     }
   }
-  FATAL_ERROR(0, "Stat %s not in stat monitor\n", global_stat_array[0][stat_idx].name);
+  FATAL_ERROR(0, "Stat %s not in stat monitor\n", global_stat_desc[stat_idx].name);
 }
 
 /**************************************************************************************/
@@ -168,8 +167,7 @@ static Stat_Info* find_stat_info(Stat_Mon* mon, uns stat_idx) {
 
 static void init_stat_info(Stat_Info* info, uns stat_idx) {
   ASSERT(0, stat_idx < NUM_GLOBAL_STATS);
-  Stat* stat = &global_stat_array[0][stat_idx];
-  if (stat->noreset)
+  if (global_stat_desc[stat_idx].noreset)
     WARNINGU_ONCE(0, "NORESET stats are treated as resettable by stat_mon\n");
   info->stat_idx = stat_idx;
   info->last_data = malloc(NUM_CORES * sizeof(Stat_Datum));
@@ -34,6 +34,8 @@
 
 #include "core.param.h"
 
+#include "debug/trace_writer.h"
+
 #include "stat_mon.h"
 #include "statistics.h"
 #include "trigger.h"
@@ -41,14 +43,14 @@
 /**************************************************************************************/
 /* Types */
 
-typedef struct Stat_Info_struct {
-  const Stat* ptr; /* pointer to the stat struct */
-  /* value of the stat after the last interval */
+/* One trace line: the values of the traced stats for every core */
+typedef struct Stat_Trace_Record_struct {
+  Counter inst_count;
   union {
-    Counter last_count;
-    double last_value;
-  };
-} Stat_Info;
+    double value;
+    Counter count;
+  } stats[];  // num_stats * NUM_CORES
+} Stat_Trace_Record;
 
 /**************************************************************************************/
 /* Global Variables */
@@ -57,13 +59,15 @@ static Stat_Mon* stat_mon;
 static Stat_Enum* stat_indices;
 static uns num_stats;
 static Trigger* interval_trigger = NULL;
-static FILE* file;
+static Trace_Writer* writer;
 const char* DELIMITERS = " ,";
 
 /**************************************************************************************/
 /* Local Prototypes */
 
 static void trace_stats(void);
+static void open_trace(const char* file_name);
+static void render_stats(FILE* file, const void* data);
 
 /**************************************************************************************/
 /* stat_trace_init: */
@@ -72,41 +76,67 @@ void stat_trace_init(void) {
   if (!STATS_TO_TRACE)
     return;
 
-  /* open the trace file */
-  char stats_trace_file[100];
-  sprintf(stats_trace_file, "%s%s", FILE_TAG, STAT_TRACE_FILE);
-  file = fopen(stats_trace_file, "w");
-  ASSERTM(0, file, "Could not open %s", STAT_TRACE_FILE);
-
   /* parse the stats to trace */
   num_stats = num_tokens(STATS_TO_TRACE, DELIMITERS);
   stat_indices = malloc(num_stats * sizeof(Stat_Enum));
   char* stats_str = strdup(STATS_TO_TRACE);
   char* stat_name = strtok(stats_str, DELIMITERS);
   uns ii = 0;
-  fprintf(file, "Instructions");
   while (stat_name) {
     Stat_Enum stat_idx = get_stat_idx(stat_name);
     ASSERTM(0, stat_idx < NUM_GLOBAL_STATS, "Stat %s not found\n", stat_name);
     stat_indices[ii] = stat_idx;
     ii++;
-    for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-      fprintf(file, "\t%s[%d]", stat_name, proc_id);
-    }
     stat_name = strtok(NULL, DELIMITERS);
   }
-  fprintf(file, "\n");
   ASSERT(0, ii == num_stats);
   free(stats_str);
 
   stat_mon = stat_mon_create_from_array(stat_indices, num_stats);
 
+  /* open the trace file */
+  char stats_trace_file[MAX_STR_LENGTH + 1];
+  snprintf(stats_trace_file, MAX_STR_LENGTH + 1, "%s%s", FILE_TAG, STAT_TRACE_FILE);
+  open_trace(stats_trace_file);
+
   /* do an initial trace print (all zeros) */
   trace_stats();
 
   interval_trigger = trigger_create("STAT_TRACE_INTERVAL", STAT_TRACE_INTERVAL, TRIGGER_REPEAT);
 }
 
+/**************************************************************************************/
+/* stat_trace_reopen: continue the trace in dir (e.g., the output directory of a
+   forked sweep configuration). The lines so far stay in the old file. */
+
+void stat_trace_reopen(const char* dir) {
+  if (!STATS_TO_TRACE)
+    return;
+
+  trace_writer_close(writer);
+  char stats_trace_file[MAX_STR_LENGTH + 1];
+  snprintf(stats_trace_file, MAX_STR_LENGTH + 1, "%s/%s%s", dir, FILE_TAG, STAT_TRACE_FILE);
+  open_trace(stats_trace_file);
+}
+
+/**************************************************************************************/
+/* open_trace: write the header of a new trace file and hand it to the writer */
+
+static void open_trace(const char* file_name) {
+  FILE* file = fopen(file_name, "w");
+  ASSERTM(0, file, "Could not open %s", file_name);
+
+  fprintf(file, "Instructions");
+  for (uns ii = 0; ii < num_stats; ii++) {
+    for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+      fprintf(file, "\t%s[%d]", global_stat_desc[stat_indices[ii]].name, proc_id);
+    }
+  }
+  fprintf(file, "\n");
+
+  writer = trace_writer_create(file, sizeof(Stat_Trace_Record) + num_stats * NUM_CORES * sizeof(Counter), render_stats);
+}
+
 /**************************************************************************************/
 /* stat_trace_cycle: */
 
@@ -129,8 +159,8 @@ void stat_trace_done(void) {
   /* trace the final stat values */
   trace_stats();
 
-  fclose(file);
-  file = NULL;
+  trace_writer_close(writer);
+  writer = NULL;
 
   stat_mon_free(stat_mon);
   trigger_free(interval_trigger);
@@ -155,18 +185,38 @@ uns num_tokens(const char* str, const char* delim) {
 /* trace_stats: */
 
 static void trace_stats(void) {
-  fprintf(file, "%lld", inst_count[0]);
+  Stat_Trace_Record* record = trace_writer_alloc(writer);
+  record->inst_count = inst_count[0];
+  uns jj = 0;
   for (uns ii = 0; ii < num_stats; ++ii) {
-    for (uns proc_id = 0; proc_id < NUM_CORES; ++proc_id) {
+    for (uns proc_id = 0; proc_id < NUM_CORES; ++proc_id, ++jj) {
       Stat_Enum stat_idx = stat_indices[ii];
-      Stat* stat = &global_stat_array[proc_id][stat_idx];
-      if (stat->type == FLOAT_TYPE_STAT) {
-        fprintf(file, "\t%le", stat_mon_get_value(stat_mon, proc_id, stat_idx));
+      if (global_stat_desc[stat_idx].type == FLOAT_TYPE_STAT) {
+        record->stats[jj].value = stat_mon_get_value(stat_mon, proc_id, stat_idx);
       } else {
-        fprintf(file, "\t%lld", stat_mon_get_count(stat_mon, proc_id, stat_idx));
+        record->stats[jj].count = stat_mon_get_count(stat_mon, proc_id, stat_idx);
       }
     }
   }
-  fprintf(file, "\n");
+  trace_writer_commit(writer);
   stat_mon_reset(stat_mon);
 }
+
+/**************************************************************************************/
+/* render_stats: runs on the trace writer thread */
+
+static void render_stats(FILE* file, const void* data) {
+  const Stat_Trace_Record* record = data;
+  fprintf(file, "%lld", record->inst_count);
+  uns jj = 0;
+  for (uns ii = 0; ii < num_stats; ++ii) {
+    for (uns proc_id = 0; proc_id < NUM_CORES; ++proc_id, ++jj) {
+      if (global_stat_desc[stat_indices[ii]].type == FLOAT_TYPE_STAT) {
+        fprintf(file, "\t%le", record->stats[jj].value);
+      } else {
+        fprintf(file, "\t%lld", record->stats[jj].count);
+      }
+    }
+  }
+  fprintf(file, "\n");
+}
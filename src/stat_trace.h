@@ -37,6 +37,9 @@
 /* Initialize stat trace */
 void stat_trace_init(void);
 
+/* Continue the trace in another directory */
+void stat_trace_reopen(const char* dir);
+
 /* Call every cycle */
 void stat_trace_cycle(void);
 
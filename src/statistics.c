@@ -42,19 +42,44 @@ working on this (ob).
 #include "general.param.h"
 
 #include "optimizer2.h"
+#include "stat_bin.h"
 
 /**************************************************************************************/
 /* Global Variables */
 
-#define DEF_STAT(name, type, ratio) {type##_TYPE_STAT, #name, {0}, {0}, ratio, __FILE__, FALSE},
+#define DEF_STAT(name, type, ratio) {type##_TYPE_STAT, #name, ratio, __FILE__, FALSE},
+#define STAT_GROUP_END(group)
 
-Stat global_stat_sample[] = {
+Stat_Desc global_stat_desc[] = {
 #include "stat_files.def"
 };
 
 #undef DEF_STAT
+#undef STAT_GROUP_END
 
-Stat** global_stat_array;
+
+Stat_Counter** global_stat_count;
+Stat_Counter** global_stat_total;
+/* [proc_id][stat] exact weighted sums of the counter stats folded in by
+   reset_stats_scaled. The total holds the sum rounded once, not the sum of the
+   rounded regions, which would push rare events toward zero. */
+static double** global_stat_scaled;
+
+/* per-core counter arrays start on their own cache line so that cores
+   simulated in parallel never share a line */
+#define STAT_ARRAY_ALIGN 64
+
+/**************************************************************************************/
+/* alloc_stat_counters: */
+
+static Stat_Counter* alloc_stat_counters(void) {
+  size_t size = ROUND_UP(NUM_GLOBAL_STATS * sizeof(Stat_Counter), STAT_ARRAY_ALIGN);
+  void* counters = NULL;
+  if (posix_memalign(&counters, STAT_ARRAY_ALIGN, size))
+    FATAL_ERROR(0, "Could not allocate the stat counters\n");
+  memset(counters, 0, size);
+  return (Stat_Counter*)counters;
+}
 
 /**************************************************************************************/
 // init_global_stats_array:
@@ -66,24 +91,27 @@ void init_global_stats_array() {
   // './file.stat.def' instead of 'file.stat.def', breaking
   // composite "filetag-filename" file name construction
   for (ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
-    Stat* stat = &global_stat_sample[ii];
+    Stat_Desc* stat = &global_stat_desc[ii];
     const char* last_slash = strrchr(stat->file_name, '/');
     if (last_slash)
       stat->file_name = last_slash + 1;
   }
 
-  // Make a copy of stats array for each core
-  global_stat_array = (Stat**)malloc(NUM_CORES * sizeof(Stat*));
+  // Allocate the counters of each core
+  global_stat_count = (Stat_Counter**)malloc(NUM_CORES * sizeof(Stat_Counter*));
+  global_stat_total = (Stat_Counter**)malloc(NUM_CORES * sizeof(Stat_Counter*));
+  global_stat_scaled = (double**)malloc(NUM_CORES * sizeof(double*));
   for (ii = 0; ii < NUM_CORES; ii++) {
-    global_stat_array[ii] = (Stat*)malloc(NUM_GLOBAL_STATS * sizeof(Stat));
-    memcpy(global_stat_array[ii], global_stat_sample, NUM_GLOBAL_STATS * sizeof(Stat));
+    global_stat_count[ii] = alloc_stat_counters();
+    global_stat_total[ii] = alloc_stat_counters();
+    global_stat_scaled[ii] = (double*)calloc(NUM_GLOBAL_STATS, sizeof(double));
   }
 }
 
 /**************************************************************************************/
 // gen_stat_output_file:
 
-void gen_stat_output_file(char* buf, uns8 proc_id, Stat* stat, char csv) {
+void gen_stat_output_file(char* buf, uns8 proc_id, const Stat_Desc* stat, char csv) {
   char temp[MAX_STR_LENGTH + 1];
   char temp2[16];  // assuming proc id can not be more than 15 bytes
 
@@ -126,8 +154,12 @@ void gen_stat_output_file(char* buf, uns8 proc_id, Stat* stat, char csv) {
 void init_global_stats(uns8 proc_id) {
   uns ii;
 
+  // the descriptions are shared, only the first core needs to set them up
+  if (proc_id != 0)
+    return;
+
   for (ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
-    Stat* stat = &global_stat_array[proc_id][ii];
+    Stat_Desc* stat = &global_stat_desc[ii];
     const char* noreset_prefix = "NORESET";
     const char* param_prefix = "PARAM";
     if (!strncmp(stat->name, noreset_prefix, strlen(noreset_prefix)) ||
@@ -145,10 +177,25 @@ void fprint_line(FILE* file) {
   fprintf(file, "##################################################\n");
 }
 
+/**************************************************************************************/
+/* reset_interval_stats: */
+
+static void reset_interval_stats(uns8 proc_id, uns first_stat, uns num_stats) {
+  Stat_Counter* cur = global_stat_count[proc_id];
+  for (uns ii = first_stat; ii < first_stat + num_stats; ii++) {
+    if (global_stat_desc[ii].type == FLOAT_TYPE_STAT)
+      cur[ii].value = 0.0;
+    else
+      cur[ii].count = 0;
+  }
+}
+
 /**************************************************************************************/
 /* dump_stats: */
 
-void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
+void dump_stats(uns8 proc_id, Flag final, uns first_stat, uns num_stats) {
+  Stat_Counter* cur = global_stat_count[proc_id];
+  Stat_Counter* tot = global_stat_total[proc_id];
   Flag in_dist = FALSE;
 
   uns64 dist_sum = 0, total_dist_sum = 0, dist_vtotal = 0, total_dist_vtotal = 0;
@@ -158,14 +205,19 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
   if (!DUMP_STATS)
     return;
 
-  for (ii = 0; ii < num_stats; ii++) {
-    Stat* s = &stat_array[ii];
-
+  for (ii = first_stat; ii < first_stat + num_stats; ii++) {
     /* update the total counter for this interval */
-    if (s->type == FLOAT_TYPE_STAT)
-      s->total_value += s->value;
+    if (global_stat_desc[ii].type == FLOAT_TYPE_STAT)
+      tot[ii].value += cur[ii].value;
     else
-      s->total_count += s->count;
+      tot[ii].count += cur[ii].count;
+  }
+
+  /* periodic dumps of all the stats go to the binary stream when enabled */
+  if (PERIODIC_DUMP && PERIODIC_DUMP_BINARY && first_stat == 0 && num_stats == NUM_GLOBAL_STATS) {
+    stat_bin_write_row(proc_id);
+    reset_interval_stats(proc_id, first_stat, num_stats);
+    return;
   }
 
   const char* last_file_name = NULL;
@@ -175,8 +227,12 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
   uns stat_groupname = 0;
   const static uns STATISTICS_CSV_NO_GROUP = 0;
 
-  for (ii = 0; ii < num_stats; ii++) {
-    Stat* s = &stat_array[ii];
+  for (ii = first_stat; ii < first_stat + num_stats; ii++) {
+    const Stat_Desc* s = &global_stat_desc[ii];
+
+    /* stats of compiled out groups are left out rather than printed as 0 */
+    if (!stat_on(ii))
+      continue;
 
     if (!last_file_name || s->file_name != last_file_name) {
       if (last_file_name) {
@@ -244,27 +300,28 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
     switch (s->type) {
       case COUNT_TYPE_STAT:
         if (!in_dist) {
-          fprintf(file_stream, "%13s %13s    %13s %13s\n", unsstr64(s->count), "", unsstr64(s->total_count), "");
+          fprintf(file_stream, "%13s %13s    %13s %13s\n", unsstr64(cur[ii].count), "", unsstr64(tot[ii].count), "");
 
-          fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP, unsstr64(s->count));
+          fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP, unsstr64(cur[ii].count));
           fprintf(csv_file_stream, "%s_total_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP,
-                  unsstr64(s->total_count));
+                  unsstr64(tot[ii].count));
         } else {
-          fprintf(file_stream, "%13s %12.3f%%    %13s %12.3f%%", unsstr64(s->count), (double)s->count / dist_sum * 100,
-                  unsstr64(s->total_count), (double)s->total_count / total_dist_sum * 100);
+          fprintf(file_stream, "%13s %12.3f%%    %13s %12.3f%%", unsstr64(cur[ii].count),
+                  (double)cur[ii].count / dist_sum * 100, unsstr64(tot[ii].count),
+                  (double)tot[ii].count / total_dist_sum * 100);
 
           // Dist percentages calculation offloaded to python
-          fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, stat_groupname, unsstr64(s->count));
-          fprintf(csv_file_stream, "%s_total_count, %d, %13s\n", s->name, stat_groupname, unsstr64(s->total_count));
+          fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, stat_groupname, unsstr64(cur[ii].count));
+          fprintf(csv_file_stream, "%s_total_count, %d, %13s\n", s->name, stat_groupname, unsstr64(tot[ii].count));
         }
         break;
 
       case FLOAT_TYPE_STAT:
         ASSERTM(0, !in_dist, "Distributions not supported for float stats\n");
-        fprintf(file_stream, "%13lf %13s    %13lf %13s\n", s->value, "", s->total_value, "");
+        fprintf(file_stream, "%13lf %13s    %13lf %13s\n", cur[ii].value, "", tot[ii].value, "");
 
-        fprintf(csv_file_stream, "%s_value, %d, %13lf\n", s->name, STATISTICS_CSV_NO_GROUP, s->value);
-        fprintf(csv_file_stream, "%s_total_value, %d, %13lf\n", s->name, STATISTICS_CSV_NO_GROUP, s->total_value);
+        fprintf(csv_file_stream, "%s_value, %d, %13lf\n", s->name, STATISTICS_CSV_NO_GROUP, cur[ii].value);
+        fprintf(csv_file_stream, "%s_total_value, %d, %13lf\n", s->name, STATISTICS_CSV_NO_GROUP, tot[ii].value);
         break;
 
       case DIST_TYPE_STAT:
@@ -274,51 +331,52 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
           uns jj;
 
           in_dist = TRUE;
-          dist_sum = s->count;
-          total_dist_sum = s->total_count;
+          dist_sum = cur[ii].count;
+          total_dist_sum = tot[ii].count;
           dist_vtotal = 0;
           total_dist_vtotal = 0;
 
-          for (jj = ii + 1; stat_array[jj].type != DIST_TYPE_STAT; jj++) {
-            dist_sum += stat_array[jj].count;
-            total_dist_sum += stat_array[jj].total_count;
-            dist_vtotal += (jj - ii) * stat_array[jj].count;
-            total_dist_vtotal += (jj - ii) * stat_array[jj].total_count;
+          for (jj = ii + 1; global_stat_desc[jj].type != DIST_TYPE_STAT; jj++) {
+            dist_sum += cur[jj].count;
+            total_dist_sum += tot[jj].count;
+            dist_vtotal += (jj - ii) * cur[jj].count;
+            total_dist_vtotal += (jj - ii) * tot[jj].count;
           }
-          dist_sum += stat_array[jj].count;
-          total_dist_sum += stat_array[jj].total_count;
-          dist_vtotal += (jj - ii) * stat_array[jj].count;
-          total_dist_vtotal += (jj - ii) * stat_array[jj].total_count;
+          dist_sum += cur[jj].count;
+          total_dist_sum += tot[jj].count;
+          dist_vtotal += (jj - ii) * cur[jj].count;
+          total_dist_vtotal += (jj - ii) * tot[jj].count;
 
-          dist_variance = pow((0.0 - ((double)dist_vtotal / dist_sum)), 2) * stat_array[jj].count;
+          dist_variance = pow((0.0 - ((double)dist_vtotal / dist_sum)), 2) * cur[jj].count;
           total_dist_variance =
-              pow((0.0 - ((double)total_dist_vtotal / total_dist_sum)), 2) * stat_array[jj].total_count;
-          for (jj = ii + 1; stat_array[jj].type != DIST_TYPE_STAT; jj++) {
-            dist_variance += pow((jj - ii - ((double)dist_vtotal / dist_sum)), 2) * stat_array[jj].count;
+              pow((0.0 - ((double)total_dist_vtotal / total_dist_sum)), 2) * tot[jj].count;
+          for (jj = ii + 1; global_stat_desc[jj].type != DIST_TYPE_STAT; jj++) {
+            dist_variance += pow((jj - ii - ((double)dist_vtotal / dist_sum)), 2) * cur[jj].count;
             total_dist_variance +=
-                pow((jj - ii - ((double)total_dist_vtotal / total_dist_sum)), 2) * stat_array[jj].total_count;
+                pow((jj - ii - ((double)total_dist_vtotal / total_dist_sum)), 2) * tot[jj].count;
           }
-          dist_variance += pow((jj - ii - ((double)dist_vtotal / dist_sum)), 2) * stat_array[jj].count;
+          dist_variance += pow((jj - ii - ((double)dist_vtotal / dist_sum)), 2) * cur[jj].count;
           total_dist_variance +=
-              pow((jj - ii - ((double)total_dist_vtotal / total_dist_sum)), 2) * stat_array[jj].total_count;
+              pow((jj - ii - ((double)total_dist_vtotal / total_dist_sum)), 2) * tot[jj].count;
           dist_variance /= dist_sum - 1;
           total_dist_variance /= total_dist_sum - 1;
 
-          fprintf(file_stream, "%13s %12.3f%%    %13s %12.3f%%", unsstr64(s->count), (double)s->count / dist_sum * 100,
-                  unsstr64(s->total_count), (double)s->total_count / total_dist_sum * 100);
+          fprintf(file_stream, "%13s %12.3f%%    %13s %12.3f%%", unsstr64(cur[ii].count),
+                  (double)cur[ii].count / dist_sum * 100, unsstr64(tot[ii].count),
+                  (double)tot[ii].count / total_dist_sum * 100);
 
           // DIST pct offloaded to python
-          fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, stat_groupname, unsstr64(s->count));
-          fprintf(csv_file_stream, "%s_total_count, %d, %13s\n", s->name, stat_groupname, unsstr64(s->total_count));
+          fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, stat_groupname, unsstr64(cur[ii].count));
+          fprintf(csv_file_stream, "%s_total_count, %d, %13s\n", s->name, stat_groupname, unsstr64(tot[ii].count));
         } else {
           in_dist = FALSE;
-          fprintf(file_stream, "%13s %12.3f%%    %13s %12.3f%%\n", unsstr64(s->count),
-                  (double)s->count / dist_sum * 100, unsstr64(s->total_count),
-                  (double)s->total_count / total_dist_sum * 100);
+          fprintf(file_stream, "%13s %12.3f%%    %13s %12.3f%%\n", unsstr64(cur[ii].count),
+                  (double)cur[ii].count / dist_sum * 100, unsstr64(tot[ii].count),
+                  (double)tot[ii].count / total_dist_sum * 100);
 
           // DIST pct offloaded to python
-          fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, stat_groupname, unsstr64(s->count));
-          fprintf(csv_file_stream, "%s_total_count, %d, %13s\n", s->name, stat_groupname, unsstr64(s->total_count));
+          fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, stat_groupname, unsstr64(cur[ii].count));
+          fprintf(csv_file_stream, "%s_total_count, %d, %13s\n", s->name, stat_groupname, unsstr64(tot[ii].count));
 
           // print sum information
           fprintf(file_stream, "%-40s %13s %12.3f%%    %13s %12.3f%%\n", "", unsstr64(dist_sum),
@@ -332,86 +390,87 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
         break;
 
       case PER_INST_TYPE_STAT:
-        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->count),
-                (double)s->count / (double)inst_count[proc_id], unsstr64(s->total_count),
-                (double)s->total_count / (double)inst_count[proc_id]);
+        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(cur[ii].count),
+                (double)cur[ii].count / (double)inst_count[proc_id], unsstr64(tot[ii].count),
+                (double)tot[ii].count / (double)inst_count[proc_id]);
 
-        fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP, unsstr64(s->count));
+        fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP, unsstr64(cur[ii].count));
         fprintf(csv_file_stream, "%s_pct, %d, %12.3f\n", s->name, STATISTICS_CSV_NO_GROUP,
-                (double)s->count / (double)inst_count[proc_id]);
+                (double)cur[ii].count / (double)inst_count[proc_id]);
         fprintf(csv_file_stream, "%s_total_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP,
-                unsstr64(s->total_count));
+                unsstr64(tot[ii].count));
         fprintf(csv_file_stream, "%s_total_pct, %d, %12.3f\n", s->name, STATISTICS_CSV_NO_GROUP,
-                (double)s->total_count / (double)inst_count[proc_id]);
+                (double)tot[ii].count / (double)inst_count[proc_id]);
         break;
 
       case PER_1000_INST_TYPE_STAT:
-        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->count),
-                (double)1000.0 * (double)s->count / (double)inst_count[proc_id], unsstr64(s->total_count),
-                (double)1000.0 * (double)s->total_count / (double)inst_count[proc_id]);
+        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(cur[ii].count),
+                (double)1000.0 * (double)cur[ii].count / (double)inst_count[proc_id], unsstr64(tot[ii].count),
+                (double)1000.0 * (double)tot[ii].count / (double)inst_count[proc_id]);
 
-        fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP, unsstr64(s->count));
+        fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP, unsstr64(cur[ii].count));
         fprintf(csv_file_stream, "%s_pct, %d, %12.3f\n", s->name, STATISTICS_CSV_NO_GROUP,
-                (double)1000.0 * (double)s->count / (double)inst_count[proc_id]);
+                (double)1000.0 * (double)cur[ii].count / (double)inst_count[proc_id]);
         fprintf(csv_file_stream, "%s_total_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP,
-                unsstr64(s->total_count));
+                unsstr64(tot[ii].count));
         fprintf(csv_file_stream, "%s_total_pct, %d, %12.3f\n", s->name, STATISTICS_CSV_NO_GROUP,
-                (double)1000.0 * (double)s->total_count / (double)inst_count[proc_id]);
+                (double)1000.0 * (double)tot[ii].count / (double)inst_count[proc_id]);
         break;
 
       case PER_1000_PRET_INST_TYPE_STAT:
-        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->count),
-                (double)1000.0 * (double)s->count / (double)pret_inst_count[proc_id], unsstr64(s->total_count),
-                (double)1000.0 * (double)s->total_count / (double)pret_inst_count[0]);
+        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(cur[ii].count),
+                (double)1000.0 * (double)cur[ii].count / (double)pret_inst_count[proc_id], unsstr64(tot[ii].count),
+                (double)1000.0 * (double)tot[ii].count / (double)pret_inst_count[0]);
 
-        fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP, unsstr64(s->count));
+        fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP, unsstr64(cur[ii].count));
         fprintf(csv_file_stream, "%s_pct, %d, %12.3f\n", s->name, STATISTICS_CSV_NO_GROUP,
-                (double)1000.0 * (double)s->count / (double)pret_inst_count[proc_id]);
+                (double)1000.0 * (double)cur[ii].count / (double)pret_inst_count[proc_id]);
         fprintf(csv_file_stream, "%s_total_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP,
-                unsstr64(s->total_count));
+                unsstr64(tot[ii].count));
         fprintf(csv_file_stream, "%s_total_pct, %d, %12.3f\n", s->name, STATISTICS_CSV_NO_GROUP,
-                (double)1000.0 * (double)s->total_count / (double)pret_inst_count[0]);
+                (double)1000.0 * (double)tot[ii].count / (double)pret_inst_count[0]);
         break;
 
       case PER_CYCLE_TYPE_STAT:
-        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->count), (double)s->count / (double)cycle_count,
-                unsstr64(s->total_count), (double)s->total_count / (double)cycle_count);
+        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(cur[ii].count),
+                (double)cur[ii].count / (double)cycle_count, unsstr64(tot[ii].count),
+                (double)tot[ii].count / (double)cycle_count);
 
-        fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP, unsstr64(s->count));
+        fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP, unsstr64(cur[ii].count));
         fprintf(csv_file_stream, "%s_pct, %d, %12.3f\n", s->name, STATISTICS_CSV_NO_GROUP,
-                (double)s->count / (double)cycle_count);
+                (double)cur[ii].count / (double)cycle_count);
         fprintf(csv_file_stream, "%s_total_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP,
-                unsstr64(s->total_count));
+                unsstr64(tot[ii].count));
         fprintf(csv_file_stream, "%s_total_pct, %d, %12.3f\n", s->name, STATISTICS_CSV_NO_GROUP,
-                (double)s->total_count / (double)cycle_count);
+                (double)tot[ii].count / (double)cycle_count);
         break;
 
       case RATIO_TYPE_STAT:
-        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(s->count),
-                (double)s->count / (double)(stat_array[s->ratio_stat].count), unsstr64(s->total_count),
-                (double)s->total_count / (double)stat_array[s->ratio_stat].total_count);
+        fprintf(file_stream, "%13s %13.4f    %13s %13.4f\n", unsstr64(cur[ii].count),
+                (double)cur[ii].count / (double)(cur[s->ratio_stat].count), unsstr64(tot[ii].count),
+                (double)tot[ii].count / (double)tot[s->ratio_stat].count);
 
-        fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP, unsstr64(s->count));
+        fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP, unsstr64(cur[ii].count));
         fprintf(csv_file_stream, "%s_pct, %d, %12.3f\n", s->name, STATISTICS_CSV_NO_GROUP,
-                (double)s->count / (double)(stat_array[s->ratio_stat].count));
+                (double)cur[ii].count / (double)(cur[s->ratio_stat].count));
         fprintf(csv_file_stream, "%s_total_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP,
-                unsstr64(s->total_count));
+                unsstr64(tot[ii].count));
         fprintf(csv_file_stream, "%s_total_pct, %d, %12.3f\n", s->name, STATISTICS_CSV_NO_GROUP,
-                (double)s->total_count / (double)stat_array[s->ratio_stat].total_count);
+                (double)tot[ii].count / (double)tot[s->ratio_stat].count);
         break;
 
       case PERCENT_TYPE_STAT:
-        fprintf(file_stream, "%13s %12.3f%%    %13s %12.3f%%\n", unsstr64(s->count),
-                (double)s->count * 100 / (double)(stat_array[s->ratio_stat].count), unsstr64(s->total_count),
-                (double)s->total_count * 100 / (double)stat_array[s->ratio_stat].total_count);
+        fprintf(file_stream, "%13s %12.3f%%    %13s %12.3f%%\n", unsstr64(cur[ii].count),
+                (double)cur[ii].count * 100 / (double)(cur[s->ratio_stat].count), unsstr64(tot[ii].count),
+                (double)tot[ii].count * 100 / (double)tot[s->ratio_stat].count);
 
-        fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP, unsstr64(s->count));
+        fprintf(csv_file_stream, "%s_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP, unsstr64(cur[ii].count));
         fprintf(csv_file_stream, "%s_pct, %d, %12.3f\n", s->name, STATISTICS_CSV_NO_GROUP,
-                (double)s->count * 100 / (double)(stat_array[s->ratio_stat].count));
+                (double)cur[ii].count * 100 / (double)(cur[s->ratio_stat].count));
         fprintf(csv_file_stream, "%s_total_count, %d, %13s\n", s->name, STATISTICS_CSV_NO_GROUP,
-                unsstr64(s->total_count));
+                unsstr64(tot[ii].count));
         fprintf(csv_file_stream, "%s_total_pct, %d, %12.3f\n", s->name, STATISTICS_CSV_NO_GROUP,
-                (double)s->total_count * 100 / (double)stat_array[s->ratio_stat].total_count);
+                (double)tot[ii].count * 100 / (double)tot[s->ratio_stat].count);
         break;
 
       case LINE_TYPE_STAT:
@@ -441,21 +500,14 @@ void dump_stats(uns8 proc_id, Flag final, Stat stat_array[], uns num_stats) {
     csv_file_stream = NULL;
   }
 
-  /* reset the interval counters */
-  for (ii = 0; ii < num_stats; ii++) {
-    Stat* s = &stat_array[ii];
-    if (s->type == FLOAT_TYPE_STAT)
-      s->value = 0.0;
-    else
-      s->count = 0;
-  }
+  reset_interval_stats(proc_id, first_stat, num_stats);
 }
 
 /**************************************************************************************/
 /* dump_stats: */
 
 void reset_stats(Flag keep_total) {
-  uns proc_id, ii;
+  uns proc_id;
   if (!opt2_in_use() || opt2_is_leader()) {
     fprintf(mystdout, "** Stats Cleared:   insts: { ");
     for (proc_id = 0; proc_id < NUM_CORES; proc_id++)
@@ -463,18 +515,57 @@ void reset_stats(Flag keep_total) {
     fprintf(mystdout, "}  cycles: %-10s  time %-18s\n", unsstr64(cycle_count), unsstr64(sim_time));
     fflush(mystdout);
   }
+  reset_stats_quiet(keep_total);
+}
 
+/**************************************************************************************/
+/* reset_stats_quiet: reset_stats without the message, for frequent resets */
+
+void reset_stats_quiet(Flag keep_total) {
+  uns proc_id, ii;
   for (ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
     for (proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-      Stat* stat = &global_stat_array[proc_id][ii];
+      const Stat_Desc* stat = &global_stat_desc[ii];
+      Stat_Counter* cur = &global_stat_count[proc_id][ii];
+      Stat_Counter* tot = &global_stat_total[proc_id][ii];
       if (stat->type == FLOAT_TYPE_STAT) {
         if (keep_total || stat->noreset)
-          stat->total_value += stat->value;
-        stat->value = 0.0;
+          tot->value += cur->value;
+        cur->value = 0.0;
       } else {
         if (keep_total || stat->noreset)
-          stat->total_count += stat->count;
-        stat->count = 0ULL;
+          tot->count += cur->count;
+        cur->count = 0ULL;
+      }
+    }
+  }
+}
+
+/**************************************************************************************/
+/* reset_stats_scaled: fold the interval stats into the totals scaled by weight (the
+   parameter stats are kept as they are). A counter total only moves by what the
+   rounding of its exact weighted sum moves. */
+
+void reset_stats_scaled(double weight) {
+  uns proc_id, ii;
+  for (ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
+    for (proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+      const Stat_Desc* stat = &global_stat_desc[ii];
+      Stat_Counter* cur = &global_stat_count[proc_id][ii];
+      Stat_Counter* tot = &global_stat_total[proc_id][ii];
+      if (stat->type == FLOAT_TYPE_STAT) {
+        tot->value += stat->noreset ? cur->value : weight * cur->value;
+        cur->value = 0.0;
+      } else {
+        if (stat->noreset) {
+          tot->count += cur->count;
+        } else {
+          double* scaled = &global_stat_scaled[proc_id][ii];
+          Counter rounded = (Counter)llround(*scaled);
+          *scaled += weight * cur->count;
+          tot->count += (Counter)llround(*scaled) - rounded;
+        }
+        cur->count = 0ULL;
       }
     }
   }
@@ -486,22 +577,29 @@ void reset_stats(Flag keep_total) {
 Stat_Enum get_stat_idx(const char* name) {
   uns ii;
   for (ii = 0; ii < NUM_GLOBAL_STATS; ii++) {
-    Stat* stat = &global_stat_array[0][ii];
-    if (!strcmp(stat->name, name))
+    if (!strcmp(global_stat_desc[ii].name, name))
       break;
   }
+  if (ii < NUM_GLOBAL_STATS && !stat_on(ii))
+    return NUM_GLOBAL_STATS;  // the group of the stat is compiled out
   return ii;  // equals NUM_GLOBAL_STATS if stat not found
 }
 
 /**************************************************************************************/
-/* get_stat: */
+/* stat_require: for subsystems that read a stat back, fail at init rather than
+   compute with zeros if the group of the stat is compiled out */
+
+void stat_require(uns stat, const char* user) {
+  ASSERTUM(0, stat_on(stat), "%s needs stat %s, but its stat group is compiled out of this build (STAT_GROUPS).\n",
+           user, global_stat_desc[stat].name);
+}
+
+/**************************************************************************************/
+/* stat_read_off: a stat of a compiled out group was read */
 
-const Stat* get_stat(uns8 proc_id, const char* name) {
-  ASSERT(0, proc_id < NUM_CORES);
-  Stat_Enum idx = get_stat_idx(name);
-  if (idx == NUM_GLOBAL_STATS)
-    return NULL;
-  return &global_stat_array[proc_id][idx];
+void stat_read_off(uns stat) {
+  FATAL_ERROR(0, "Stat %s is read, but its stat group is compiled out of this build (STAT_GROUPS).\n",
+              global_stat_desc[stat].name);
 }
 
 /**************************************************************************************/
@@ -512,9 +610,10 @@ Counter get_accum_stat_event(Stat_Enum name) {
 
   if (name == NUM_GLOBAL_STATS)
     return 0;
+  stat_read(name);
 
   for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
-    accum += global_stat_array[proc_id][name].total_count;
+    accum += global_stat_total[proc_id][name].count;
   }
 
   return accum;
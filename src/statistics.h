@@ -41,7 +41,41 @@
 /**************************************************************************************/
 /* Type Declarations */
 
+/* Stat groups, one per .stat.def file in stat_files.def. A build can compile a
+   group out with -DSTAT_GROUP_<GROUP>_ON=0 (make opt-stats STAT_GROUPS=<list>):
+   its STAT_EVENTs become no-ops and its stats are left out of the dump. */
+#ifndef STAT_GROUP_FETCH_ON
+#define STAT_GROUP_FETCH_ON 1
+#endif
+#ifndef STAT_GROUP_BP_ON
+#define STAT_GROUP_BP_ON 1
+#endif
+#ifndef STAT_GROUP_MEMORY_ON
+#define STAT_GROUP_MEMORY_ON 1
+#endif
+#ifndef STAT_GROUP_CORE_ON
+#define STAT_GROUP_CORE_ON 1
+#endif
+#ifndef STAT_GROUP_INST_ON
+#define STAT_GROUP_INST_ON 1
+#endif
+#ifndef STAT_GROUP_STREAM_ON
+#define STAT_GROUP_STREAM_ON 1
+#endif
+#ifndef STAT_GROUP_L2L1PREF_ON
+#define STAT_GROUP_L2L1PREF_ON 1
+#endif
+#ifndef STAT_GROUP_POWER_ON
+#define STAT_GROUP_POWER_ON 1
+#endif
+#ifndef STAT_GROUP_PREF_ON
+#define STAT_GROUP_PREF_ON 1
+#endif
+
+/* STAT_GROUP_<GROUP>_END is one past the last stat of the group; the _LAST
+   entry rewinds the enum so the markers do not take up a stat index */
 #define DEF_STAT(name, type, ratio) name,
+#define STAT_GROUP_END(group) STAT_GROUP_##group##_END, STAT_GROUP_##group##_LAST = STAT_GROUP_##group##_END - 1,
 
 typedef enum Stat_Enum_enum {
 #include "stat_files.def"
@@ -49,6 +83,7 @@ typedef enum Stat_Enum_enum {
 } Stat_Enum;
 
 #undef DEF_STAT
+#undef STAT_GROUP_END
 
 typedef enum Stat_Type_enum {
   COUNT_TYPE_STAT,  // stat is a simple counter
@@ -73,66 +108,73 @@ typedef enum Stat_Type_enum {
   NUM_STAT_TYPES,
 } Stat_Type;
 
-typedef struct Stat_struct {
-  Stat_Type type;    // see types above
-  const char* name;  // name of stat
-  union {
-    Counter count;  // count during the current stat interval
-    double value;   // value during the current stat interval
-  };
-  union {
-    Counter total_count;  // total count from beginning of run
-    double total_value;   // total value from beginning of run
-  };
+/* Read-only description of a stat, shared by all cores */
+typedef struct Stat_Desc_struct {
+  Stat_Type type;         // see types above
+  const char* name;       // name of stat
   Stat_Enum ratio_stat;   // stat that to use in the ratio
   const char* file_name;  // name of file to print stats
   Flag noreset;           // this stat does not get reset (name has prefix "NORESET")
-} Stat;
+} Stat_Desc;
+
+/* Counters of a stat. The counters of each core are kept in dense arrays
+   indexed by Stat_Enum, separate from the descriptions, so that a STAT_EVENT
+   touches only the 8 bytes it updates. */
+typedef union Stat_Counter_union {
+  Counter count;  // count of a counter stat
+  double value;   // value of a FLOAT stat
+} Stat_Counter;
 
 /**************************************************************************************/
 /* Macros */
 
 #ifndef NO_STAT
-#define STAT_EVENT(proc_id, stat)             \
-  do {                                        \
-    global_stat_array[proc_id][stat].count++; \
+#define STAT_EVENT(proc_id, stat)               \
+  do {                                          \
+    if (stat_on(stat))                          \
+      global_stat_count[proc_id][stat].count++; \
   } while (0)
 
-#define STAT_EVENT_ALL(stat)                              \
-  do {                                                    \
-    for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) \
-      global_stat_array[proc_id][stat].count++;           \
+#define STAT_EVENT_ALL(stat)                                \
+  do {                                                      \
+    if (stat_on(stat))                                      \
+      for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) \
+        global_stat_count[proc_id][stat].count++;           \
   } while (0)
 
-#define INC_STAT_EVENT(proc_id, stat, inc)           \
-  do {                                               \
-    global_stat_array[proc_id][stat].count += (inc); \
+#define INC_STAT_EVENT(proc_id, stat, inc)             \
+  do {                                                 \
+    if (stat_on(stat))                                 \
+      global_stat_count[proc_id][stat].count += (inc); \
   } while (0)
 
-#define INC_STAT_EVENT_ALL(stat, inc)                     \
-  do {                                                    \
-    for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) \
-      global_stat_array[proc_id][stat].count += (inc);    \
+#define INC_STAT_EVENT_ALL(stat, inc)                       \
+  do {                                                      \
+    if (stat_on(stat))                                      \
+      for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) \
+        global_stat_count[proc_id][stat].count += (inc);    \
   } while (0)
 
-#define INC_STAT_VALUE(proc_id, stat, inc)           \
-  do {                                               \
-    global_stat_array[proc_id][stat].value += (inc); \
+#define INC_STAT_VALUE(proc_id, stat, inc)             \
+  do {                                                 \
+    if (stat_on(stat))                                 \
+      global_stat_count[proc_id][stat].value += (inc); \
   } while (0)
 
-#define INC_STAT_VALUE_ALL(stat, inc)                     \
-  do {                                                    \
-    for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) \
-      global_stat_array[proc_id][stat].value += (inc);    \
+#define INC_STAT_VALUE_ALL(stat, inc)                       \
+  do {                                                      \
+    if (stat_on(stat))                                      \
+      for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) \
+        global_stat_count[proc_id][stat].value += (inc);    \
   } while (0)
 
-#define GET_STAT_EVENT(proc_id, stat) (global_stat_array[proc_id][stat].count)
-#define GET_TOTAL_STAT_EVENT(proc_id, stat) \
-  (global_stat_array[proc_id][stat].count + global_stat_array[proc_id][stat].total_count)
-#define GET_TOTAL_STAT_VALUE(proc_id, stat) \
-  (global_stat_array[proc_id][stat].value + global_stat_array[proc_id][stat].total_value)
+#define GET_STAT_EVENT(proc_id, stat) (global_stat_count[proc_id][stat].count)
+#define GET_TOTAL_STAT_EVENT(proc_id, stat)                                                     \
+  (global_stat_count[proc_id][stat_read(stat)].count + global_stat_total[proc_id][stat].count)
+#define GET_TOTAL_STAT_VALUE(proc_id, stat)                                                     \
+  (global_stat_count[proc_id][stat_read(stat)].value + global_stat_total[proc_id][stat].value)
 #define GET_ACCUM_STAT_EVENT(stat) get_accum_stat_event(stat)
-#define RESET_STAT(proc_id, stat) (global_stat_array[proc_id][stat].count = 0)
+#define RESET_STAT(proc_id, stat) (global_stat_count[proc_id][stat].count = 0)
 
 #define NO_RATIO NUM_GLOBAL_STATS
 
@@ -157,9 +199,25 @@ typedef struct Stat_struct {
 /* Global Variables */
 
 #ifndef NO_STAT
-extern Stat** global_stat_array;
+extern Stat_Desc global_stat_desc[];     // description of each stat, from stat_files.def
+extern Stat_Counter** global_stat_count;  // [proc_id][stat] counters of the current stat interval
+extern Stat_Counter** global_stat_total;  // [proc_id][stat] totals from the beginning of the run
 #endif
 
+/**************************************************************************************/
+/* stat_on: returns FALSE if the group of the stat is compiled out. Folds to a
+   constant for constant stats, and to TRUE when no group is compiled out. */
+
+static inline Flag stat_on(uns stat) {
+#define DEF_STAT(name, type, ratio)
+#define STAT_GROUP_END(group) stat < STAT_GROUP_##group##_END ? STAT_GROUP_##group##_ON :
+  return
+#include "stat_files.def"
+      TRUE;
+#undef DEF_STAT
+#undef STAT_GROUP_END
+}
+
 /**************************************************************************************/
 /* Prototypes */
 #ifdef __cplusplus
@@ -167,18 +225,32 @@ extern "C" {
 #endif
 
 void init_global_stats_array(void);
-void gen_stat_output_file(char*, uns8, Stat*, char);
+void gen_stat_output_file(char*, uns8, const Stat_Desc*, char);
 void init_global_stats(uns8);
-void dump_stats(uns8, Flag, Stat[], uns);
+void dump_stats(uns8, Flag, uns, uns);
 void reset_stats(Flag);
+void reset_stats_quiet(Flag);
+void reset_stats_scaled(double);
 void fprint_line(FILE*);
 Stat_Enum get_stat_idx(const char* name);
-const Stat* get_stat(uns8, const char*);
 Counter get_accum_stat_event(Stat_Enum name);
+void stat_require(uns stat, const char* user);
+void stat_read_off(uns stat);
 
 #ifdef __cplusplus
 }
 #endif
+
+/**************************************************************************************/
+/* stat_read: the index of a stat that is read back. A stat of a compiled out group
+   would silently read as 0, so that is a fatal error. Folds away for stats that
+   are on. */
+
+static inline uns stat_read(uns stat) {
+  if (!stat_on(stat))
+    stat_read_off(stat);
+  return stat;
+}
 /**************************************************************************************/
 
 #endif /* #ifndef __STATISTICS_H__ */
@@ -0,0 +1,217 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : telemetry.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Live telemetry of a running simulation (see telemetry.h).
+ ***************************************************************************************/
+
+#include "telemetry.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_vars.h"
+
+#include "core.param.h"
+#include "general.param.h"
+
+#include "memory/memory.h"
+#include "cmp_model.h"
+#include "freq.h"
+#include "model.h"
+#include "statistics.h"
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Telemetry_Last_struct {
+  Counter inst_count;
+  Counter cycle_count;
+  Counter bp_mispredicts;
+  Counter icache_misses;
+  Counter dcache_misses;
+  Counter l1_misses;
+} Telemetry_Last;
+
+/**************************************************************************************/
+/* Global Variables */
+
+static Telemetry_Header* header = NULL;
+static Telemetry_Core* cores;
+static size_t segment_size;
+static Telemetry_Last* last;  // per-core counts at the previous snapshot
+static Counter next_cycle;
+static uns64 start_ns;
+static uns64 last_ns;
+
+/**************************************************************************************/
+/* Local Prototypes */
+
+static void publish(Flag done);
+static uns64 wall_ns(void);
+static double per_kilo(Counter events, Counter insts);
+
+/**************************************************************************************/
+/* telemetry_init: */
+
+void telemetry_init(void) {
+  if (!TELEMETRY)
+    return;
+  ASSERTM(0, TELEMETRY_PERIOD > 0, "telemetry_period must be positive\n");
+  stat_require(BP_ON_PATH_MISPREDICT, "telemetry");
+  stat_require(ICACHE_MISS, "telemetry");
+  stat_require(DCACHE_MISS, "telemetry");
+  stat_require(L1_MISS, "telemetry");
+
+  char buf[MAX_STR_LENGTH + 1];
+  snprintf(buf, MAX_STR_LENGTH + 1, "%s/%s%s", OUTPUT_DIR, FILE_TAG, TELEMETRY_FILE);
+  int fd = open(buf, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  ASSERTUM(0, fd >= 0, "Couldn't open telemetry file '%s'.\n", buf);
+  segment_size = sizeof(Telemetry_Header) + NUM_CORES * sizeof(Telemetry_Core);
+  ASSERTUM(0, ftruncate(fd, segment_size) == 0, "Couldn't size telemetry file '%s'.\n", buf);
+  void* segment = mmap(NULL, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ASSERTUM(0, segment != MAP_FAILED, "Couldn't map telemetry file '%s'.\n", buf);
+  close(fd);
+
+  header = (Telemetry_Header*)segment;
+  cores = (Telemetry_Core*)(header + 1);
+  last = (Telemetry_Last*)calloc(NUM_CORES, sizeof(Telemetry_Last));
+
+  /* the file is zero filled by ftruncate, the magic is written last so that readers never
+     see a valid header with the wrong sizes */
+  header->version = TELEMETRY_VERSION;
+  header->num_cores = NUM_CORES;
+  header->header_size = sizeof(Telemetry_Header);
+  header->core_size = sizeof(Telemetry_Core);
+  header->pid = getpid();
+  header->period = TELEMETRY_PERIOD;
+  __atomic_store_n(&header->magic, TELEMETRY_MAGIC, __ATOMIC_RELEASE);
+
+  start_ns = wall_ns();
+  last_ns = start_ns;
+  next_cycle = cycle_count + TELEMETRY_PERIOD;
+}
+
+/**************************************************************************************/
+/* telemetry_cycle: */
+
+void telemetry_cycle(void) {
+  if (!header || cycle_count < next_cycle)
+    return;
+  next_cycle = cycle_count + TELEMETRY_PERIOD;
+  publish(FALSE);
+}
+
+/**************************************************************************************/
+/* telemetry_done: */
+
+void telemetry_done(void) {
+  if (!header)
+    return;
+  publish(TRUE);
+  munmap(header, segment_size);
+  free(last);
+  header = NULL;
+}
+
+/**************************************************************************************/
+/* publish: write a snapshot under the sequence lock */
+
+static void publish(Flag done) {
+  uns64 now_ns = wall_ns();
+  double secs = (now_ns - last_ns) / 1e9;
+  uns64 seq = header->seq;
+
+  __atomic_store_n(&header->seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    Telemetry_Core* core = &cores[proc_id];
+    Telemetry_Last* prev = &last[proc_id];
+    Counter cycles = freq_cycle_count(FREQ_DOMAIN_CORES[proc_id]);
+    Counter insts = inst_count[proc_id] - prev->inst_count;
+
+    core->inst_count = inst_count[proc_id];
+    core->uop_count = uop_count[proc_id];
+    core->bp_mispredicts = GET_TOTAL_STAT_EVENT(proc_id, BP_ON_PATH_MISPREDICT);
+    core->icache_misses = GET_TOTAL_STAT_EVENT(proc_id, ICACHE_MISS);
+    core->dcache_misses = GET_TOTAL_STAT_EVENT(proc_id, DCACHE_MISS);
+    core->l1_misses = GET_TOTAL_STAT_EVENT(proc_id, L1_MISS);
+
+    core->ipc = cycles > prev->cycle_count ? (double)insts / (cycles - prev->cycle_count) : 0.0;
+    core->kips = secs > 0 ? insts / secs / 1000.0 : 0.0;
+    core->bp_mpki = per_kilo(core->bp_mispredicts - prev->bp_mispredicts, insts);
+    core->icache_mpki = per_kilo(core->icache_misses - prev->icache_misses, insts);
+    core->dcache_mpki = per_kilo(core->dcache_misses - prev->dcache_misses, insts);
+    core->l1_mpki = per_kilo(core->l1_misses - prev->l1_misses, insts);
+
+    if (SIM_MODEL == CMP_MODEL) {
+      Node_Stage* node_stage = &cmp_model.node_stage[proc_id];
+      uns32 rs_ops = 0;
+      for (uns rs = 0; rs < NUM_RS; rs++)
+        rs_ops += node_stage->rs[rs].rs_op_count;
+      core->rob_occupancy = node_stage->node_count;
+      core->rs_occupancy = rs_ops;
+    }
+    core->mem_req_buffers = mem ? mem->num_req_buffers_per_core[proc_id] : 0;
+    core->sim_done = sim_done[proc_id];
+
+    prev->inst_count = inst_count[proc_id];
+    prev->cycle_count = cycles;
+    prev->bp_mispredicts = core->bp_mispredicts;
+    prev->icache_misses = core->icache_misses;
+    prev->dcache_misses = core->dcache_misses;
+    prev->l1_misses = core->l1_misses;
+  }
+  header->cycle_count = cycle_count;
+  header->host_ns = now_ns - start_ns;
+  header->num_snapshots++;
+  header->done = done;
+
+  __atomic_store_n(&header->seq, seq + 2, __ATOMIC_RELEASE);
+  last_ns = now_ns;
+}
+
+/**************************************************************************************/
+/* wall_ns: */
+
+static uns64 wall_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uns64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**************************************************************************************/
+/* per_kilo: */
+
+static double per_kilo(Counter events, Counter insts) {
+  return insts ? 1000.0 * events / insts : 0.0;
+}
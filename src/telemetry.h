@@ -0,0 +1,103 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : telemetry.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Live telemetry of a running simulation. Every telemetry_period
+ *cycles a snapshot of per-core progress (instruction counts, IPC, KIPS, MPKIs and
+ *queue occupancies) is published in a memory-mapped file that other processes can
+ *poll without stopping or slowing the simulation (see bin/scarab_telemetry.py).
+ *
+ * The file is a Telemetry_Header followed by num_cores Telemetry_Core records.
+ * Snapshots are published with a sequence lock: seq is odd while a snapshot is
+ * being written, so a reader copies the segment and retries if seq was odd or
+ * changed during the copy. The layout below is the reader ABI; bump
+ * TELEMETRY_VERSION whenever it changes.
+ ***************************************************************************************/
+
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include "globals/global_types.h"
+
+/**************************************************************************************/
+/* Defines */
+
+#define TELEMETRY_MAGIC 0x4d54424152414353ULL  // "SCARABTM" in little-endian
+#define TELEMETRY_VERSION 1
+
+/**************************************************************************************/
+/* Types */
+
+typedef struct Telemetry_Core_struct {
+  /* cumulative counts since the start of timing simulation */
+  uns64 inst_count;
+  uns64 uop_count;
+  uns64 bp_mispredicts;  // on-path branch mispredictions
+  uns64 icache_misses;
+  uns64 dcache_misses;
+  uns64 l1_misses;  // LLC misses
+
+  /* rates over the last telemetry period */
+  double ipc;
+  double kips;  // simulated kilo-instructions per host second
+  double bp_mpki;
+  double icache_mpki;
+  double dcache_mpki;
+  double l1_mpki;
+
+  /* queue occupancies at the snapshot */
+  uns32 rob_occupancy;
+  uns32 rs_occupancy;     // ops in all reservation stations
+  uns32 mem_req_buffers;  // memory request buffers held by the core
+  uns32 sim_done;         // core reached its instruction limit
+} Telemetry_Core;
+
+typedef struct Telemetry_Header_struct {
+  uns64 magic;
+  uns32 version;
+  uns32 num_cores;
+  uns32 header_size;
+  uns32 core_size;
+  uns64 seq;          // sequence lock, odd while a snapshot is being written
+  uns64 pid;          // pid of the simulator
+  uns64 period;       // telemetry_period
+  uns64 cycle_count;  // core 0 cycle of the snapshot
+  uns64 host_ns;      // host time of the snapshot since telemetry_init
+  uns32 num_snapshots;
+  uns32 done;  // the simulation has finished, no more snapshots follow
+} Telemetry_Header;
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Create the telemetry file (called when timing simulation starts) */
+void telemetry_init(void);
+
+/* Call every cycle, publishes a snapshot every telemetry_period cycles */
+void telemetry_cycle(void);
+
+/* Publish the final snapshot and mark the simulation done */
+void telemetry_done(void);
+
+#endif /* #ifndef __TELEMETRY_H__ */
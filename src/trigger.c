@@ -43,7 +43,8 @@
 
 struct Trigger_struct {
   Flag armed;
-  const Stat* stat;
+  const Stat_Counter* stat;   // counter of the current stat interval (NULL if never)
+  const Stat_Counter* total;  // total of the stat from the previous intervals
   char* name;
   Trigger_Type type;
   Counter period;
@@ -53,6 +54,10 @@ struct Trigger_struct {
 /**************************************************************************************/
 /* Implementation */
 
+static inline Counter trigger_stat_count(Trigger* trigger) {
+  return trigger->stat->count + trigger->total->count;
+}
+
 Trigger* trigger_create(const char* name, const char* spec, Trigger_Type type) {
   ASSERT(0, name);
   ASSERT(0, spec);
@@ -92,24 +97,28 @@ Trigger* trigger_create(const char* name, const char* spec, Trigger_Type type) {
     *open_bracket = 0;
   }
 
+  Stat_Enum stat_idx;
   switch (*stat_str) {
     case 'i':
-      trigger->stat = &global_stat_array[proc_id][NODE_INST_COUNT];
+      stat_idx = NODE_INST_COUNT;
       break;
     case 'c':
-      trigger->stat = &global_stat_array[proc_id][NODE_CYCLE];
+      stat_idx = NODE_CYCLE;
       break;
     case 't':
-      trigger->stat = &global_stat_array[proc_id][EXECUTION_TIME];
+      stat_idx = EXECUTION_TIME;
       break;
     default:
-      trigger->stat = get_stat(proc_id, stat_str);
-      ASSERTM(0, trigger->stat, "Stat '%s' for trigger '%s' not found\n", stat_str, name);
-      ASSERTM(0, trigger->stat->type != FLOAT_TYPE_STAT,
+      stat_idx = get_stat_idx(stat_str);
+      ASSERTM(0, stat_idx < NUM_GLOBAL_STATS, "Stat '%s' for trigger '%s' not found\n", stat_str, name);
+      ASSERTM(0, global_stat_desc[stat_idx].type != FLOAT_TYPE_STAT,
               "Stat '%s' for trigger '%s' is a float (triggers support counter "
               "stats only)\n",
               stat_str, name);
   }
+  ASSERTM(0, stat_on(stat_idx), "Stat '%s' for trigger '%s' is compiled out of this build\n", stat_str, name);
+  trigger->stat = &global_stat_count[proc_id][stat_idx];
+  trigger->total = &global_stat_total[proc_id][stat_idx];
 
   trigger->period = atoll(number_str);
   if (trigger->period == 0 && trigger->type == TRIGGER_REPEAT) {
@@ -123,7 +132,7 @@ Trigger* trigger_create(const char* name, const char* spec, Trigger_Type type) {
 
 Flag trigger_fired(Trigger* trigger) {
   // common (false) case first
-  if (!trigger->armed || (trigger->stat->count + trigger->stat->total_count) < trigger->next_threshold) {
+  if (!trigger->armed || trigger_stat_count(trigger) < trigger->next_threshold) {
     return FALSE;
   }
 
@@ -133,7 +142,7 @@ Flag trigger_fired(Trigger* trigger) {
   } else {
     trigger->next_threshold += trigger->period;
     uns skipped = 0;
-    while (trigger->stat->count + trigger->stat->total_count >= trigger->next_threshold) {
+    while (trigger_stat_count(trigger) >= trigger->next_threshold) {
       trigger->next_threshold += trigger->period;
       skipped++;
     }
@@ -156,7 +165,7 @@ double trigger_progress(Trigger* trigger) {
     return 1.0;
 
   ASSERT(0, trigger->next_threshold >= trigger->period);
-  Counter stat_count = trigger->stat->count + trigger->stat->total_count;
+  Counter stat_count = trigger_stat_count(trigger);
   ASSERT(0, stat_count >= trigger->next_threshold - trigger->period);
   if (stat_count >= trigger->next_threshold)
     return 1.0;
@@ -0,0 +1,340 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : warm_state.c
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Warm-state checkpoints (see warm_state.h).
+ ***************************************************************************************/
+
+#include "warm_state.h"
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "globals/assert.h"
+#include "globals/global_defs.h"
+#include "globals/global_vars.h"
+#include "globals/utils.h"
+
+#include "bp/bp.param.h"
+#include "core.param.h"
+#include "general.param.h"
+#include "memory/memory.param.h"
+
+#include "bp/bp.h"
+#include "memory/memory.h"
+#include "cmp_model.h"
+#include "freq.h"
+
+/**************************************************************************************/
+/* Local prototypes */
+
+static Flag warm_state_read(Warm_State* ws, void* out, uns64 size);
+static void warm_state_visit(Warm_State* ws);
+static void warm_state_tag(Warm_State* ws, const char* tag);
+static void warm_state_shape_of(Warm_State* ws, const char* name, const char* owner, uns64 value);
+static void warm_state_bp(Warm_State* ws, Bp_Data* bp_data);
+static void warm_state_predictor(Warm_State* ws, uns proc_id, Bp* bp);
+
+/**************************************************************************************/
+/* warm_state_fail: record the first reason the checkpoint cannot be used */
+
+void warm_state_fail(Warm_State* ws, const char* fmt, ...) {
+  if (ws->error)
+    return;
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(ws->error_msg, MAX_STR_LENGTH, fmt, args);
+  va_end(args);
+  ws->error = TRUE;
+}
+
+/**************************************************************************************/
+/* warm_state_read: take the next size bytes of the checkpoint being read */
+
+static Flag warm_state_read(Warm_State* ws, void* out, uns64 size) {
+  ASSERT(0, ws->mode != WARM_STATE_SAVE);
+  if (ws->error)
+    return FALSE;
+  if (ws->pos + size > ws->size) {
+    warm_state_fail(ws, "the checkpoint is truncated");
+    return FALSE;
+  }
+  if (out)
+    memcpy(out, ws->buf + ws->pos, size);
+  ws->pos += size;
+  return TRUE;
+}
+
+/**************************************************************************************/
+/* warm_state_bytes: transfer the contents of a structure */
+
+void warm_state_bytes(Warm_State* ws, void* data, uns64 size) {
+  if (ws->error)
+    return;
+  if (ws->mode == WARM_STATE_SAVE) {
+    if (fwrite(data, 1, size, ws->file) != size)
+      warm_state_fail(ws, "write error");
+    return;
+  }
+  warm_state_read(ws, ws->mode == WARM_STATE_LOAD ? data : NULL, size);
+}
+
+/**************************************************************************************/
+/* warm_state_shape: record a size or kind the contents depend on, and check it on
+   restore */
+
+void warm_state_shape(Warm_State* ws, const char* name, uns64 value) {
+  warm_state_shape_of(ws, name, NULL, value);
+}
+
+/**************************************************************************************/
+/* warm_state_shape_of: warm_state_shape of a property of a named structure (owner) */
+
+static void warm_state_shape_of(Warm_State* ws, const char* name, const char* owner, uns64 value) {
+  if (ws->mode == WARM_STATE_SAVE) {
+    warm_state_bytes(ws, &value, sizeof(value));
+    return;
+  }
+  uns64 saved;
+  if (warm_state_read(ws, &saved, sizeof(saved)) && saved != value)
+    warm_state_fail(ws, "%s%s%s is %llu in the checkpoint but %llu in this run", name, owner ? " of " : "",
+                    owner ? owner : "", (unsigned long long)saved, (unsigned long long)value);
+}
+
+/**************************************************************************************/
+/* warm_state_tag: mark the start of a structure, so that a mismatch is reported by
+   name */
+
+static void warm_state_tag(Warm_State* ws, const char* tag) {
+  uns64 len = strlen(tag);
+  warm_state_shape(ws, "a structure name length", len);
+  if (ws->mode == WARM_STATE_SAVE) {
+    warm_state_bytes(ws, (void*)tag, len);
+    return;
+  }
+  char saved[MAX_STR_LENGTH + 1];
+  if (len <= MAX_STR_LENGTH && warm_state_read(ws, saved, len)) {
+    saved[len] = '\0';
+    if (strcmp(saved, tag))
+      warm_state_fail(ws, "expected structure %s but found %s", tag, saved);
+  }
+}
+
+/**************************************************************************************/
+/* warm_state_cache: a cache_lib cache. The lines (without their data pointers), the
+   line data and the replacement state are transferred. The replacement timestamps
+   are in freq_time() units, which is restored along with the checkpoint. */
+
+void warm_state_cache(Warm_State* ws, Cache* cache) {
+  warm_state_tag(ws, cache->name);
+  warm_state_shape_of(ws, "the number of sets", cache->name, cache->num_sets);
+  warm_state_shape_of(ws, "the associativity", cache->name, cache->assoc);
+  warm_state_shape_of(ws, "the line size", cache->name, cache->line_size);
+  warm_state_shape_of(ws, "the line data size", cache->name, cache->data_size);
+  warm_state_shape_of(ws, "the replacement policy", cache->name, cache->repl_policy);
+
+  switch (cache->repl_policy) {
+    case REPL_IDEAL:
+    case REPL_SHADOW_IDEAL:
+    case REPL_IDEAL_STORAGE:
+    case REPL_PARTITION:
+    case REPL_SHIP:
+      warm_state_fail(ws, "the replacement policy of %s keeps state outside of its lines", cache->name);
+      return;
+    default:
+      break;
+  }
+
+  for (uns set = 0; set < cache->num_sets; set++) {
+    for (uns way = 0; way < cache->assoc; way++) {
+      Cache_Entry* line = &cache->entries[set][way];
+      Cache_Entry entry = *line;
+      entry.data = NULL;
+      warm_state_bytes(ws, &entry, sizeof(Cache_Entry));
+      if (cache->data_size)
+        warm_state_bytes(ws, line->data, cache->data_size);
+      if (ws->mode == WARM_STATE_LOAD && !ws->error) {
+        entry.data = line->data;
+        *line = entry;
+      }
+    }
+  }
+
+  if (cache->repl_policy < REPL_VOID)
+    warm_state_bytes(ws, cache->repl_ctrs, sizeof(uns) * cache->num_sets);
+  if (cache->repl_policy == REPL_DRRIP)
+    warm_state_bytes(ws, cache->miss_count, sizeof(Counter) * cache->num_sets);
+  warm_state_bytes(ws, &cache->bimodal_count, sizeof(Counter));
+}
+
+/**************************************************************************************/
+/* warm_state_predictor: the tables of a direction predictor */
+
+static void warm_state_predictor(Warm_State* ws, uns proc_id, Bp* bp) {
+  warm_state_tag(ws, bp->name);
+  if (!bp->checkpoint_func) {
+    warm_state_fail(ws, "the %s predictor does not support checkpoints", bp->name);
+    return;
+  }
+  bp->checkpoint_func(proc_id, ws);
+}
+
+/**************************************************************************************/
+/* warm_state_bp: the branch predictor, BTB, indirect target predictor and call
+   return stack of a core */
+
+static void warm_state_bp(Warm_State* ws, Bp_Data* bp_data) {
+  warm_state_tag(ws, "BP");
+  warm_state_shape(ws, "bp_mech", bp_data->bp->id);
+  warm_state_shape(ws, "late_bp_mech", bp_data->late_bp ? bp_data->late_bp->id : NUM_BP);
+  warm_state_shape(ws, "btb_mech", bp_data->bp_btb->id);
+  warm_state_shape(ws, "ibtb_mech", bp_data->bp_ibtb->id);
+  warm_state_shape(ws, "crs_entries", CRS_ENTRIES);
+  warm_state_shape(ws, "ibtb_hist_length", IBTB_HIST_LENGTH);
+
+  warm_state_bytes(ws, &bp_data->global_hist, sizeof(bp_data->global_hist));
+  warm_state_bytes(ws, &bp_data->targ_hist, sizeof(bp_data->targ_hist));
+  warm_state_bytes(ws, &bp_data->targ_index, sizeof(bp_data->targ_index));
+
+  warm_state_predictor(ws, bp_data->proc_id, bp_data->bp);
+  if (bp_data->late_bp)
+    warm_state_predictor(ws, bp_data->proc_id, bp_data->late_bp);
+
+  warm_state_cache(ws, &bp_data->btb);
+
+  warm_state_bytes(ws, bp_data->crs.entries, sizeof(Crs_Entry) * CRS_ENTRIES * 2);
+  warm_state_bytes(ws, bp_data->crs.off_path, sizeof(Flag) * CRS_ENTRIES);
+  warm_state_bytes(ws, &bp_data->crs.depth, sizeof(uns));
+  warm_state_bytes(ws, &bp_data->crs.head, sizeof(uns));
+  warm_state_bytes(ws, &bp_data->crs.tail, sizeof(uns));
+  warm_state_bytes(ws, &bp_data->crs.tail_save, sizeof(uns));
+  warm_state_bytes(ws, &bp_data->crs.depth_save, sizeof(uns));
+  warm_state_bytes(ws, &bp_data->crs.tos, sizeof(uns));
+  warm_state_bytes(ws, &bp_data->crs.next, sizeof(uns));
+
+  uns ibtb_entries = 0x1 << IBTB_HIST_LENGTH;
+  if (bp_data->bp_ibtb->id == TC_TAGGED_IBTB || bp_data->bp_ibtb->id == TC_HYBRID_IBTB)
+    warm_state_cache(ws, &bp_data->tc_tagged);
+  if (bp_data->bp_ibtb->id == TC_TAGLESS_IBTB || bp_data->bp_ibtb->id == TC_HYBRID_IBTB)
+    warm_state_bytes(ws, bp_data->tc_tagless, sizeof(Addr) * ibtb_entries);
+  if (bp_data->bp_ibtb->id == TC_HYBRID_IBTB)
+    warm_state_bytes(ws, bp_data->tc_selector, sizeof(uns8) * ibtb_entries);
+}
+
+/**************************************************************************************/
+/* warm_state_visit: every structure that functional warmup (cmp_warmup) trains */
+
+static void warm_state_visit(Warm_State* ws) {
+  Counter time = freq_time();
+
+  warm_state_shape(ws, "the file magic", WARM_STATE_MAGIC);
+  warm_state_shape(ws, "the file version", WARM_STATE_VERSION);
+  warm_state_shape(ws, "num_cores", NUM_CORES);
+  warm_state_shape(ws, "warmup", WARMUP);
+  warm_state_shape(ws, "wp_collect_stats", WP_COLLECT_STATS);
+  warm_state_shape(ws, "private_l1", PRIVATE_L1);
+  warm_state_bytes(ws, &time, sizeof(time));
+
+  for (uns proc_id = 0; proc_id < NUM_CORES; proc_id++) {
+    warm_state_shape(ws, "the core", proc_id);
+    warm_state_cache(ws, &cmp_model.icache_stage[proc_id].icache);
+    if (WP_COLLECT_STATS)
+      warm_state_cache(ws, &cmp_model.icache_stage[proc_id].icache_line_info);
+    warm_state_cache(ws, &cmp_model.dcache_stage[proc_id].dcache);
+    warm_state_bp(ws, &cmp_model.bp_data[proc_id]);
+    if (PRIVATE_L1)
+      warm_state_cache(ws, &cmp_model.memory.uncores[proc_id].l1->cache);
+  }
+  if (!PRIVATE_L1)
+    warm_state_cache(ws, &cmp_model.memory.uncores[0].l1->cache);
+  warm_state_shape(ws, "the end marker", WARM_STATE_MAGIC);
+
+  if (ws->mode == WARM_STATE_CHECK && !ws->error && ws->pos != ws->size)
+    warm_state_fail(ws, "the checkpoint has trailing data");
+  if (ws->mode == WARM_STATE_LOAD) {
+    freq_set_time(time);
+    sim_time = time;
+  }
+}
+
+/**************************************************************************************/
+/* warm_state_save: called at the end of warmup */
+
+void warm_state_save(void) {
+  Warm_State ws;
+  memset(&ws, 0, sizeof(ws));
+  ws.mode = WARM_STATE_SAVE;
+  ws.file = fopen(WARM_STATE_SAVE_FILE, "wb");
+  ASSERTUM(0, ws.file, "Couldn't open warm state checkpoint '%s' for writing.\n", WARM_STATE_SAVE_FILE);
+
+  warm_state_visit(&ws);
+  if (fclose(ws.file))
+    warm_state_fail(&ws, "write error");
+
+  if (ws.error) {
+    WARNINGU(0, "Warm state checkpoint '%s' not written: %s\n", WARM_STATE_SAVE_FILE, ws.error_msg);
+    remove(WARM_STATE_SAVE_FILE);
+  }
+}
+
+/**************************************************************************************/
+/* warm_state_load: called after the model is initialized, in place of warmup. The
+   checkpoint is read whole and checked before anything is restored, so a mismatch
+   leaves the model untouched. */
+
+Flag warm_state_load(void) {
+  Warm_State ws;
+  memset(&ws, 0, sizeof(ws));
+
+  FILE* file = fopen(WARM_STATE_LOAD_FILE, "rb");
+  if (!file) {
+    WARNINGU(0, "Couldn't open warm state checkpoint '%s', warming up instead\n", WARM_STATE_LOAD_FILE);
+    return FALSE;
+  }
+  fseek(file, 0, SEEK_END);
+  ws.size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  ws.buf = (char*)malloc(ws.size);
+  Flag read_ok = fread(ws.buf, 1, ws.size, file) == ws.size;
+  fclose(file);
+
+  ws.mode = WARM_STATE_CHECK;
+  if (read_ok)
+    warm_state_visit(&ws);
+  else
+    warm_state_fail(&ws, "read error");
+
+  if (!ws.error) {
+    ws.mode = WARM_STATE_LOAD;
+    ws.pos = 0;
+    warm_state_visit(&ws);
+    ASSERT(0, !ws.error);
+  } else {
+    WARNINGU(0, "Warm state checkpoint '%s' not used (%s), warming up instead\n", WARM_STATE_LOAD_FILE,
+             ws.error_msg);
+  }
+  free(ws.buf);
+  return !ws.error;
+}
@@ -0,0 +1,88 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : warm_state.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Warm-state checkpoints. The microarchitectural state warmed up
+ *during WARMUP (caches, branch predictor, BTB, indirect target predictor and call
+ *return stack) is saved to a file at the end of warmup and restored at the start
+ *of later runs, which then only need to fast-forward the trace.
+ *
+ * A checkpoint is written and read by one visitor that walks every checkpointed
+ * structure. Shapes (table sizes, associativities, predictor kinds) are recorded
+ * next to the contents, and a checkpoint is only restored after a first pass has
+ * verified that every shape matches the current configuration.
+ ***************************************************************************************/
+
+#ifndef __WARM_STATE_H__
+#define __WARM_STATE_H__
+
+#include <stdio.h>
+
+#include "globals/global_defs.h"
+#include "globals/global_types.h"
+
+#include "libs/cache_lib.h"
+
+/**************************************************************************************/
+/* Defines */
+
+#define WARM_STATE_MAGIC 0x5357424152414353ULL  // "SCARABWS" in little-endian
+#define WARM_STATE_VERSION 2
+
+/**************************************************************************************/
+/* Types */
+
+typedef enum Warm_State_Mode_enum {
+  WARM_STATE_SAVE,  /* write the structures to the checkpoint */
+  WARM_STATE_CHECK, /* read the checkpoint and compare its shapes to the structures */
+  WARM_STATE_LOAD,  /* read the checkpoint into the structures (after a clean check) */
+} Warm_State_Mode;
+
+typedef struct Warm_State_struct {
+  Warm_State_Mode mode;
+  FILE* file; /* WARM_STATE_SAVE: the checkpoint being written */
+  char* buf;  /* WARM_STATE_CHECK/LOAD: the whole checkpoint */
+  uns64 size;
+  uns64 pos;
+  Flag error; /* once set, all further transfers are ignored */
+  char error_msg[MAX_STR_LENGTH + 1];
+} Warm_State;
+
+/**************************************************************************************/
+/* Prototypes */
+
+/* Restores the checkpoint in WARM_STATE_LOAD_FILE. Returns TRUE on success, FALSE
+   (with a warning) if the file cannot be used and the model has to be warmed up. */
+Flag warm_state_load(void);
+
+/* Writes the current state of the model to WARM_STATE_SAVE_FILE */
+void warm_state_save(void);
+
+/* Visitor primitives used by the checkpointed structures */
+void warm_state_shape(Warm_State* ws, const char* name, uns64 value);
+void warm_state_bytes(Warm_State* ws, void* data, uns64 size);
+void warm_state_fail(Warm_State* ws, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+void warm_state_cache(Warm_State* ws, Cache* cache);
+
+#endif /* #ifndef __WARM_STATE_H__ */
@@ -0,0 +1,229 @@
+/* Copyright 2020 HPS/SAFARI Research Groups
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/***************************************************************************************
+ * File         : stat_bin_reader.h
+ * Author       : HPS Research Group
+ * Date         : 10/19/2026
+ * Description  : Header-only reader for the binary stat stream written by
+ *periodic dumps with --periodic_dump_binary 1 (layout in src/stat_bin.h). The
+ *file is mmap'ed, so reading a column of a large stream only touches the rows
+ *it needs.
+ *
+ *   stat_bin::Reader reader("stats.bin");
+ *   size_t inst_stat = reader.stat_index("NODE_INST_COUNT");
+ *   for (size_t row = 0; row < reader.num_rows(); row++)
+ *     if (reader.row_header(row).proc_id == 0)
+ *       printf("%llu\n", (unsigned long long)reader.count(row, inst_stat));
+ ***************************************************************************************/
+
+#ifndef __STAT_BIN_READER_H__
+#define __STAT_BIN_READER_H__
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace stat_bin {
+
+/* Mirrors of the structs in src/stat_bin.h */
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_stats;
+  uint32_t num_cores;
+  uint32_t row_size;
+  uint64_t header_size;
+  uint64_t reserved[4];
+};
+
+struct Stat_Desc {
+  uint32_t type;
+  uint32_t ratio_stat;
+  uint32_t flags;
+  uint32_t name_offset;
+  uint32_t file_name_offset;
+  uint32_t reserved;
+};
+
+struct Row_Header {
+  uint64_t period_id;
+  uint32_t proc_id;
+  uint32_t reserved;
+  uint64_t cycle_count;
+  uint64_t inst_count;
+  uint64_t pret_inst_count;
+  uint64_t pret_inst_count_0;
+  uint64_t period_cycles;
+  uint64_t period_insts;
+};
+
+static const char MAGIC[8] = {'S', 'C', 'R', 'B', 'S', 'T', 'A', 'T'};
+static const uint32_t VERSION = 1;
+static const uint32_t STAT_COMPILED_OUT = 0x1;
+static const uint32_t FLOAT_TYPE_STAT = 1;  // Stat_Type in src/statistics.h
+
+struct Stat {
+  std::string name;
+  std::string file_name;
+  uint32_t type;
+  uint32_t ratio_stat;
+  bool compiled_out;
+};
+
+/* A read-only mapping of a whole file, unmapped when it goes out of scope (also when the
+   Reader constructor throws) */
+class Mapping {
+ public:
+  explicit Mapping(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error("Could not open " + path);
+    struct stat st;
+    if (fstat(fd, &st)) {
+      close(fd);
+      throw std::runtime_error("Could not stat " + path);
+    }
+    size = st.st_size;
+    if (size) {
+      void* ptr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+      if (ptr == MAP_FAILED) {
+        close(fd);
+        throw std::runtime_error("Could not map " + path);
+      }
+      data = static_cast<const char*>(ptr);
+    }
+    close(fd);
+  }
+
+  ~Mapping() {
+    if (data)
+      munmap(const_cast<char*>(data), size);
+  }
+
+  Mapping(const Mapping&) = delete;
+  Mapping& operator=(const Mapping&) = delete;
+
+  const char* data = nullptr;
+  size_t size = 0;
+};
+
+class Reader {
+ public:
+  explicit Reader(const std::string& path) : file(path), data(file.data), size(file.size) {
+    if (size < sizeof(Header))
+      throw std::runtime_error(path + " is not a binary stat stream");
+    std::memcpy(&header, data, sizeof(Header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) || header.version != VERSION)
+      throw std::runtime_error(path + " is not a version " + std::to_string(VERSION) + " binary stat stream");
+
+    /* the descriptions and the string table must lie within the header, the header within
+       the file, and a row must hold its header and both counter arrays */
+    uint64_t strings_begin = sizeof(Header) + uint64_t(header.num_stats) * sizeof(Stat_Desc);
+    if (header.header_size < strings_begin || header.header_size > size ||
+        header.row_size < sizeof(Row_Header) + 2 * uint64_t(header.num_stats) * sizeof(uint64_t))
+      throw std::runtime_error(path + " is truncated or corrupt");
+
+    const Stat_Desc* descs = reinterpret_cast<const Stat_Desc*>(data + sizeof(Header));
+    const char* strings = data + strings_begin;
+    size_t strings_size = header.header_size - strings_begin;
+    stats.reserve(header.num_stats);
+    for (uint32_t ii = 0; ii < header.num_stats; ii++) {
+      stats.push_back({string_at(path, strings, strings_size, descs[ii].name_offset),
+                       string_at(path, strings, strings_size, descs[ii].file_name_offset), descs[ii].type,
+                       descs[ii].ratio_stat, (descs[ii].flags & STAT_COMPILED_OUT) != 0});
+      stat_indices[stats.back().name] = ii;
+    }
+  }
+
+  Reader(const Reader&) = delete;
+  Reader& operator=(const Reader&) = delete;
+
+  size_t num_stats() const { return header.num_stats; }
+  size_t num_cores() const { return header.num_cores; }
+  size_t num_rows() const { return (size - header.header_size) / header.row_size; }
+  const Stat& stat(size_t stat_idx) const { return stats[stat_idx]; }
+
+  /* Index of a stat by name, num_stats() if there is no such stat */
+  size_t stat_index(const std::string& name) const {
+    auto it = stat_indices.find(name);
+    return it == stat_indices.end() ? num_stats() : it->second;
+  }
+
+  const Row_Header& row_header(size_t row) const { return *reinterpret_cast<const Row_Header*>(row_ptr(row)); }
+
+  /* Count of a counter stat during the interval of the row, and since the beginning of the run */
+  uint64_t count(size_t row, size_t stat_idx) const { return counters(row)[stat_idx]; }
+  uint64_t total_count(size_t row, size_t stat_idx) const { return counters(row)[num_stats() + stat_idx]; }
+
+  /* Value of a FLOAT stat during the interval of the row, and since the beginning of the run */
+  double value(size_t row, size_t stat_idx) const { return as_double(counters(row)[stat_idx]); }
+  double total_value(size_t row, size_t stat_idx) const { return as_double(counters(row)[num_stats() + stat_idx]); }
+
+  /* The interval counts of a stat of one core, one entry per dump of the core */
+  std::vector<uint64_t> column(size_t stat_idx, uint32_t proc_id) const {
+    std::vector<uint64_t> column;
+    for (size_t row = 0; row < num_rows(); row++)
+      if (row_header(row).proc_id == proc_id)
+        column.push_back(count(row, stat_idx));
+    return column;
+  }
+
+ private:
+  const char* row_ptr(size_t row) const { return data + header.header_size + row * header.row_size; }
+
+  const uint64_t* counters(size_t row) const {
+    return reinterpret_cast<const uint64_t*>(row_ptr(row) + sizeof(Row_Header));
+  }
+
+  /* The NUL terminated string at offset of the string table */
+  static std::string string_at(const std::string& path, const char* strings, size_t strings_size, uint32_t offset) {
+    const void* end = offset < strings_size ? std::memchr(strings + offset, '\0', strings_size - offset) : nullptr;
+    if (!end)
+      throw std::runtime_error(path + " has a stat name outside its string table");
+    return std::string(strings + offset, static_cast<const char*>(end));
+  }
+
+  static double as_double(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  Mapping file;
+  const char* data;
+  size_t size;
+  Header header;
+  std::vector<Stat> stats;
+  std::unordered_map<std::string, size_t> stat_indices;
+};
+
+}  // namespace stat_bin
+
+#endif  // __STAT_BIN_READER_H__